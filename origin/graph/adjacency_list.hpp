@@ -10,9 +10,12 @@
 
 #include <cassert>
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <queue>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <origin/type/concepts.hpp>
@@ -26,7 +29,12 @@
 #include <origin/graph/graph.hpp>
 #include <origin/graph/io.hpp>
 
+#include <origin/graph/adjacency_list.impl/bitmap.hpp>
+#include <origin/graph/adjacency_list.impl/edge_values.hpp>
+#include <origin/graph/adjacency_list.impl/neighbor_table.hpp>
 #include <origin/graph/adjacency_list.impl/pool.hpp>
+#include <origin/graph/adjacency_list.impl/small_vector.hpp>
+#include <origin/graph/adjacency_list.impl/sorted.hpp>
 
 namespace origin
 {
@@ -41,10 +49,10 @@ namespace origin
     template<typename C, typename H>
       struct handle_accessor;
 
-    template<typename T, typename H>
-      struct handle_accessor<pool<T>, H>
+    template<typename T, typename Q, typename N, typename H>
+      struct handle_accessor<pool<T, Q, N>, H>
       {
-        using I = Iterator_of<const pool<T>>;
+        using I = Iterator_of<const pool<T, Q, N>>;
 
         H get(I i) const { return i.index(); }
       };
@@ -122,60 +130,206 @@ namespace origin
     // In an undirected adjacency list, the source and target vertices refer to
     // the vertices in the order they were specified on addition. There is no
     // other meaning attributed to them.
-    template<typename E>
+    //
+    // The vertex handles are stored as indexes of type I.
+    template<typename E, typename I = std::size_t>
       struct edge
       {
         using value_type = E;
+        using vertex_type = basic_vertex_handle<I>;
 
         edge()
           : data(-1, -1, E{})
         { }
 
-        edge(vertex_handle s, vertex_handle t)
+        edge(vertex_type s, vertex_type t)
           : data(s, t, E{})
         { }
 
         template<typename... Args>
-          edge(vertex_handle s, vertex_handle t, Args&&... args)
+          edge(vertex_type s, vertex_type t, Args&&... args)
             : data(s, t, std::forward<Args>(args)...)
           { }
 
-        std::size_t& source()       { return std::get<0>(data); }
-        std::size_t  source() const { return std::get<0>(data); }
+        vertex_type& source()       { return std::get<0>(data); }
+        vertex_type  source() const { return std::get<0>(data); }
 
-        std::size_t& target()       { return std::get<1>(data); }
-        std::size_t  target() const { return std::get<1>(data); }
+        vertex_type& target()       { return std::get<1>(data); }
+        vertex_type  target() const { return std::get<1>(data); }
 
         E&       value()       { return std::get<2>(data); }
         const E& value() const { return std::get<2>(data); }
 
-        std::tuple<vertex_handle, vertex_handle,  E> data;
+        std::tuple<vertex_type, vertex_type,  E> data;
       };
 
-    // An (incident) edge list is a vector of indexes.
-    using edge_list = std::vector<edge_handle>;
+    // An (incident) edge list is a vector of indexes. This is the default
+    // incidence list; see the adjacency list traits.
+    template<typename I>
+      using basic_edge_list = std::vector<basic_edge_handle<I>>;
+
+    using edge_list = basic_edge_list<std::size_t>;
   
     // An alias for the edge pool.
-    template<typename E>
-      using edge_pool = pool<edge<E>>;
+    template<typename E, typename Q, typename I = std::size_t>
+      using edge_pool = pool<edge<E, I>, Q, I>;
 
     // An alias for the vertex iterator.
-    template<typename E>
-      using edge_iterator = handle_iterator<edge_pool<E>, edge_handle>;
+    template<typename E, typename Q, typename I = std::size_t>
+      using edge_iterator =
+        handle_iterator<edge_pool<E, Q, I>, basic_edge_handle<I>>;
 
     // An alias for the edge range.
-    template<typename E>
-      using edge_range = bounded_range<edge_iterator<E>>;
+    template<typename E, typename Q, typename I = std::size_t>
+      using edge_range = bounded_range<edge_iterator<E, Q, I>>;
 
-    // An alias for the incident edge iterator.
-    using incidence_iterator = handle_iterator<edge_list, edge_handle>;
+    // A position list records, for each edge, its position in the incidence
+    // list of its source (first) and target (second).
+    template<typename I>
+      using position_list = std::vector<std::array<I, 2>>;
+
+    // An alias for the incident edge iterator over the incidence list L. The
+    // elements of incidence lists are edge handles, so the iterator is that
+    // of the list, and it is random access.
+    template<typename L>
+      using incidence_iterator = typename L::const_iterator;
 
     // An alias for the icident edge range.
-    using incidence_range = bounded_range<incidence_iterator>;
+    template<typename L>
+      using incidence_range = bounded_range<incidence_iterator<L>>;
+
+    // Split the live elements of the pool p into k ranges of about the same
+    // size. The ranges are returned in order, and some may be empty.
+    template<typename R, typename P>
+      std::vector<R>
+      split_pool(const P& p, std::size_t k)
+      {
+        using Iter = typename R::iterator;
+        std::vector<std::size_t> b = p.split(k);
+        std::vector<R> blocks;
+        blocks.reserve(k);
+        for (std::size_t i = 0; i < k; ++i)
+          blocks.push_back({Iter(p.seek(b[i])), Iter(p.seek(b[i + 1]))});
+        return blocks;
+      }
 
   } // namespace adjacency_list_impl
 
 
+  // ------------------------------------------------------------------------ //
+  //                                                     [graph.adj_list.traits]
+  //                        Adjacency List Traits
+  //
+  // The adjacency list traits class configures the storage used by the
+  // directed and undirected adjacency lists. Alternative configurations are
+  // defined by deriving from this class and redefining some of its members.
+  //
+  //    index_type -- The unsigned integer type in which vertex and edge
+  //        handles are stored.
+  //    free_list -- The free index list of the vertex and edge pools.
+  //    incidence_list -- The list of edge handles incident to each vertex.
+  //        Its elements must be edge handles with the same index type.
+  //    track_positions -- If true, each edge records its positions in the
+  //        incidence lists of its endpoints.
+  //    hash_threshold -- If nonzero, a vertex whose degree reaches this value
+  //        indexes its neighbors in a hash table.
+  //    sorted_incidence -- If true, edges are inserted into the incidence
+  //        lists in order of their opposite endpoints. This cannot be
+  //        combined with position tracking.
+  //    split_edge_values -- If true, edge values are stored in an array
+  //        apart from the edge records. Edge values must be default
+  //        constructible and move assignable.
+  struct adjacency_list_traits
+  {
+    using index_type = std::size_t;
+    using free_list = adjacency_list_impl::min_queue;
+    using incidence_list = adjacency_list_impl::edge_list;
+    static constexpr bool track_positions = false;
+    static constexpr std::size_t hash_threshold = 0;
+    static constexpr bool sorted_incidence = false;
+    static constexpr bool split_edge_values = false;
+  };
+
+  // A handle map records the handles of vertices and edges after an
+  // adjacency list has been compacted. Each vector is indexed by the old
+  // handles. The handles of removed vertices and edges are mapped to
+  // invalid handles.
+  template<typename I = std::size_t>
+    struct basic_handle_map
+    {
+      std::vector<basic_vertex_handle<I>> vertices;
+      std::vector<basic_edge_handle<I>>   edges;
+    };
+
+  using handle_map = basic_handle_map<>;
+
+  // Traits for adjacency lists that undergo heavy churn. The vertex and edge
+  // pools find free indexes using a hierarchical bitmap instead of a heap.
+  struct bitmap_adjacency_list_traits : adjacency_list_traits
+  {
+    using free_list = adjacency_list_impl::bitmap_queue;
+  };
+
+  // Traits for adjacency lists with frequent edge removals at high degree
+  // vertices. Because each edge knows its position in the incidence lists of
+  // its endpoints, removing an edge takes constant time: the last edge of
+  // each list is moved into the vacated position. Removal does not preserve
+  // the order of incidence lists.
+  struct indexed_adjacency_list_traits : adjacency_list_traits
+  {
+    static constexpr bool track_positions = true;
+  };
+
+  // Traits for adjacency lists with high degree vertices that are frequently
+  // queried using the edge relation g(u, v), as when deduplicating edges of
+  // power-law graphs. Once the degree of a vertex reaches the threshold, its
+  // neighbors are indexed in a hash table, so that g(u, v) takes expected
+  // constant time. Positions are also tracked, so that remove_edge(u, v)
+  // takes expected constant time.
+  struct hashed_adjacency_list_traits : indexed_adjacency_list_traits
+  {
+    static constexpr std::size_t hash_threshold = 32;
+  };
+
+  // Traits for adjacency lists whose incidence lists are always sorted by
+  // opposite endpoint. The edge relation g(u, v) is a binary search, and
+  // neighbor sets can be intersected by merging. Adding an edge takes time
+  // linear in the degree of its endpoints.
+  struct sorted_adjacency_list_traits : adjacency_list_traits
+  {
+    static constexpr bool sorted_incidence = true;
+  };
+
+  // Traits for adjacency lists whose vertices mostly have small degree. The
+  // first N incident edges of each vertex are stored inside the vertex, so
+  // low degree vertices require no allocations.
+  template<std::size_t N>
+    struct small_adjacency_list_traits : adjacency_list_traits
+    {
+      using incidence_list = adjacency_list_impl::small_vector<edge_handle, N>;
+    };
+
+  // Traits for adjacency lists with large edge values that are mostly
+  // traversed without reading those values. The edge records contain only
+  // the endpoints of each edge, and the values are stored in a separate
+  // array indexed by edge handle, so that traversals do not load the values
+  // into cache. The edge relation g(e) returns a reference into that array.
+  struct split_adjacency_list_traits : adjacency_list_traits
+  {
+    static constexpr bool split_edge_values = true;
+  };
+
+  // Traits for adjacency lists with fewer than 2^32 - 1 vertices and edges.
+  // Handles are stored as 32-bit indexes, which halves the size of the
+  // incidence lists and nearly halves that of the edge records, so that a
+  // larger part of the graph fits in cache.
+  struct narrow_adjacency_list_traits : adjacency_list_traits
+  {
+    using index_type = std::uint32_t;
+    using incidence_list = adjacency_list_impl::basic_edge_list<std::uint32_t>;
+  };
+
+
 
   // ------------------------------------------------------------------------ //
   //                                                        [graph.adj_list.dir]
@@ -198,15 +352,16 @@ namespace origin
     
     // A vertex in adjacency list is implemented as a pair of edge lisst. An
     // edge list is simply a vector of indexes that refer to edges in a
-    // separate edge container.
+    // separate edge container. The type of the edge lists is L.
     //
     // Note that the class will compress the value type if it is empty.
-    template<typename V>
+    template<typename V, typename L = edge_list>
       struct vertex
       {
         using value_type = V;
-        using iterator = typename edge_list::iterator;
-        using const_iterator = typename edge_list::const_iterator;
+        using handle_type = typename L::value_type;
+        using iterator = typename L::iterator;
+        using const_iterator = typename L::const_iterator;
     
         vertex()
           : data()
@@ -214,16 +369,16 @@ namespace origin
 
         template<typename... Args>
           vertex(Args&&... args) 
-            : data(edge_list{}, edge_list{}, std::forward<Args>(args)...)
+            : data(L{}, L{}, std::forward<Args>(args)...)
           { }
 
         // Returns the out ege list
-        edge_list&       out()       { return std::get<0>(data); }
-        const edge_list& out() const { return std::get<0>(data); }
+        L&       out()       { return std::get<0>(data); }
+        const L& out() const { return std::get<0>(data); }
         
         // Returns the in edge list
-        edge_list&       in()       { return std::get<1>(data); }
-        const edge_list& in() const { return std::get<1>(data); }
+        L&       in()       { return std::get<1>(data); }
+        const L& in() const { return std::get<1>(data); }
 
         // Returns the user-supplied data object.
         V&       value()       { return std::get<2>(data); }
@@ -232,8 +387,8 @@ namespace origin
         // Out edges
         std::size_t out_degree() const { return out().size(); }
 
-        void insert_out(edge_handle e) { insert_edge(out(), e); }
-        void erase_out(edge_handle e)  { erase_edge(out(), e); }
+        void insert_out(handle_type e) { insert_edge(out(), e); }
+        void erase_out(handle_type e)  { erase_edge(out(), e); }
 
         iterator begin_out() { return out().begin(); }
         iterator end_out()   { return out().end(); }
@@ -243,8 +398,8 @@ namespace origin
         // In edges
         std::size_t in_degree() const { return in().size(); }
         
-        void insert_in(edge_handle e) { insert_edge(in(), e); }
-        void erase_in(edge_handle e)  { erase_edge(in(), e); }
+        void insert_in(handle_type e) { insert_edge(in(), e); }
+        void erase_in(handle_type e)  { erase_edge(in(), e); }
 
         iterator begin_in() { return in().begin(); }
         iterator end_in()   { return in().end(); }
@@ -252,23 +407,23 @@ namespace origin
         const_iterator end_in() const   { return in().end(); }
 
         // Helper functions
-        void insert_edge(edge_list& l, edge_handle e);
-        void erase_edge(edge_list& l, edge_handle e);
+        void insert_edge(L& l, handle_type e);
+        void erase_edge(L& l, handle_type e);
 
       public:
-        std::tuple<edge_list, edge_list, V> data;
+        std::tuple<L, L, V> data;
       };
 
-    template<typename V>
+    template<typename V, typename L>
       inline void
-      vertex<V>::insert_edge(edge_list& l, edge_handle e)
+      vertex<V, L>::insert_edge(L& l, handle_type e)
       {
         l.push_back(e);
       }
 
-    template<typename V>
+    template<typename V, typename L>
       inline void
-      vertex<V>::erase_edge(edge_list& l, edge_handle e)
+      vertex<V, L>::erase_edge(L& l, handle_type e)
       {
         auto i = std::find(l.begin(), l.end(), e);
         if (i != l.end())
@@ -276,43 +431,74 @@ namespace origin
       }
 
     // A vertex set is a pool of vertices.
-    template<typename V>
-      using vertex_pool = pool<vertex<V>>;
+    template<typename V, typename L, typename Q, typename I = std::size_t>
+      using vertex_pool = pool<vertex<V, L>, Q, I>;
 
     // An alias for the vertex iterator.
-    template<typename V>
-      using vertex_iterator = handle_iterator<vertex_pool<V>, vertex_handle>;
+    template<typename V, typename L, typename Q, typename I = std::size_t>
+      using vertex_iterator =
+        handle_iterator<vertex_pool<V, L, Q, I>, basic_vertex_handle<I>>;
 
     // An alias for the vertex range.
-    template<typename V>
-      using vertex_range = bounded_range<vertex_iterator<V>>;
+    template<typename V, typename L, typename Q, typename I = std::size_t>
+      using vertex_range = bounded_range<vertex_iterator<V, L, Q, I>>;
 
   } // namespace directed_adjacency_list_impl
 
 
+  // Batched mutation, defined below.
+  template<typename G>
+    class mutation_batch;
+
+
   // Implementation of a diretected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  template<typename V = empty_t,
+           typename E = empty_t,
+           typename T = adjacency_list_traits>
     class directed_adjacency_list
     {
-      using this_type = directed_adjacency_list<V, E>;
-
-      using vertex_node = directed_adjacency_list_impl::vertex<V>;
-      using vertex_set = directed_adjacency_list_impl::vertex_pool<V>;
-      using vertex_iter = directed_adjacency_list_impl::vertex_iterator<V>;
-
-      using edge_node = adjacency_list_impl::edge<E>;
-      using edge_set = adjacency_list_impl::edge_pool<E>;
-      using edge_iter = adjacency_list_impl::edge_iterator<E>;
-
-      using incidence_iter = adjacency_list_impl::incidence_iterator;
+      static_assert(!(T::sorted_incidence && T::track_positions),
+                    "sorted incidence lists cannot track positions");
+
+      using this_type = directed_adjacency_list<V, E, T>;
+      using index_type = typename T::index_type;
+      using free_list = typename T::free_list;
+      using incidence_list = typename T::incidence_list;
+
+      static_assert(std::is_same<typename incidence_list::value_type,
+                                 basic_edge_handle<index_type>>::value,
+                    "incidence lists must store edge handles of the index type");
+
+      using vertex_node = directed_adjacency_list_impl::vertex<V, incidence_list>;
+      using vertex_set = directed_adjacency_list_impl::
+        vertex_pool<V, incidence_list, free_list, index_type>;
+      using vertex_iter = directed_adjacency_list_impl::
+        vertex_iterator<V, incidence_list, free_list, index_type>;
+
+      using value_store = If<T::split_edge_values,
+                             adjacency_list_impl::split_values<E>,
+                             adjacency_list_impl::inline_values<E>>;
+      using record_value = typename value_store::record_value;
+
+      using edge_node = adjacency_list_impl::edge<record_value, index_type>;
+      using edge_set =
+        adjacency_list_impl::edge_pool<record_value, free_list, index_type>;
+      using edge_iter =
+        adjacency_list_impl::edge_iterator<record_value, free_list, index_type>;
+
+      using incidence_iter =
+        adjacency_list_impl::incidence_iterator<incidence_list>;
     public:
-      using vertex = vertex_handle;
-      using vertex_range = directed_adjacency_list_impl::vertex_range<V>;
+      using vertex = basic_vertex_handle<index_type>;
+      using vertex_range = directed_adjacency_list_impl::
+        vertex_range<V, incidence_list, free_list, index_type>;
 
-      using edge = edge_handle;
-      using edge_range = adjacency_list_impl::edge_range<E>;
+      using edge = basic_edge_handle<index_type>;
+      using edge_range =
+        adjacency_list_impl::edge_range<record_value, free_list, index_type>;
 
-      using incidence_range = adjacency_list_impl::incidence_range;
+      using incidence_range =
+        adjacency_list_impl::incidence_range<incidence_list>;
 
 
       // Observers
@@ -322,6 +508,10 @@ namespace origin
       bool        empty() const { return edges_.empty(); }
       std::size_t size() const  { return edges_.size(); }
 
+      // Handle bounds
+      std::size_t vertex_bound() const { return verts_.bound(); }
+      std::size_t edge_bound() const   { return edges_.bound(); }
+
       // Vertex observers
       std::size_t out_degree(vertex v) const { return node(v).out_degree(); }
       std::size_t in_degree(vertex v) const  { return node(v).in_degree(); }
@@ -335,8 +525,8 @@ namespace origin
       V&       operator()(vertex v)       { return node(v).value(); }
       const V& operator()(vertex v) const { return node(v).value(); }
 
-      E&       operator()(edge e)       { return get_edge(e).value(); }
-      const E& operator()(edge e) const { return get_edge(e).value(); }
+      E&       operator()(edge e)       { return values_.get(edges_, e); }
+      const E& operator()(edge e) const { return values_.get(edges_, e); }
 
       // Edge relation
       edge operator()(vertex u, vertex v) const;
@@ -366,13 +556,33 @@ namespace origin
       void remove_edges(vertex v);
       void remove_edges();
 
+      // Compaction
+      basic_handle_map<index_type> compact();
+
+      // Incidence order
+      // The graph is sorted when the out edges of each vertex are ordered by
+      // target and its in edges by source. The edge relation of a sorted
+      // graph is a binary search. A graph without edges is sorted, and
+      // remains sorted as long as edges are added in order.
+      bool sorted() const { return sorted_; }
+      void sort_adjacency();
+
       // Iterators
       vertex_range    vertices() const;
       edge_range      edges() const;
       incidence_range out_edges(vertex v) const;
       incidence_range in_edges(vertex v) const;
 
+      // Block iterators
+      // These operations split the vertex or edge set into k contiguous
+      // ranges of about the same size, so that each can be processed by a
+      // different thread.
+      std::vector<vertex_range> vertex_blocks(std::size_t k) const;
+      std::vector<edge_range>   edge_blocks(std::size_t k) const;
+
     private:
+      friend class mutation_batch<this_type>;
+
       vertex_node&       node(vertex v)       { return verts_[v]; }
       const vertex_node& node(vertex v) const { return verts_[v]; }
 
@@ -401,44 +611,75 @@ namespace origin
       template<typename S1, typename S2, typename P>
         void unlink_multi_edge(S1& seq1, S2& seq2, P pred);
 
+      // Helper functions for position tracking.
+      static constexpr bool tracking() { return T::track_positions; }
+
+      void track_edge(edge e);
+      void untrack_edge(incidence_list& seq, edge e, int k);
+
+      // Helper functions for neighbor indexing.
+      static constexpr bool hashing() { return T::hash_threshold != 0; }
+
+      void index_edge(edge e);
+      void unindex_edge(edge e);
+      void build_index(vertex v);
+      void reindex();
+      void destroy_edge(edge e);
+
     private:
       vertex_set verts_;
       edge_set   edges_;
+      value_store values_; // Edge values, if split
+      adjacency_list_impl::position_list<index_type> pos_; // Edge positions, if tracked
+      adjacency_list_impl::neighbor_index index_; // Out edges by target
+      bool sorted_ = true; // True if the incidence lists are sorted
     };
 
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::operator()(vertex u, vertex v) const -> edge
+    directed_adjacency_list<V, E, T>::operator()(vertex u, vertex v) const -> edge
     {
+      if (hashing() && index_.indexed(u))
+        return index_.find(u, v);
       if (out_degree(u) <= in_degree(v))
         return find_out_edge(u, v);
       else
         return find_in_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::find_out_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_list<V, E, T>::find_out_edge(vertex u, vertex v) const -> edge
     {
       using P = has_target<this_type>;
       const vertex_node& n = node(u);
+      if (sorted()) {
+        auto key = [this](edge e) -> std::size_t { return target(e); };
+        auto i = adjacency_list_impl::find_sorted(n.out(), v, key);
+        return i == n.out().end() ? edge() : *i;
+      }
       return find_edge(n.out(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::find_in_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_list<V, E, T>::find_in_edge(vertex u, vertex v) const -> edge
     {
       using P = has_source<this_type>;
       const vertex_node& n = node(v);
+      if (sorted()) {
+        auto key = [this](edge e) -> std::size_t { return source(e); };
+        auto i = adjacency_list_impl::find_sorted(n.in(), u, key);
+        return i == n.in().end() ? edge() : *i;
+      }
       return find_edge(n.in(), P(*this, u));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename S, typename P>
       inline auto
-      directed_adjacency_list<V, E>::find_edge(const S& seq, P pred) const -> edge
+      directed_adjacency_list<V, E, T>::find_edge(const S& seq, P pred) const -> edge
       {
         auto i = find_if(seq, pred);
         return i == seq.end() ? edge() : *i;
@@ -446,171 +687,304 @@ namespace origin
 
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::add_vertex() -> vertex
+    directed_adjacency_list<V, E, T>::add_vertex() -> vertex
     {
       return verts_.emplace();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::add_vertex(V&& x) -> vertex
+    directed_adjacency_list<V, E, T>::add_vertex(V&& x) -> vertex
     {
       return verts_.emplace(std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::add_vertex(const V& x) -> vertex
+    directed_adjacency_list<V, E, T>::add_vertex(const V& x) -> vertex
     {
       return verts_.emplace(x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename... Args>
       inline auto
-      directed_adjacency_list<V, E>::emplace_vertex(Args&&... args) -> vertex
+      directed_adjacency_list<V, E, T>::emplace_vertex(Args&&... args) -> vertex
       {
         return verts_.emplace(std::forward<Args>(args)...);
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::remove_vertex(vertex v)
+    directed_adjacency_list<V, E, T>::remove_vertex(vertex v)
     {
       remove_edges(v);
       verts_.erase(v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::remove_vertices()
+    directed_adjacency_list<V, E, T>::remove_vertices()
     {
       edges_.clear();
+      values_.clear();
       verts_.clear();
+      pos_.clear();
+      index_.clear();
+      sorted_ = true;
     }
 
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::add_edge(vertex u, vertex v) -> edge
+    directed_adjacency_list<V, E, T>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    directed_adjacency_list<V, E, T>::add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::add_edge(vertex u, vertex v, const E& x) -> edge
+    directed_adjacency_list<V, E, T>::add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename... Args>
       inline auto
-      directed_adjacency_list<V, E>::
+      directed_adjacency_list<V, E, T>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
-        edge e = edges_.emplace(u, v, std::forward<Args>(args)...);
+        edge e = values_.insert(edges_, u, v, std::forward<Args>(args)...);
         link_edge(u, v, e);
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::link_edge(vertex u, vertex v, edge e)
+    directed_adjacency_list<V, E, T>::link_edge(vertex u, vertex v, edge e)
     {
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
-      un.insert_out(e);
-      vn.insert_in(e);
+      auto by_target = [this](edge x) -> std::size_t { return target(x); };
+      auto by_source = [this](edge x) -> std::size_t { return source(x); };
+      if (T::sorted_incidence) {
+        adjacency_list_impl::insert_sorted(un.out(), e, v, by_target);
+        adjacency_list_impl::insert_sorted(vn.in(), e, u, by_source);
+      } else {
+        if (tracking())
+          track_edge(e);
+        sorted_ = sorted_
+               && adjacency_list_impl::extends_sorted(un.out(), v, by_target)
+               && adjacency_list_impl::extends_sorted(vn.in(), u, by_source);
+        un.insert_out(e);
+        vn.insert_in(e);
+      }
+      if (hashing())
+        index_edge(e);
+    }
+
+  // Record the positions of the edge e, which is about to be appended to the
+  // out edges of its source and the in edges of its target.
+  template<typename V, typename E, typename T>
+    inline void
+    directed_adjacency_list<V, E, T>::track_edge(edge e)
+    {
+      if (pos_.size() < edges_.bound())
+        pos_.resize(edges_.bound());
+      pos_[e][0] = out_degree(source(e));
+      pos_[e][1] = in_degree(target(e));
+    }
+
+  // Erase the edge e from seq, which is the out edge list (k == 0) or the in
+  // edge list (k == 1) of one of its endpoints. The last edge in the list is
+  // moved into the position of e.
+  template<typename V, typename E, typename T>
+    inline void
+    directed_adjacency_list<V, E, T>::
+      untrack_edge(incidence_list& seq, edge e, int k)
+      {
+        std::size_t i = pos_[e][k];
+        assert(seq[i] == e);
+        edge x = seq.back();
+        if (x != e)
+          sorted_ = false;
+        seq[i] = x;
+        pos_[x][k] = i;
+        seq.pop_back();
+      }
+
+  // Record the edge e, which has just been appended to the out edges of its
+  // source, in the neighbor table of the source. The table is built when the
+  // out degree of the source reaches the threshold.
+  template<typename V, typename E, typename T>
+    inline void
+    directed_adjacency_list<V, E, T>::index_edge(edge e)
+    {
+      vertex u = source(e);
+      if (index_.indexed(u))
+        index_.insert(u, target(e), e);
+      else if (out_degree(u) >= T::hash_threshold)
+        build_index(u);
+    }
+
+  // Forget the edge e, which is about to be erased, in the neighbor table of
+  // its source. If e was the edge recorded for its target, the first other
+  // live edge with the same target is recorded instead.
+  template<typename V, typename E, typename T>
+    void
+    directed_adjacency_list<V, E, T>::unindex_edge(edge e)
+    {
+      vertex u = source(e);
+      vertex v = target(e);
+      if (!index_.erase(u, v, e))
+        return;
+      for (edge x : node(u).out()) {
+        if (x != e && edges_.contains(x) && target(x) == v) {
+          index_.replace(u, v, x);
+          return;
+        }
+      }
+    }
+
+  // Build the neighbor table of v from its out edges.
+  template<typename V, typename E, typename T>
+    void
+    directed_adjacency_list<V, E, T>::build_index(vertex v)
+    {
+      index_.build(v, out_degree(v));
+      for (edge e : node(v).out())
+        index_.insert(v, target(e), e);
+    }
+
+  // Rebuild the neighbor tables of all vertices whose out degree has reached
+  // the threshold.
+  template<typename V, typename E, typename T>
+    void
+    directed_adjacency_list<V, E, T>::reindex()
+    {
+      index_.clear();
+      for (vertex v : vertices())
+        if (out_degree(v) >= T::hash_threshold)
+          build_index(v);
+    }
+
+  // Erase the edge e from the edge set. Every edge is destroyed through this
+  // function so that the neighbor tables stay in sync.
+  template<typename V, typename E, typename T>
+    inline void
+    directed_adjacency_list<V, E, T>::destroy_edge(edge e)
+    {
+      if (hashing())
+        unindex_edge(e);
+      edges_.erase(e);
+      values_.erase(e);
     }
 
   // Remove the specified edge from the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::remove_edge(edge e)
+    directed_adjacency_list<V, E, T>::remove_edge(edge e)
     {
       unlink_edge(source(e), target(e), e);
     }
 
   // Unlink the given edge from the source and target vertices, and erase
   // it from the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::unlink_edge(vertex u, vertex v, edge e)
+    directed_adjacency_list<V, E, T>::unlink_edge(vertex u, vertex v, edge e)
     {
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
-      un.erase_out(e);
-      vn.erase_in(e);
-      edges_.erase(e);
+      if (tracking()) {
+        untrack_edge(un.out(), e, 0);
+        untrack_edge(vn.in(), e, 1);
+      } else {
+        un.erase_out(e);
+        vn.erase_in(e);
+      }
+      destroy_edge(e);
     }
 
 
   // Remove the first edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::remove_edge(vertex u, vertex v)
+    directed_adjacency_list<V, E, T>::remove_edge(vertex u, vertex v)
     {
-      if (out_degree(u) <= in_degree(v))
+      if (hashing()) {
+        if (edge e = (*this)(u, v))
+          remove_edge(e);
+      } else if (out_degree(u) <= in_degree(v))
         unlink_out_edge(u, v);
       else
         unlink_in_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::unlink_out_edge(vertex u, vertex v)
+    directed_adjacency_list<V, E, T>::unlink_out_edge(vertex u, vertex v)
     {
       using P = has_target<this_type>;
       vertex_node& un = node(u);
       unlink_first_edge(un.out(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::unlink_in_edge(vertex u, vertex v)
+    directed_adjacency_list<V, E, T>::unlink_in_edge(vertex u, vertex v)
     {
       using P = has_source<this_type>;
       vertex_node& vn = node(v);
       unlink_first_edge(vn.in(), P(*this, u));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename S, typename P>
       inline void
-      directed_adjacency_list<V, E>::unlink_first_edge(S& seq, P pred)
+      directed_adjacency_list<V, E, T>::unlink_first_edge(S& seq, P pred)
       {
         auto i = find_if(seq, pred);
         if (i != seq.end())
           remove_edge(*i);
       }
 
-  // Remove all edges connecting u to v. 
-  template<typename V, typename E>
+  // Remove all edges connecting u to v. When positions are tracked, the
+  // edges are collected and removed one at a time, which keeps the positions
+  // of the remaining edges up to date.
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::remove_edges(vertex u, vertex v)
+    directed_adjacency_list<V, E, T>::remove_edges(vertex u, vertex v)
     {
-      if (out_degree(u) <= in_degree(v))
+      if (tracking()) {
+        std::vector<edge> es;
+        for (edge e : out_edges(u))
+          if (target(e) == v)
+            es.push_back(e);
+        for (edge e : es)
+          remove_edge(e);
+      } else if (out_degree(u) <= in_degree(v)) {
         unlink_out_edges(u, v);
-      else
+      } else {
         unlink_in_edges(u, v);
+      }
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::unlink_out_edges(vertex u, vertex v)
+    directed_adjacency_list<V, E, T>::unlink_out_edges(vertex u, vertex v)
     {
       using P = has_target<this_type>;
       vertex_node& un = node(u);
@@ -618,9 +992,9 @@ namespace origin
       unlink_multi_edge(un.out(), vn.in(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::unlink_in_edges(vertex u, vertex v)
+    directed_adjacency_list<V, E, T>::unlink_in_edges(vertex u, vertex v)
     {
       using P = has_source<this_type>;
       vertex_node& un = node(u);
@@ -629,24 +1003,22 @@ namespace origin
     }
 
   // Remove all edges from seq1 that are connected to seq2. 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename S1, typename S2, typename P>
       inline void
-      directed_adjacency_list<V, E>::unlink_multi_edge(S1& seq1, S2& seq2, P pred)
+      directed_adjacency_list<V, E, T>::unlink_multi_edge(S1& seq1, S2& seq2, P pred)
       {
         // Partition the 1st sequence by the given predicate into "save" and
-        // "erase" components. 
-        //
-        // NOTE: We may want this to be a stable partition... not sure. It
-        // seems like the saved edges are not reordered by the partitioning.
-        auto i = partition(seq1, negate(pred));
+        // "erase" components. The partition is stable so that the order of
+        // the saved edges, which may be sorted, is preserved.
+        auto i = stable_partition(seq1, negate(pred));
         for (auto j = i; j != seq1.end(); ++j) {
           // Remove those edges from the in 2nd sequence.
           auto k = remove(seq2, *j);
           seq2.erase(k, seq2.end());
 
           // Erase the edge from the graph's edge set.
-          edges_.erase(*j);
+          destroy_edge(*j);
         }
 
         // Finally, erase those edges from the first sequence.
@@ -655,11 +1027,13 @@ namespace origin
 
 
   // Remove all edges incident to the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::remove_edges(vertex v)
+    directed_adjacency_list<V, E, T>::remove_edges(vertex v)
     {
       vertex_node& vn = node(v);
+      if (hashing())
+        index_.drop(v);
       
       // Clear the out edges
       for (auto e : vn.out())
@@ -672,70 +1046,152 @@ namespace origin
       vn.in().clear();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::unlink_target(edge e)
+    directed_adjacency_list<V, E, T>::unlink_target(edge e)
     {
       vertex_node& t = node(target(e));
-      auto i = find(t.in(), e);
-      t.in().erase(i);
-      edges_.erase(e);
+      if (tracking()) {
+        untrack_edge(t.in(), e, 1);
+      } else {
+        auto i = find(t.in(), e);
+        t.in().erase(i);
+      }
+      destroy_edge(e);
     }
 
   // Note that loops will not result in the double erasure of an edge. The
   // edge is initially erased in unlink_source, and the erase operation
   // here will have no effect.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::unlink_source(edge e)
+    directed_adjacency_list<V, E, T>::unlink_source(edge e)
     {
       vertex_node& t = node(source(e));
-      auto i = find(t.out(), e);
-      t.out().erase(i);
-      edges_.erase(e);
+      if (tracking()) {
+        untrack_edge(t.out(), e, 0);
+      } else {
+        auto i = find(t.out(), e);
+        t.out().erase(i);
+      }
+      destroy_edge(e);
     }
 
 
   // Remove all edges from a graph, making it empty.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_list<V, E>::remove_edges()
+    directed_adjacency_list<V, E, T>::remove_edges()
     {
       for (vertex_node& n : verts_) {
         n.out().clear();
         n.in().clear();
       }
       edges_.clear();
+      values_.clear();
+      pos_.clear();
+      index_.clear();
+      sorted_ = true;
+    }
+
+  // Squeeze the removed vertices and edges out of the graph, releasing the
+  // memory they occupy. The vertices and edges are renumbered densely,
+  // preserving their order, and every incidence list and edge endpoint is
+  // rewritten. The result maps the old handles to the new handles, so that
+  // external properties can be moved to their new positions.
+  template<typename V, typename E, typename T>
+    auto
+    directed_adjacency_list<V, E, T>::compact() -> basic_handle_map<index_type>
+    {
+      std::vector<std::size_t> vm = verts_.compact();
+      std::vector<std::size_t> em = edges_.compact();
+      for (edge_node& e : edges_) {
+        e.source() = vm[e.source()];
+        e.target() = vm[e.target()];
+      }
+      for (vertex_node& n : verts_) {
+        for (edge& e : n.out())
+          e = em[e];
+        for (edge& e : n.in())
+          e = em[e];
+      }
+      values_.compact(em, size());
+      if (tracking())
+        adjacency_list_impl::compact_table(pos_, em, size());
+      if (hashing())
+        reindex();
+      return {{vm.begin(), vm.end()}, {em.begin(), em.end()}};
+    }
+
+  // Sort the out edges of each vertex by target and its in edges by source.
+  // Edges with the same endpoints keep their relative order. Adding an edge
+  // out of order makes the graph unsorted again, unless the incidence lists
+  // are sorted by the traits class.
+  template<typename V, typename E, typename T>
+    void
+    directed_adjacency_list<V, E, T>::sort_adjacency()
+    {
+      auto by_target = [this](edge x) -> std::size_t { return target(x); };
+      auto by_source = [this](edge x) -> std::size_t { return source(x); };
+      for (vertex_node& n : verts_) {
+        adjacency_list_impl::sort_incidence(n.out(), by_target);
+        adjacency_list_impl::sort_incidence(n.in(), by_source);
+        if (tracking()) {
+          for (std::size_t i = 0; i < n.out().size(); ++i)
+            pos_[n.out()[i]][0] = i;
+          for (std::size_t i = 0; i < n.in().size(); ++i)
+            pos_[n.in()[i]][1] = i;
+        }
+      }
+      sorted_ = true;
     }
 
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::vertices() const -> vertex_range
+    directed_adjacency_list<V, E, T>::vertices() const -> vertex_range
     {
       return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::edges() const -> edge_range
+    directed_adjacency_list<V, E, T>::edges() const -> edge_range
     {
       return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
     }
 
+  // Split the vertex set into k ranges.
+  template<typename V, typename E, typename T>
+    inline auto
+    directed_adjacency_list<V, E, T>::vertex_blocks(std::size_t k) const
+      -> std::vector<vertex_range>
+    {
+      return adjacency_list_impl::split_pool<vertex_range>(verts_, k);
+    }
+
+  // Split the edge set into k ranges.
+  template<typename V, typename E, typename T>
+    inline auto
+    directed_adjacency_list<V, E, T>::edge_blocks(std::size_t k) const
+      -> std::vector<edge_range>
+    {
+      return adjacency_list_impl::split_pool<edge_range>(edges_, k);
+    }
+
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::out_edges(vertex v) const -> incidence_range
+    directed_adjacency_list<V, E, T>::out_edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin_out()), incidence_iter(vn.end_out())};
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_list<V, E>::in_edges(vertex v) const -> incidence_range
+    directed_adjacency_list<V, E, T>::in_edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin_in()), incidence_iter(vn.end_in())};
@@ -744,6 +1200,305 @@ namespace origin
 
 
 
+  // ------------------------------------------------------------------------ //
+  //                                                    [graph.adj_list.batch]
+  //                            Mutation Batches
+  //
+  // A mutation batch accumulates edge insertions and removals for a directed
+  // adjacency list, and applies them together. Instead of scanning the
+  // incidence lists of its endpoints once per operation, the batch sorts its
+  // operations by endpoints and passes over the incidence lists of each
+  // touched vertex once.
+  //
+  // The operations on each pair of endpoints (u, v) are resolved in the
+  // order they were added to the batch, before the graph is touched:
+  //
+  //    add_edge(u, v)      adds a pending edge.
+  //    remove_edge(u, v)   cancels the most recent pending edge from u to
+  //                        v, if any. Otherwise, it removes an edge from u
+  //                        to v in the graph, if any.
+  //    remove_edges(u, v)  cancels every pending edge from u to v, and
+  //                        removes every edge from u to v in the graph.
+  //
+  // Edges that are removed from the graph are the first in the out edges of
+  // u. The result is the same as applying the operations one at a time,
+  // except that an insertion followed by a removal of the same endpoints
+  // never reaches the graph.
+  //
+  // Applying the batch first removes edges. The out edges of each source
+  // are filtered in one pass, looking up each target among the sorted
+  // removals of the source, and the in edges of each target are filtered
+  // in the same way. Removal preserves the order of the incidence lists.
+  // Pending edges are then added in the order they were given. If the
+  // traits class requires sorted incidence lists, the new edges of each
+  // vertex are merged into its lists at once.
+  template<typename V, typename E, typename T>
+    class mutation_batch<directed_adjacency_list<V, E, T>>
+    {
+      using graph_type = directed_adjacency_list<V, E, T>;
+    public:
+      using vertex = typename graph_type::vertex;
+      using edge = typename graph_type::edge;
+
+      // Create an empty batch of mutations of g.
+      explicit mutation_batch(graph_type& g) : g_(g) { }
+
+      // Returns the number of operations in the batch.
+      std::size_t size() const { return ops_.size(); }
+      bool empty() const { return ops_.empty(); }
+
+      // Insertion
+      void add_edge(vertex u, vertex v) { emplace_edge(u, v); }
+      void add_edge(vertex u, vertex v, E&& x) { emplace_edge(u, v, std::move(x)); }
+      void add_edge(vertex u, vertex v, const E& x) { emplace_edge(u, v, x); }
+
+      template<typename... Args>
+        void emplace_edge(vertex u, vertex v, Args&&... args);
+
+      // Removal
+      void remove_edge(vertex u, vertex v) { push(u, v, remove_one, 0); }
+      void remove_edges(vertex u, vertex v) { push(u, v, remove_all, 0); }
+
+      // Discard the operations of the batch.
+      void clear();
+
+      // Apply the batch to the graph and clear it. Returns the handles of
+      // the added edges, in the order of the calls to add_edge. The handle
+      // of a cancelled edge is invalid.
+      std::vector<edge> apply();
+
+    private:
+      enum kind { insert, remove_one, remove_all };
+
+      static constexpr std::size_t npos = -1;
+
+      struct operation
+      {
+        vertex u;
+        vertex v;
+        kind k;
+        std::size_t index; // The insertion number
+      };
+
+      // A removal of count edges from u to v, or all of them if npos.
+      struct removal
+      {
+        vertex u;
+        vertex v;
+        std::size_t count;
+      };
+
+      void push(vertex u, vertex v, kind k, std::size_t i);
+      void remove(std::vector<removal>& rs);
+      void link_sorted(const std::vector<std::size_t>& keep,
+                       const std::vector<edge>& added);
+
+    private:
+      graph_type& g_;
+      std::vector<operation> ops_;
+      std::vector<std::pair<vertex, vertex>> ends_; // Endpoints, by insertion
+      std::vector<E> values_;                       // Values, by insertion
+    };
+
+  template<typename V, typename E, typename T>
+    inline void
+    mutation_batch<directed_adjacency_list<V, E, T>>::
+      push(vertex u, vertex v, kind k, std::size_t i)
+    {
+      assert(g_.verts_.contains(u) && g_.verts_.contains(v));
+      ops_.push_back({u, v, k, i});
+    }
+
+  template<typename V, typename E, typename T>
+    template<typename... Args>
+      inline void
+      mutation_batch<directed_adjacency_list<V, E, T>>::
+        emplace_edge(vertex u, vertex v, Args&&... args)
+      {
+        push(u, v, insert, values_.size());
+        ends_.emplace_back(u, v);
+        values_.emplace_back(std::forward<Args>(args)...);
+      }
+
+  template<typename V, typename E, typename T>
+    inline void
+    mutation_batch<directed_adjacency_list<V, E, T>>::clear()
+    {
+      ops_.clear();
+      ends_.clear();
+      values_.clear();
+    }
+
+  template<typename V, typename E, typename T>
+    auto
+    mutation_batch<directed_adjacency_list<V, E, T>>::apply() -> std::vector<edge>
+    {
+      // Resolve the operations on each pair of endpoints, in the order they
+      // were given.
+      std::stable_sort(ops_.begin(), ops_.end(),
+                       [](const operation& a, const operation& b) {
+                         return a.u < b.u || (a.u == b.u && a.v < b.v);
+                       });
+      std::vector<removal> rs;
+      std::vector<std::size_t> keep;    // Pending edges, by endpoints
+      std::vector<std::size_t> pending;
+      for (std::size_t i = 0; i < ops_.size(); ) {
+        std::size_t j = i;
+        std::size_t count = 0;
+        pending.clear();
+        for (; j < ops_.size() && ops_[j].u == ops_[i].u && ops_[j].v == ops_[i].v; ++j) {
+          switch (ops_[j].k) {
+          case insert:
+            pending.push_back(ops_[j].index);
+            break;
+          case remove_one:
+            if (!pending.empty())
+              pending.pop_back();
+            else if (count != npos)
+              ++count;
+            break;
+          case remove_all:
+            pending.clear();
+            count = npos;
+            break;
+          }
+        }
+        if (count != 0)
+          rs.push_back({ops_[i].u, ops_[i].v, count});
+        keep.insert(keep.end(), pending.begin(), pending.end());
+        i = j;
+      }
+      if (!rs.empty())
+        remove(rs);
+
+      // Add the pending edges in the order they were given.
+      std::vector<edge> added(values_.size());
+      std::vector<std::size_t> order(keep);
+      std::sort(order.begin(), order.end());
+      for (std::size_t i : order) {
+        vertex u = ends_[i].first;
+        vertex v = ends_[i].second;
+        added[i] = g_.values_.insert(g_.edges_, u, v, std::move(values_[i]));
+        if (!T::sorted_incidence)
+          g_.link_edge(u, v, added[i]);
+      }
+      if (T::sorted_incidence)
+        link_sorted(keep, added);
+
+      clear();
+      return added;
+    }
+
+  // Remove the edges described by rs, which are sorted by endpoints.
+  template<typename V, typename E, typename T>
+    void
+    mutation_batch<directed_adjacency_list<V, E, T>>::remove(std::vector<removal>& rs)
+    {
+      auto by_target = [](const removal& r, vertex v) { return r.v < v; };
+
+      // Filter the out edges of each source.
+      std::vector<std::pair<vertex, edge>> gone; // Target and edge
+      for (std::size_t i = 0; i < rs.size(); ) {
+        vertex u = rs[i].u;
+        std::size_t j = i;
+        while (j < rs.size() && rs[j].u == u)
+          ++j;
+        auto& out = g_.node(u).out();
+        std::size_t n = 0;
+        for (edge e : out) {
+          vertex v = g_.target(e);
+          auto r = std::lower_bound(rs.begin() + i, rs.begin() + j, v, by_target);
+          if (r != rs.begin() + j && r->v == v && r->count != 0) {
+            if (r->count != npos)
+              --r->count;
+            gone.emplace_back(v, e);
+          } else {
+            out[n++] = e;
+          }
+        }
+        out.erase(out.begin() + n, out.end());
+        if (graph_type::tracking())
+          for (std::size_t k = 0; k < out.size(); ++k)
+            g_.pos_[out[k]][0] = k;
+        if (graph_type::hashing() && g_.index_.indexed(u)) {
+          g_.index_.drop(u);
+          if (out.size() >= T::hash_threshold)
+            g_.build_index(u);
+        }
+        i = j;
+      }
+
+      // Filter the in edges of each target.
+      std::sort(gone.begin(), gone.end());
+      for (std::size_t i = 0; i < gone.size(); ) {
+        vertex v = gone[i].first;
+        std::size_t j = i;
+        while (j < gone.size() && gone[j].first == v)
+          ++j;
+        auto& in = g_.node(v).in();
+        std::size_t n = 0;
+        for (edge e : in) {
+          auto x = std::make_pair(v, e);
+          if (!std::binary_search(gone.begin() + i, gone.begin() + j, x))
+            in[n++] = e;
+        }
+        in.erase(in.begin() + n, in.end());
+        if (graph_type::tracking())
+          for (std::size_t k = 0; k < in.size(); ++k)
+            g_.pos_[in[k]][1] = k;
+        i = j;
+      }
+
+      for (auto& x : gone) {
+        g_.edges_.erase(x.second);
+        g_.values_.erase(x.second);
+      }
+    }
+
+  // Merge the added edges into the sorted incidence lists of their
+  // endpoints. The indexes in keep are ordered by endpoints.
+  template<typename V, typename E, typename T>
+    void
+    mutation_batch<directed_adjacency_list<V, E, T>>::
+      link_sorted(const std::vector<std::size_t>& keep,
+                  const std::vector<edge>& added)
+    {
+      auto by_target = [this](edge a, edge b) { return g_.target(a) < g_.target(b); };
+      auto by_source = [this](edge a, edge b) { return g_.source(a) < g_.source(b); };
+
+      // Out edges, grouped by source.
+      for (std::size_t i = 0; i < keep.size(); ) {
+        vertex u = ends_[keep[i]].first;
+        auto& out = g_.node(u).out();
+        std::size_t mid = out.size();
+        for (; i < keep.size() && ends_[keep[i]].first == u; ++i)
+          out.push_back(added[keep[i]]);
+        std::inplace_merge(out.begin(), out.begin() + mid, out.end(), by_target);
+        if (graph_type::hashing()) {
+          g_.index_.drop(u);
+          if (out.size() >= T::hash_threshold)
+            g_.build_index(u);
+        }
+      }
+
+      // In edges, grouped by target. Edges with the same endpoints keep the
+      // order in which they were given.
+      std::vector<std::size_t> ins(keep);
+      std::stable_sort(ins.begin(), ins.end(), [this](std::size_t a, std::size_t b) {
+        return ends_[a].second < ends_[b].second;
+      });
+      for (std::size_t i = 0; i < ins.size(); ) {
+        vertex v = ends_[ins[i]].second;
+        auto& in = g_.node(v).in();
+        std::size_t mid = in.size();
+        for (; i < ins.size() && ends_[ins[i]].second == v; ++i)
+          in.push_back(added[ins[i]]);
+        std::inplace_merge(in.begin(), in.begin() + mid, in.end(), by_source);
+      }
+    }
+
+
+
   // ------------------------------------------------------------------------ //
   //                                                      [graph.adj_list.undir]
   //                        Undirected Adjacency List
@@ -760,13 +1515,13 @@ namespace origin
     //                        Vertex Representation
     
     // A vertex in an undirected adjacency list is simply a list of incident
-    // edges. No distinction is made between in or out edges.
-    template<typename V>
+    // edges, of type L. No distinction is made between in or out edges.
+    template<typename V, typename L = edge_list>
       struct vertex
       {
         using value_type = V;
-        using iterator = typename edge_list::iterator;
-        using const_iterator = typename edge_list::const_iterator;
+        using iterator = typename L::iterator;
+        using const_iterator = typename L::const_iterator;
     
         vertex()
           : data()
@@ -774,12 +1529,12 @@ namespace origin
 
         template<typename... Args>
           vertex(Args&&... args) 
-            : data(edge_list{}, std::forward<Args>(args)...)
+            : data(L{}, std::forward<Args>(args)...)
           { }
 
         // Returns the out ege list
-        edge_list&       edges()       { return std::get<0>(data); }
-        const edge_list& edges() const { return std::get<0>(data); }
+        L&       edges()       { return std::get<0>(data); }
+        const L& edges() const { return std::get<0>(data); }
         
         // Returns the user-supplied data object.
         V&       value()       { return std::get<1>(data); }
@@ -797,19 +1552,19 @@ namespace origin
         const_iterator end() const   { return edges().end(); }
 
       public:
-        std::tuple<edge_list, V> data;
+        std::tuple<L, V> data;
       };
 
-    template<typename V>
+    template<typename V, typename L>
       inline void
-      vertex<V>::insert(std::size_t e)
+      vertex<V, L>::insert(std::size_t e)
       {
         edges().push_back(e);
       }
 
-    template<typename V>
+    template<typename V, typename L>
       inline void
-      vertex<V>::erase(std::size_t e)
+      vertex<V, L>::erase(std::size_t e)
       {
         auto i = std::find(begin(), end(), e);
         if (i != end())
@@ -817,43 +1572,69 @@ namespace origin
       }
 
     // A vertex set is a pool of vertices.
-    template<typename V>
-      using vertex_pool = pool<vertex<V>>;
+    template<typename V, typename L, typename Q, typename I = std::size_t>
+      using vertex_pool = pool<vertex<V, L>, Q, I>;
 
     // An alias for the vertex iterator.
-    template<typename V>
-      using vertex_iterator = handle_iterator<vertex_pool<V>, vertex_handle>;
+    template<typename V, typename L, typename Q, typename I = std::size_t>
+      using vertex_iterator =
+        handle_iterator<vertex_pool<V, L, Q, I>, basic_vertex_handle<I>>;
 
     // An alias for the vertex range.
-    template<typename V>
-      using vertex_range = bounded_range<vertex_iterator<V>>;
+    template<typename V, typename L, typename Q, typename I = std::size_t>
+      using vertex_range = bounded_range<vertex_iterator<V, L, Q, I>>;
 
   } // namespace undirected_adjacency_list_impl
 
 
   // Implementation of the undirected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  template<typename V = empty_t,
+           typename E = empty_t,
+           typename T = adjacency_list_traits>
     class undirected_adjacency_list
     {
-      using this_type = undirected_adjacency_list<V, E>;
-
-      using vertex_node = undirected_adjacency_list_impl::vertex<V>;
-      using vertex_set = undirected_adjacency_list_impl::vertex_pool<V>;
-      using vertex_iter = undirected_adjacency_list_impl::vertex_iterator<V>;
-
-      using edge_node = adjacency_list_impl::edge<E>;
-      using edge_set = adjacency_list_impl::edge_pool<E>;
-      using edge_iter = adjacency_list_impl::edge_iterator<E>;
-
-      using incidence_iter = adjacency_list_impl::incidence_iterator;
+      static_assert(!(T::sorted_incidence && T::track_positions),
+                    "sorted incidence lists cannot track positions");
+
+      using this_type = undirected_adjacency_list<V, E, T>;
+      using index_type = typename T::index_type;
+      using free_list = typename T::free_list;
+      using incidence_list = typename T::incidence_list;
+
+      static_assert(std::is_same<typename incidence_list::value_type,
+                                 basic_edge_handle<index_type>>::value,
+                    "incidence lists must store edge handles of the index type");
+
+      using vertex_node = undirected_adjacency_list_impl::vertex<V, incidence_list>;
+      using vertex_set = undirected_adjacency_list_impl::
+        vertex_pool<V, incidence_list, free_list, index_type>;
+      using vertex_iter = undirected_adjacency_list_impl::
+        vertex_iterator<V, incidence_list, free_list, index_type>;
+
+      using value_store = If<T::split_edge_values,
+                             adjacency_list_impl::split_values<E>,
+                             adjacency_list_impl::inline_values<E>>;
+      using record_value = typename value_store::record_value;
+
+      using edge_node = adjacency_list_impl::edge<record_value, index_type>;
+      using edge_set =
+        adjacency_list_impl::edge_pool<record_value, free_list, index_type>;
+      using edge_iter =
+        adjacency_list_impl::edge_iterator<record_value, free_list, index_type>;
+
+      using incidence_iter =
+        adjacency_list_impl::incidence_iterator<incidence_list>;
     public:
-      using vertex = vertex_handle;
-      using vertex_range = undirected_adjacency_list_impl::vertex_range<V>;
+      using vertex = basic_vertex_handle<index_type>;
+      using vertex_range = undirected_adjacency_list_impl::
+        vertex_range<V, incidence_list, free_list, index_type>;
 
-      using edge = edge_handle;
-      using edge_range = adjacency_list_impl::edge_range<E>;
+      using edge = basic_edge_handle<index_type>;
+      using edge_range =
+        adjacency_list_impl::edge_range<record_value, free_list, index_type>;
 
-      using incidence_range = adjacency_list_impl::incidence_range;
+      using incidence_range =
+        adjacency_list_impl::incidence_range<incidence_list>;
 
 
       // Observers
@@ -863,6 +1644,10 @@ namespace origin
       bool        empty() const { return edges_.empty(); }
       std::size_t size() const  { return edges_.size(); }
 
+      // Handle bounds
+      std::size_t vertex_bound() const { return verts_.bound(); }
+      std::size_t edge_bound() const   { return edges_.bound(); }
+
       // Vertex observers
       std::size_t degree(vertex v) const { return node(v).degree(); }
 
@@ -878,8 +1663,8 @@ namespace origin
       V&       operator()(vertex v)       { return node(v).value(); }
       const V& operator()(vertex v) const { return node(v).value(); }
 
-      E&       operator()(edge e)       { return get_edge(e).value(); }
-      const E& operator()(edge e) const { return get_edge(e).value(); }
+      E&       operator()(edge e)       { return values_.get(edges_, e); }
+      const E& operator()(edge e) const { return values_.get(edges_, e); }
 
       // Relation
       edge operator()(vertex u, vertex v) const;
@@ -909,11 +1694,28 @@ namespace origin
       void remove_edges(vertex v);
       void remove_edges();
 
+      // Compaction
+      basic_handle_map<index_type> compact();
+
+      // Incidence order
+      // The graph is sorted when the incident edges of each vertex are
+      // ordered by their opposite endpoints. The edge relation of a sorted
+      // graph is a binary search.
+      bool sorted() const { return sorted_; }
+      void sort_adjacency();
+
       // Iterators
       vertex_range    vertices() const;
       edge_range      edges() const;
       incidence_range edges(vertex v) const;
 
+      // Block iterators
+      // These operations split the vertex or edge set into k contiguous
+      // ranges of about the same size, so that each can be processed by a
+      // different thread.
+      std::vector<vertex_range> vertex_blocks(std::size_t k) const;
+      std::vector<edge_range>   edge_blocks(std::size_t k) const;
+
     private:
       vertex_node&       node(vertex v)       { return verts_[v]; }
       const vertex_node& node(vertex v) const { return verts_[v]; }
@@ -941,16 +1743,39 @@ namespace origin
       template<typename S, typename I>
         void erase_edge(S& seq1, I iter1, S& seq2, I iter2);
 
+      // Helper functions for position tracking.
+      static constexpr bool tracking() { return T::track_positions; }
+
+      void track_edge(edge e);
+      void untrack_edge(vertex v, edge e, int k);
+
+      // Helper functions for neighbor indexing.
+      static constexpr bool hashing() { return T::hash_threshold != 0; }
+
+      void index_edge(vertex u, vertex v, edge e);
+      void unindex_edge(vertex u, vertex v, edge e);
+      void build_index(vertex v);
+      void reindex();
+      void destroy_edge(edge e);
+
     private:
       vertex_set verts_;
       edge_set   edges_;
+      value_store values_; // Edge values, if split
+      adjacency_list_impl::position_list<index_type> pos_; // Edge positions, if tracked
+      adjacency_list_impl::neighbor_index index_; // Edges by opposite end
+      bool sorted_ = true; // True if the incidence lists are sorted
     };
 
   // Returns true if the an edge {u, v} is in the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::operator()(vertex u, vertex v) const -> edge
+    undirected_adjacency_list<V, E, T>::operator()(vertex u, vertex v) const -> edge
     {
+      if (hashing() && index_.indexed(u))
+        return index_.find(u, v);
+      if (hashing() && index_.indexed(v))
+        return index_.find(v, u);
       if (degree(u) <= degree(v))
         return find_edge(u, v);
       else
@@ -962,22 +1787,27 @@ namespace origin
   //
   // Note that, if u and v are connected, then the edge was added as either
   // (u, v) or (v, u). We prefer to search the vertex with the smaller degree
-  // for evidence of either construction.
-  template<typename V, typename E>
+  // for evidence of either construction, which the caller passes as u.
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::find_edge(vertex u, vertex v) const -> edge
+    undirected_adjacency_list<V, E, T>::find_edge(vertex u, vertex v) const -> edge
     {
       using P = has_endpoints<this_type>;
-      const vertex_node& n = node(v);
+      const vertex_node& n = node(u);
+      if (sorted()) {
+        auto key = [this, u](edge e) -> std::size_t { return opposite(*this, e, u); };
+        auto i = adjacency_list_impl::find_sorted(n.edges(), v, key);
+        return i == n.edges().end() ? edge() : *i;
+      }
       return find_endpoints(n.edges(), P(*this, u, v));
     }
 
   // Return an iterator to the the first incident edge whose end (either
   // source or target) is equal to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename S, typename P>
       inline auto
-      undirected_adjacency_list<V, E>::
+      undirected_adjacency_list<V, E, T>::
         find_endpoints(const S& seq, P pred) const -> edge
       {
         auto i = find_if(seq, pred);
@@ -987,101 +1817,233 @@ namespace origin
 
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::add_vertex() -> vertex
+    undirected_adjacency_list<V, E, T>::add_vertex() -> vertex
     {
       return verts_.emplace();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::add_vertex(V&& x) -> vertex
+    undirected_adjacency_list<V, E, T>::add_vertex(V&& x) -> vertex
     {
       return verts_.emplace(std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::add_vertex(const V& x) -> vertex
+    undirected_adjacency_list<V, E, T>::add_vertex(const V& x) -> vertex
     {
       return verts_.emplace(x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename... Args>
       inline auto
-      undirected_adjacency_list<V, E>::emplace_vertex(Args&&... args) -> vertex
+      undirected_adjacency_list<V, E, T>::emplace_vertex(Args&&... args) -> vertex
       {
         return verts_.emplace(std::forward<Args>(args)...);
       }
 
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::remove_vertex(vertex v)
+    undirected_adjacency_list<V, E, T>::remove_vertex(vertex v)
     {
       remove_edges(v);
       verts_.erase(v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::remove_vertices()
+    undirected_adjacency_list<V, E, T>::remove_vertices()
     {
       edges_.clear();
+      values_.clear();
       verts_.clear();
+      pos_.clear();
+      index_.clear();
+      sorted_ = true;
     }
 
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::add_edge(vertex u, vertex v) -> edge
+    undirected_adjacency_list<V, E, T>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    undirected_adjacency_list<V, E, T>::add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::add_edge(vertex u, vertex v, const E& x) -> edge
+    undirected_adjacency_list<V, E, T>::add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename... Args>
       inline auto
-      undirected_adjacency_list<V, E>::
+      undirected_adjacency_list<V, E, T>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
-        edge e = edges_.emplace(u, v, std::forward<Args>(args)...);
+        edge e = values_.insert(edges_, u, v, std::forward<Args>(args)...);
         link_edge(u, v, e);
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::link_edge(vertex u, vertex v, edge e)
+    undirected_adjacency_list<V, E, T>::link_edge(vertex u, vertex v, edge e)
     {
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
-      un.insert(e);
-      vn.insert(e);
+      auto from_u = [this, u](edge x) -> std::size_t { return opposite(*this, x, u); };
+      auto from_v = [this, v](edge x) -> std::size_t { return opposite(*this, x, v); };
+      if (T::sorted_incidence) {
+        adjacency_list_impl::insert_sorted(un.edges(), e, v, from_u);
+        adjacency_list_impl::insert_sorted(vn.edges(), e, u, from_v);
+      } else {
+        if (tracking())
+          track_edge(e);
+        sorted_ = sorted_
+               && adjacency_list_impl::extends_sorted(un.edges(), v, from_u)
+               && adjacency_list_impl::extends_sorted(vn.edges(), u, from_v);
+        un.insert(e);
+        vn.insert(e);
+      }
+      if (hashing()) {
+        index_edge(u, v, e);
+        if (u != v)
+          index_edge(v, u, e);
+      }
+    }
+
+  // Record the positions of the edge e, which is about to be appended to the
+  // incidence lists of its endpoints. Note that a loop is appended twice to
+  // the same list.
+  template<typename V, typename E, typename T>
+    inline void
+    undirected_adjacency_list<V, E, T>::track_edge(edge e)
+    {
+      if (pos_.size() < edges_.bound())
+        pos_.resize(edges_.bound());
+      vertex u = source(e);
+      vertex v = target(e);
+      std::size_t i = degree(u);
+      pos_[e][0] = i;
+      pos_[e][1] = u == v ? i + 1 : degree(v);
+    }
+
+  // Erase the kth entry of the edge e from the incidence list of v, where k
+  // is 0 for the source and 1 for the target. The last edge in the list is
+  // moved into the position of e, and the position of the moved entry is
+  // updated. If the moved edge is a loop, the entry that was last is the
+  // one that moves.
+  template<typename V, typename E, typename T>
+    inline void
+    undirected_adjacency_list<V, E, T>::untrack_edge(vertex v, edge e, int k)
+    {
+      incidence_list& seq = node(v).edges();
+      std::size_t i = pos_[e][k];
+      std::size_t n = seq.size() - 1;
+      assert(seq[i] == e);
+      edge x = seq.back();
+      if (i != n)
+        sorted_ = false;
+      seq[i] = x;
+      if (pos_[x][0] == n && source(x) == v)
+        pos_[x][0] = i;
+      else
+        pos_[x][1] = i;
+      seq.pop_back();
+    }
+
+  // Record the edge e, which has just been appended to the incidence list of
+  // u, in the neighbor table of u. The table is built when the degree of u
+  // reaches the threshold. Like the incidence list, the table counts a loop
+  // twice.
+  template<typename V, typename E, typename T>
+    inline void
+    undirected_adjacency_list<V, E, T>::index_edge(vertex u, vertex v, edge e)
+    {
+      if (index_.indexed(u)) {
+        index_.insert(u, v, e);
+        if (u == v)
+          index_.insert(u, v, e);
+      } else if (degree(u) >= T::hash_threshold)
+        build_index(u);
+    }
+
+  // Forget the edge e connecting u to v in the neighbor table of u. If e was
+  // the recorded edge, the first other live edge connecting u to v is
+  // recorded instead.
+  template<typename V, typename E, typename T>
+    void
+    undirected_adjacency_list<V, E, T>::unindex_edge(vertex u, vertex v, edge e)
+    {
+      if (!index_.erase(u, v, e))
+        return;
+      for (edge x : node(u).edges()) {
+        if (x != e && edges_.contains(x) && opposite(*this, x, u) == v) {
+          index_.replace(u, v, x);
+          return;
+        }
+      }
+    }
+
+  // Build the neighbor table of v from its incidence list.
+  template<typename V, typename E, typename T>
+    void
+    undirected_adjacency_list<V, E, T>::build_index(vertex v)
+    {
+      index_.build(v, degree(v));
+      for (edge e : node(v).edges())
+        index_.insert(v, opposite(*this, e, v), e);
+    }
+
+  // Rebuild the neighbor tables of all vertices whose degree has reached the
+  // threshold.
+  template<typename V, typename E, typename T>
+    void
+    undirected_adjacency_list<V, E, T>::reindex()
+    {
+      index_.clear();
+      for (vertex v : vertices())
+        if (degree(v) >= T::hash_threshold)
+          build_index(v);
+    }
+
+  // Erase the edge e from the edge set. Every edge is destroyed through this
+  // function so that the neighbor tables stay in sync.
+  template<typename V, typename E, typename T>
+    inline void
+    undirected_adjacency_list<V, E, T>::destroy_edge(edge e)
+    {
+      if (hashing()) {
+        vertex u = source(e);
+        vertex v = target(e);
+        unindex_edge(u, v, e);
+        unindex_edge(v, u, e);
+      }
+      edges_.erase(e);
+      values_.erase(e);
     }
 
   // Remove the specified edge from the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::remove_edge(edge e)
+    undirected_adjacency_list<V, E, T>::remove_edge(edge e)
     {
       vertex u = source(e);
       vertex v = target(e);
@@ -1092,10 +2054,18 @@ namespace origin
     }
 
   // Unlink the given edge from the vertex, when the edge is looped.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::unlink_loop(vertex v, edge e)
+    undirected_adjacency_list<V, E, T>::unlink_loop(vertex v, edge e)
     {
+      if (tracking()) {
+        // Erase the later entry first so that the earlier one does not move.
+        int k = pos_[e][0] < pos_[e][1];
+        untrack_edge(v, e, k);
+        untrack_edge(v, e, 1 - k);
+        destroy_edge(e);
+        return;
+      }
       vertex_node& n = node(v);
       auto i = find(n.edges(), e);
       if (i != n.end())
@@ -1103,21 +2073,27 @@ namespace origin
     }
 
   // Erase the loop edge referred to by the edge list iterator i.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename S, typename I>
       inline void
-      undirected_adjacency_list<V, E>::erase_loop(S& seq, I iter)
+      undirected_adjacency_list<V, E, T>::erase_loop(S& seq, I iter)
       {
-        edges_.erase(*iter);
+        destroy_edge(*iter);
         seq.erase(iter, std::next(iter, 2));
       }
 
   // Unlink the given edge from the source and target vertices, and erase
   // it from the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::unlink_edge(vertex u, vertex v, edge e)
+    undirected_adjacency_list<V, E, T>::unlink_edge(vertex u, vertex v, edge e)
     {
+      if (tracking()) {
+        untrack_edge(u, e, 0);
+        untrack_edge(v, e, 1);
+        destroy_edge(e);
+        return;
+      }
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
 
@@ -1130,22 +2106,25 @@ namespace origin
 
   // Erase the edge e from the graph by removing the endpoints and the edge
   // object.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename S, typename I>
       inline void
-      undirected_adjacency_list<V, E>::erase_edge(S& seq1, I iter1, S& seq2, I iter2)
+      undirected_adjacency_list<V, E, T>::erase_edge(S& seq1, I iter1, S& seq2, I iter2)
         {
-          edges_.erase(*iter1);
+          destroy_edge(*iter1);
           seq1.erase(iter1);
           seq2.erase(iter2);
         }
 
   // Remove the first edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::remove_edge(vertex u, vertex v)
+    undirected_adjacency_list<V, E, T>::remove_edge(vertex u, vertex v)
     {
-      if (u == v)
+      if (tracking() || hashing()) {
+        if (edge e = (*this)(u, v))
+          remove_edge(e);
+      } else if (u == v)
         unlink_first_loop(v);
       else if (degree(u) <= degree(v))
         unlink_first_edge(u, v);
@@ -1154,11 +2133,11 @@ namespace origin
     }
 
   // Find and remove the first loop connecting v to itself.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::unlink_first_loop(vertex v)
+    undirected_adjacency_list<V, E, T>::unlink_first_loop(vertex v)
     {
-      using P = has_endpoint<this_type>;
+      using P = is_looped<this_type>;
       vertex_node& n = node(v); 
       auto i = find_if(n.edges(), P(*this, v));
       if (i != n.end())
@@ -1166,9 +2145,9 @@ namespace origin
     }
 
   // Find and remove the first edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::unlink_first_edge(vertex u, vertex v)
+    undirected_adjacency_list<V, E, T>::unlink_first_edge(vertex u, vertex v)
     {
       using P = has_endpoints<this_type>;
       vertex_node& un = node(u);
@@ -1182,57 +2161,81 @@ namespace origin
       
       // Find the corresponding edge in v's list. Note that *i must exist
       // in the incidence list of vn, otherwise, the graph is ill-formed.
-      auto j = find(vn.begin(), vn.end(), *i);
+      auto j = std::find(vn.begin(), vn.end(), *i);
       assert(j != vn.end());
       erase_edge(un.edges(), i, vn.edges(), j);
     }
 
   // Remove all edges connecting u to v. 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::remove_edges(vertex u, vertex v)
+    undirected_adjacency_list<V, E, T>::remove_edges(vertex u, vertex v)
     {
-      if (u == v)
+      if (tracking()) {
+        // Loops appear twice in the incidence list, so only collect the
+        // first entry of each edge.
+        std::vector<edge> es;
+        const incidence_list& seq = node(u).edges();
+        for (std::size_t i = 0; i < seq.size(); ++i) {
+          edge e = seq[i];
+          if (are_endpoints(*this, e, u, v) && (u != v || pos_[e][0] == i))
+            es.push_back(e);
+        }
+        for (edge e : es)
+          remove_edge(e);
+      } else if (u == v) {
         unlink_multi_loop(u);
-      else 
+      } else {
         unlink_multi_edge(u, v);
+      }
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::unlink_multi_loop(vertex v)
+    undirected_adjacency_list<V, E, T>::unlink_multi_loop(vertex v)
     {
       using P = is_looped<this_type>;
       vertex_node& n = node(v);
-      auto i = partition(n, negate(P(*this, v)));
-      for (auto j = i; j != n.end(); advance(j, 2))
-        edges_.erase(*j);
+
+      // The partition is stable so that the two entries of each loop remain
+      // adjacent.
+      auto i = stable_partition(n, negate(P(*this, v)));
+      for (auto j = i; j != n.end(); std::advance(j, 2))
+        destroy_edge(*j);
       n.edges().erase(i, n.end());
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::unlink_multi_edge(vertex u, vertex v)
+    undirected_adjacency_list<V, E, T>::unlink_multi_edge(vertex u, vertex v)
     {
       using P = has_endpoints<this_type>;
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
 
-      auto i = partition(un.edges(), negate(P(*this, u, v)));
-      auto j = partition(vn.edges(), negate(P(*this, v, u)));
+      // Stable partitions keep the entries of loops on u and v adjacent.
+      auto i = stable_partition(un.edges(), negate(P(*this, u, v)));
+      auto j = stable_partition(vn.edges(), negate(P(*this, v, u)));
       for (auto k = i; k != un.end(); ++k)
-        edges_.erase(*k);
+        destroy_edge(*k);
       un.edges().erase(i, un.end());
       vn.edges().erase(j, vn.end());
     }
 
 
   // Remove all edges incident to the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::remove_edges(vertex v)
+    undirected_adjacency_list<V, E, T>::remove_edges(vertex v)
     {
       vertex_node& vn = node(v);
+      if (hashing())
+        index_.drop(v);
+      if (tracking()) {
+        while (!vn.edges().empty())
+          remove_edge(vn.edges().back());
+        return;
+      }
       
       // Clear the incident edges by removing each edge from the incidence
       // list of its corresponding endpoint. Handle loops differenty.
@@ -1243,14 +2246,14 @@ namespace origin
       auto i = vn.begin();
       while (i != vn.end()) {
         if (is_loop(*this, *i)) {
-          edges_.erase(*i);
+          destroy_edge(*i);
           std::advance(i, 2);
         } else {
           vertex_node& n = node(opposite(*this, *i, v));
           auto j = find(n.edges(), *i);
           if (j != n.end()) {
             n.edges().erase(j);
-            edges_.erase(*i);
+            destroy_edge(*i);
           }
           ++i;
         }
@@ -1260,35 +2263,110 @@ namespace origin
 
 
   // Remove all edges from a graph, making it empty.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_list<V, E>::remove_edges()
+    undirected_adjacency_list<V, E, T>::remove_edges()
     {
       for (vertex_node& n : verts_)
         n.edges().clear();
       edges_.clear();
+      values_.clear();
+      pos_.clear();
+      index_.clear();
+      sorted_ = true;
+    }
+
+  // Squeeze the removed vertices and edges out of the graph, releasing the
+  // memory they occupy. The vertices and edges are renumbered densely,
+  // preserving their order, and every incidence list and edge endpoint is
+  // rewritten. The result maps the old handles to the new handles.
+  template<typename V, typename E, typename T>
+    auto
+    undirected_adjacency_list<V, E, T>::compact() -> basic_handle_map<index_type>
+    {
+      std::vector<std::size_t> vm = verts_.compact();
+      std::vector<std::size_t> em = edges_.compact();
+      for (edge_node& e : edges_) {
+        e.source() = vm[e.source()];
+        e.target() = vm[e.target()];
+      }
+      for (vertex_node& n : verts_)
+        for (edge& e : n.edges())
+          e = em[e];
+      values_.compact(em, size());
+      if (tracking())
+        adjacency_list_impl::compact_table(pos_, em, size());
+      if (hashing())
+        reindex();
+      return {{vm.begin(), vm.end()}, {em.begin(), em.end()}};
+    }
+
+  // Sort the incident edges of each vertex by their opposite endpoints.
+  // Edges with the same endpoints keep their relative order, so the two
+  // entries of a loop remain adjacent if they were. When positions are
+  // tracked, the first entry of a loop is recorded as its source position.
+  template<typename V, typename E, typename T>
+    void
+    undirected_adjacency_list<V, E, T>::sort_adjacency()
+    {
+      for (vertex v : vertices()) {
+        incidence_list& seq = node(v).edges();
+        auto key = [this, v](edge x) -> std::size_t { return opposite(*this, x, v); };
+        adjacency_list_impl::sort_incidence(seq, key);
+        if (tracking()) {
+          for (edge e : seq)
+            if (is_loop(*this, e))
+              pos_[e][0] = -1;
+          for (std::size_t i = 0; i < seq.size(); ++i) {
+            edge e = seq[i];
+            if (is_loop(*this, e))
+              pos_[e][pos_[e][0] != index_type(-1)] = i;
+            else
+              pos_[e][target(e) == v] = i;
+          }
+        }
+      }
+      sorted_ = true;
     }
 
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::vertices() const -> vertex_range
+    undirected_adjacency_list<V, E, T>::vertices() const -> vertex_range
     {
       return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::edges() const -> edge_range
+    undirected_adjacency_list<V, E, T>::edges() const -> edge_range
     {
       return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
     }
 
+  // Split the vertex set into k ranges.
+  template<typename V, typename E, typename T>
+    inline auto
+    undirected_adjacency_list<V, E, T>::vertex_blocks(std::size_t k) const
+      -> std::vector<vertex_range>
+    {
+      return adjacency_list_impl::split_pool<vertex_range>(verts_, k);
+    }
+
+  // Split the edge set into k ranges.
+  template<typename V, typename E, typename T>
+    inline auto
+    undirected_adjacency_list<V, E, T>::edge_blocks(std::size_t k) const
+      -> std::vector<edge_range>
+    {
+      return adjacency_list_impl::split_pool<edge_range>(edges_, k);
+    }
+
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_list<V, E>::edges(vertex v) const -> incidence_range
+    undirected_adjacency_list<V, E, T>::edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin()), incidence_iter(vn.end())};
@@ -0,0 +1,181 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_BITMAP_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_BITMAP_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                              Bitmap Queue
+    //
+    // A bitmap queue is a min-queue of indices implemented as a hierarchical
+    // bitmap. The bottom level of the hierarchy has one bit per index, which
+    // is set when the index is in the queue. Each higher level summarizes the
+    // level beneath it: there is one bit per word of the lower level, and it
+    // is set when that word is non-zero. The top level is a single word.
+    //
+    // The least index is found by descending from the top level, taking the
+    // first set bit of each word on the way down. With 64-bit words, the
+    // height of the hierarchy is log64(n), so a queue over a billion indices
+    // has only 5 levels.
+    //
+    // The bitmap queue provides the same interface as the min-queue used by
+    // the pool (empty, size, top, push, and pop), so it can be used as the
+    // pool's free index list. Unlike the min-queue, it also answers membership
+    // queries in constant time, so it doubles as a map of the dead indices of
+    // the pool.
+    //
+    // Performance properties:
+    //    - Top: O(log64 n)
+    //    - Push: O(log64 n), amortized
+    //    - Pop: O(log64 n)
+    //    - Contains: O(1)
+    // Where n is the greatest index pushed into the queue. The queue requires
+    // about n/8 bytes of memory, regardless of its size.
+    class bitmap_queue
+    {
+    public:
+      using word_type = std::uint64_t;
+      using word_list = std::vector<word_type>;
+
+      static constexpr std::size_t word_bits = 64;
+
+      bitmap_queue();
+
+      // Observers
+      bool        empty() const { return size_ == 0; }
+      std::size_t size() const  { return size_; }
+
+      // Returns the number of indices that can be stored without growing.
+      std::size_t capacity() const { return words().size() * word_bits; }
+
+      // Returns true if the index n is in the queue.
+      bool contains(std::size_t n) const;
+
+      // Returns the bottom level of the bitmap. Bit i of the word at w is set
+      // when the index w * word_bits + i is in the queue.
+      const word_list& words() const { return levels_.front(); }
+
+      // Queue operations
+      std::size_t top() const;
+      void push(std::size_t n);
+      void pop();
+
+    private:
+      void grow(std::size_t n);
+      void set(std::size_t n);
+      void reset(std::size_t n);
+
+      static word_type bit(std::size_t n) { return word_type(1) << (n % word_bits); }
+
+    private:
+      std::vector<word_list> levels_; // Bitmap levels, from bottom to top
+      std::size_t size_;              // Number of indices in the queue
+    };
+
+    inline
+    bitmap_queue::bitmap_queue()
+      : levels_(1, word_list(1, 0)), size_(0)
+    { }
+
+    inline bool
+    bitmap_queue::contains(std::size_t n) const
+    {
+      return n < capacity() && (words()[n / word_bits] & bit(n));
+    }
+
+    // Returns the least index in the queue by descending from the top of the
+    // hierarchy. At each level, the position of the first set bit selects the
+    // word to examine in the level below.
+    inline std::size_t
+    bitmap_queue::top() const
+    {
+      assert(!empty());
+      std::size_t n = 0;
+      for (std::size_t l = levels_.size(); l-- != 0; )
+        n = n * word_bits + __builtin_ctzll(levels_[l][n]);
+      return n;
+    }
+
+    inline void
+    bitmap_queue::push(std::size_t n)
+    {
+      assert(!contains(n));
+      if (n >= capacity())
+        grow(n);
+      set(n);
+      ++size_;
+    }
+
+    inline void
+    bitmap_queue::pop()
+    {
+      reset(top());
+      --size_;
+    }
+
+    // Set the bit for the index n, and set the bits summarizing each word that
+    // changes from zero to non-zero.
+    inline void
+    bitmap_queue::set(std::size_t n)
+    {
+      for (word_list& level : levels_) {
+        word_type& w = level[n / word_bits];
+        bool was_empty = (w == 0);
+        w |= bit(n);
+        if (!was_empty)
+          return;
+        n /= word_bits;
+      }
+    }
+
+    // Clear the bit for the index n, and clear the bits summarizing each word
+    // that changes from non-zero to zero.
+    inline void
+    bitmap_queue::reset(std::size_t n)
+    {
+      for (word_list& level : levels_) {
+        word_type& w = level[n / word_bits];
+        w &= ~bit(n);
+        if (w != 0)
+          return;
+        n /= word_bits;
+      }
+    }
+
+    // Grow the bottom level so that it can store the index n, at least
+    // doubling its size, and rebuild the summary levels above it.
+    inline void
+    bitmap_queue::grow(std::size_t n)
+    {
+      std::size_t m = std::max(n / word_bits + 1, 2 * words().size());
+      levels_.resize(1);
+      levels_.front().resize(m, 0);
+      while (levels_.back().size() > 1) {
+        const word_list& low = levels_.back();
+        word_list high((low.size() + word_bits - 1) / word_bits, 0);
+        for (std::size_t i = 0; i < low.size(); ++i)
+          if (low[i])
+            high[i / word_bits] |= bit(i);
+        levels_.push_back(std::move(high));
+      }
+    }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
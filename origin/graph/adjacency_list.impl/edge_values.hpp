@@ -0,0 +1,156 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_EDGE_VALUES_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_EDGE_VALUES_HPP
+
+#include <utility>
+#include <vector>
+
+#include <origin/type/empty.hpp>
+#include <origin/graph/adjacency_list.impl/pool.hpp>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // Move the entries of a table indexed by edge to the new indexes of
+    // their edges after compaction, where map is the mapping of old to new
+    // edge indexes and n is the number of edges.
+    template<typename T>
+      inline void
+      compact_table(std::vector<T>& table,
+                    const std::vector<std::size_t>& map,
+                    std::size_t n)
+      {
+        std::vector<T> x(n);
+        for (std::size_t e = 0; e < map.size() && e < table.size(); ++e)
+          if (map[e] != std::size_t(-1))
+            x[map[e]] = std::move(table[e]);
+        table.swap(x);
+      }
+
+    // Insert a new record into an edge pool or an edge vector, returning its
+    // index.
+    template<typename T, typename Q, typename I, typename... Args>
+      inline std::size_t
+      insert_record(pool<T, Q, I>& p, Args&&... args)
+      {
+        return p.emplace(std::forward<Args>(args)...);
+      }
+
+    template<typename T, typename... Args>
+      inline std::size_t
+      insert_record(std::vector<T>& v, Args&&... args)
+      {
+        v.emplace_back(std::forward<Args>(args)...);
+        return v.size() - 1;
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                              Edge Values
+    //
+    // An edge value store determines where the user data of each edge is
+    // kept. The edge records of a graph contain the endpoints of each edge
+    // and a value of type record_value. The store inserts records into the
+    // graph's edge container C, which is a pool or a vector of records, and
+    // provides access to the value of each edge.
+    //
+    // The inline store keeps each value in its record. This is best when
+    // algorithms usually read an edge's value along with its endpoints.
+    template<typename E>
+      struct inline_values
+      {
+        using record_value = E;
+
+        template<typename C>
+          E& get(C& c, std::size_t e) { return c[e].value(); }
+
+        template<typename C>
+          const E& get(const C& c, std::size_t e) const { return c[e].value(); }
+
+        template<typename C, typename... Args>
+          std::size_t
+          insert(C& c, std::size_t u, std::size_t v, Args&&... args)
+          {
+            return insert_record(c, u, v, std::forward<Args>(args)...);
+          }
+
+        // Replace the record at index e of the vector c. Records at
+        // different indexes may be assigned concurrently.
+        template<typename C, typename... Args>
+          void
+          assign(C& c, std::size_t e, std::size_t u, std::size_t v, Args&&... args)
+          {
+            c[e] = typename C::value_type(u, v, std::forward<Args>(args)...);
+          }
+
+        void erase(std::size_t) { }
+        void reserve(std::size_t) { }
+        void resize(std::size_t) { }
+        void clear() { }
+        void compact(const std::vector<std::size_t>&, std::size_t) { }
+      };
+
+    // The split store keeps the values in a separate array, indexed by edge
+    // handle, so that the records contain only the topology of the graph.
+    // Traversals that only follow edges read fewer cache lines. The value
+    // of an erased edge is reset to E{}, releasing any resources it holds,
+    // and the array is compacted with the edge pool.
+    template<typename E>
+      struct split_values
+      {
+        using record_value = empty_t;
+
+        template<typename C>
+          E& get(C&, std::size_t e) { return values[e]; }
+
+        template<typename C>
+          const E& get(const C&, std::size_t e) const { return values[e]; }
+
+        template<typename C, typename... Args>
+          std::size_t
+          insert(C& c, std::size_t u, std::size_t v, Args&&... args);
+
+        template<typename C, typename... Args>
+          void
+          assign(C& c, std::size_t e, std::size_t u, std::size_t v, Args&&... args)
+          {
+            c[e] = typename C::value_type(u, v);
+            values[e] = E(std::forward<Args>(args)...);
+          }
+
+        void erase(std::size_t e) { values[e] = E{}; }
+        void reserve(std::size_t n) { values.reserve(n); }
+        void resize(std::size_t n) { values.resize(n); }
+        void clear() { values.clear(); }
+
+        void compact(const std::vector<std::size_t>& map, std::size_t n)
+        {
+          compact_table(values, map, n);
+        }
+
+        std::vector<E> values;
+      };
+
+    template<typename E>
+      template<typename C, typename... Args>
+        inline std::size_t
+        split_values<E>::insert(C& c, std::size_t u, std::size_t v, Args&&... args)
+        {
+          std::size_t e = insert_record(c, u, v);
+          if (values.size() <= e)
+            values.resize(e + 1);
+          values[e] = E(std::forward<Args>(args)...);
+          return e;
+        }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
@@ -0,0 +1,294 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_NEIGHBOR_TABLE_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_NEIGHBOR_TABLE_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <vector>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                             Neighbor Table
+    //
+    // A neighbor table is a hash table mapping the neighbors of a vertex to
+    // an edge connecting the vertex to that neighbor. It is used to answer
+    // the edge relation g(u, v) in expected constant time when u has many
+    // incident edges.
+    //
+    // The table is open addressed with linear probing. Erasure shifts the
+    // following entries of the probe sequence backwards, so there are no
+    // tombstones. The table is grown when it is half full.
+    //
+    // Each entry also counts the edges connecting the vertex to the
+    // neighbor, so that the table remains correct for multigraphs. Only one
+    // of those edges is recorded. When that edge is erased while others
+    // remain, the caller is responsible for finding a replacement.
+    class neighbor_table
+    {
+    public:
+      static constexpr std::size_t npos = -1;
+
+      struct entry
+      {
+        std::size_t key;   // The neighbor, or npos if the entry is empty
+        std::size_t edge;  // An edge connecting the vertex to the neighbor
+        std::size_t count; // The number of such edges
+      };
+
+      neighbor_table() : size_(0) { }
+
+      // Observers
+      bool        empty() const    { return size_ == 0; }
+      std::size_t size() const     { return size_; }
+      std::size_t capacity() const { return slots_.size(); }
+
+      // Returns an edge connecting to the neighbor v, or npos if there is
+      // no such edge.
+      std::size_t find(std::size_t v) const;
+
+      // Returns the number of edges connecting to v.
+      std::size_t count(std::size_t v) const;
+
+      // Ensure that n neighbors can be inserted without growing the table.
+      void reserve(std::size_t n);
+
+      // Record an edge e connecting to the neighbor v.
+      void insert(std::size_t v, std::size_t e);
+
+      // Forget the edge e connecting to v. Returns true if other edges to v
+      // remain and e was the recorded edge, in which case a replacement
+      // must be given using replace().
+      bool erase(std::size_t v, std::size_t e);
+
+      // Replace the recorded edge connecting to v.
+      void replace(std::size_t v, std::size_t e);
+
+      // Remove all entries and release memory.
+      void clear();
+
+    private:
+      std::size_t mask() const { return slots_.size() - 1; }
+      std::size_t home(std::size_t v) const;
+      std::size_t probe(std::size_t v) const;
+      void rehash(std::size_t n);
+
+    private:
+      std::vector<entry> slots_;
+      std::size_t size_;
+    };
+
+    // Fibonacci hashing spreads consecutive vertex handles across the table.
+    inline std::size_t
+    neighbor_table::home(std::size_t v) const
+    {
+      return (std::uint64_t(v) * 0x9E3779B97F4A7C15ull >> 32) & mask();
+    }
+
+    // Returns the slot containing v or the empty slot where v would be
+    // inserted. The table must not be empty.
+    inline std::size_t
+    neighbor_table::probe(std::size_t v) const
+    {
+      std::size_t i = home(v);
+      while (slots_[i].key != npos && slots_[i].key != v)
+        i = (i + 1) & mask();
+      return i;
+    }
+
+    inline std::size_t
+    neighbor_table::find(std::size_t v) const
+    {
+      if (slots_.empty())
+        return npos;
+      const entry& x = slots_[probe(v)];
+      if (x.key != v)
+        return npos;
+      return x.edge;
+    }
+
+    inline std::size_t
+    neighbor_table::count(std::size_t v) const
+    {
+      if (slots_.empty())
+        return 0;
+      const entry& x = slots_[probe(v)];
+      if (x.key != v)
+        return 0;
+      return x.count;
+    }
+
+    inline void
+    neighbor_table::insert(std::size_t v, std::size_t e)
+    {
+      if (2 * (size_ + 1) > slots_.size())
+        rehash(std::max<std::size_t>(16, 2 * slots_.size()));
+      entry& x = slots_[probe(v)];
+      if (x.key == v) {
+        ++x.count;
+      } else {
+        x = {v, e, 1};
+        ++size_;
+      }
+    }
+
+    inline bool
+    neighbor_table::erase(std::size_t v, std::size_t e)
+    {
+      if (slots_.empty())
+        return false;
+      std::size_t i = probe(v);
+      entry& x = slots_[i];
+      if (x.key != v)
+        return false;
+      if (--x.count != 0)
+        return x.edge == e;
+
+      // Shift the following entries of the probe sequence backwards into
+      // the hole, unless their home lies cyclically in (i, j].
+      x.key = npos;
+      --size_;
+      std::size_t j = i;
+      while (true) {
+        j = (j + 1) & mask();
+        if (slots_[j].key == npos)
+          break;
+        std::size_t h = home(slots_[j].key);
+        if (((j - h) & mask()) >= ((j - i) & mask())) {
+          slots_[i] = slots_[j];
+          slots_[j].key = npos;
+          i = j;
+        }
+      }
+      return false;
+    }
+
+    inline void
+    neighbor_table::replace(std::size_t v, std::size_t e)
+    {
+      assert(!slots_.empty());
+      entry& x = slots_[probe(v)];
+      assert(x.key == v);
+      x.edge = e;
+    }
+
+    inline void
+    neighbor_table::clear()
+    {
+      std::vector<entry>().swap(slots_);
+      size_ = 0;
+    }
+
+    inline void
+    neighbor_table::reserve(std::size_t n)
+    {
+      std::size_t c = 16;
+      while (c < 2 * n)
+        c *= 2;
+      if (c > slots_.size())
+        rehash(c);
+    }
+
+    // Move the entries into a table of n slots, where n is a power of 2.
+    inline void
+    neighbor_table::rehash(std::size_t n)
+    {
+      std::vector<entry> old(n, entry{npos, npos, 0});
+      old.swap(slots_);
+      for (const entry& x : old) {
+        if (x.key != npos)
+          slots_[probe(x.key)] = x;
+      }
+    }
+
+    // ---------------------------------------------------------------------- //
+    //                             Neighbor Index
+    //
+    // The neighbor index is the set of neighbor tables of a graph, indexed by
+    // vertex. A vertex is indexed only after its table has been built, which
+    // the graph does when the degree of the vertex reaches a threshold.
+    // Updates to the edges of unindexed vertices are ignored.
+    class neighbor_index
+    {
+    public:
+      static constexpr std::size_t npos = neighbor_table::npos;
+
+      // Returns true if the vertex v has a neighbor table.
+      bool indexed(std::size_t v) const
+      {
+        return v < tables_.size() && tables_[v].capacity() != 0;
+      }
+
+      // Returns an edge connecting v to w, or npos. The vertex v must be
+      // indexed.
+      std::size_t find(std::size_t v, std::size_t w) const
+      {
+        assert(indexed(v));
+        return tables_[v].find(w);
+      }
+
+      // Create an empty neighbor table for v, with room for n neighbors.
+      void build(std::size_t v, std::size_t n);
+
+      // Record or forget the edge e connecting v to w. See neighbor_table.
+      void insert(std::size_t v, std::size_t w, std::size_t e);
+      bool erase(std::size_t v, std::size_t w, std::size_t e);
+      void replace(std::size_t v, std::size_t w, std::size_t e);
+
+      // Drop the table of v, or all tables.
+      void drop(std::size_t v);
+      void clear() { std::vector<neighbor_table>().swap(tables_); }
+
+    private:
+      std::vector<neighbor_table> tables_;
+    };
+
+    inline void
+    neighbor_index::build(std::size_t v, std::size_t n)
+    {
+      if (tables_.size() <= v)
+        tables_.resize(v + 1);
+      tables_[v].clear();
+      tables_[v].reserve(n);
+    }
+
+    inline void
+    neighbor_index::insert(std::size_t v, std::size_t w, std::size_t e)
+    {
+      if (indexed(v))
+        tables_[v].insert(w, e);
+    }
+
+    inline bool
+    neighbor_index::erase(std::size_t v, std::size_t w, std::size_t e)
+    {
+      return indexed(v) && tables_[v].erase(w, e);
+    }
+
+    inline void
+    neighbor_index::replace(std::size_t v, std::size_t w, std::size_t e)
+    {
+      tables_[v].replace(w, e);
+    }
+
+    inline void
+    neighbor_index::drop(std::size_t v)
+    {
+      if (v < tables_.size())
+        tables_[v].clear();
+    }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
@@ -5,12 +5,24 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_POOL_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_POOL_HPP
+
+#include <origin/graph/adjacency_list.impl/bitmap.hpp>
+
 namespace origin
 {
   namespace adjacency_list_impl
   {
-    template<typename T> class pool_node;
-    template<typename T> class pool_iterator;
+    // The default free index list is a min-queue of indices.
+    using min_queue = std::priority_queue<std::size_t,
+                                          std::vector<std::size_t>,
+                                          std::greater<std::size_t>>;
+
+    template<typename T, typename I = std::size_t> class pool_node;
+    template<typename T, typename Q = min_queue, typename I = std::size_t>
+      class pool_iterator;
+    template<typename Q> struct pool_scanner;
 
     // ---------------------------------------------------------------------- //
     //                                 Pool
@@ -25,7 +37,18 @@ namespace origin
     // the pool can be traversed in time proportional to the number of elements.
     // Traversal skips deleted elements by jumping over the "dead" locations in
     // the pool. This is done by creating a linked list rather than using a
-    // filtering technique.
+    // filtering technique. When the free index list is a bitmap, traversal
+    // scans the bitmap instead of following the links (see pool_scanner).
+    //
+    // The live elements can also be split into contiguous blocks of about
+    // the same size, so that a parallel loop can give each thread a block.
+    // Each block is traversed from seek(b[i]) until an index not less than
+    // b[i + 1] is reached.
+    //
+    // The pool never shrinks on its own: erased nodes remain in the node
+    // list until they are reused. The compact operation squeezes them out,
+    // renumbering the live nodes, and returns the mapping from old to new
+    // indexes.
     //
     // The data structure functions like normal vector until an object is
     // erased. When erased, the object is cleared, and its index is added to the
@@ -47,33 +70,47 @@ namespace origin
     //    - Erasure: O(log2 d)
     // Where d is the number of deleted nodes in the pool.
     //
+    // The free index list is a policy, given by the type parameter Q. Any
+    // min-queue of indices providing empty, size, top, push, and pop can be
+    // used. The default is a binary heap (std::priority_queue). Under heavy
+    // churn, the bitmap_queue is a better choice: its operations are
+    // O(log64 n) with no pointer chasing, and it never requires more than
+    // one bit per index in the pool.
+    //
     // This data structure has some similarity to conventional object pools
     // except that it doesn't really allocate memory, and it has additional
     // requirements. In particular, it must maintain the correspondence between
     // indices and the objects that they are mapped to. We also have to
     // provide efficient iteration over elements in the pool.
-    template<typename T>
+    //
+    // The node links are stored as indexes of type I, which bounds the number
+    // of nodes in the pool: the greatest value of I marks a dead node. The
+    // interface always uses std::size_t, and npos is size_t(-1).
+    template<typename T, typename Q = min_queue, typename I = std::size_t>
       class pool
       {
-        friend class pool_iterator<T>;
-        friend class pool_iterator<const T>;
+        friend class pool_iterator<T, Q, I>;
+        friend class pool_iterator<const T, Q, I>;
+        friend struct pool_scanner<Q>;
       public:
         using value_type = T;
-        using node_type = pool_node<T>;
+        using node_type = pool_node<T, I>;
 
-        using iterator       = pool_iterator<T>;
-        using const_iterator = pool_iterator<const T>;
+        using iterator       = pool_iterator<T, Q, I>;
+        using const_iterator = pool_iterator<const T, Q, I>;
 
         using list_type = std::vector<node_type>;
-        using queue_type = std::priority_queue<std::size_t, 
-                                               std::vector<std::size_t>, 
-                                               std::greater<size_t>>;
+        using queue_type = Q;
 
-        static constexpr std::size_t npos = node_type::npos;
+        static constexpr std::size_t npos = -1;
 
         // Observers
         bool empty() const;
         std::size_t size() const;
+        std::size_t bound() const;
+
+        // Returns true if n is the index of a live element.
+        bool contains(std::size_t n) const { return n < bound() && alive(n); }
 
         // Debugging and Testing
         // These are not part of the general interface. They are provided
@@ -98,6 +135,9 @@ namespace origin
         void erase(std::size_t x);
         void clear();
 
+        // Compaction
+        std::vector<std::size_t> compact();
+
         // Iterators
         iterator begin() { return iterator(this, head_); }
         iterator end()   { return iterator(this, npos); }
@@ -105,6 +145,14 @@ namespace origin
         const_iterator begin() const { return const_iterator(this, head_); }
         const_iterator end() const   { return const_iterator(this, npos); }
 
+        // Returns an iterator to the first live element whose index is not
+        // less than n.
+        iterator       seek(std::size_t n);
+        const_iterator seek(std::size_t n) const;
+
+        // Block iteration
+        std::vector<std::size_t> split(std::size_t k) const;
+
       private:
         // Node access and properties
         node_type&       node(std::size_t n)       { return nodes_[n]; }
@@ -153,65 +201,75 @@ namespace origin
 
       private:
 
-        list_type  nodes_; // The actual node vector
-        queue_type free_;  // The free index list
-        std::size_t head_; // Head of the live node list
-        std::size_t tail_; // Tail of the live node list
+        list_type  nodes_;        // The actual node vector
+        queue_type free_;         // The free index list
+        std::size_t head_ = npos; // Head of the live node list
+        std::size_t tail_ = npos; // Tail of the live node list
       };
 
+    template<typename T, typename Q, typename I>
+      constexpr std::size_t pool<T, Q, I>::npos;
+
     // Returns true if the pool contains no nodes.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline bool
-      pool<T>::empty() const { return size() == 0; }
+      pool<T, Q, I>::empty() const { return size() == 0; }
 
     // Returns the number of nodes contained in the pool.
-    template<typename T>
+    template<typename T, typename Q, typename I>
+      inline std::size_t
+      pool<T, Q, I>::size() const { return nodes_.size() - free_.size(); }
+
+    // Returns one past the greatest index ever allocated by the pool. Every
+    // live index is less than the bound, but not every index less than the
+    // bound is necessarily live.
+    template<typename T, typename Q, typename I>
       inline std::size_t
-      pool<T>::size() const { return nodes_.size() - free_.size(); }
+      pool<T, Q, I>::bound() const { return nodes_.size(); }
 
     // Returns the objects in the data pool.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline auto
-      pool<T>::data() const -> const list_type& { return nodes_; }
+      pool<T, Q, I>::data() const -> const list_type& { return nodes_; }
 
     // Returns the free index list.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline auto
-      pool<T>::free() const -> const queue_type& { return free_; }
+      pool<T, Q, I>::free() const -> const queue_type& { return free_; }
 
     // Returns the capacity allocated to the pool.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline std::size_t
-      pool<T>::capacity() const { return nodes_.capacity(); }
+      pool<T, Q, I>::capacity() const { return nodes_.capacity(); }
 
     // Reserve at least n objects of capacity.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline void
-      pool<T>::reserve(std::size_t n) { nodes_.reserve(n); }
+      pool<T, Q, I>::reserve(std::size_t n) { nodes_.reserve(n); }
 
     // Returns a reference to the element in the nth position. This function
     // results in undefined behavior if the element at the nth position has been
     // previously erased.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline T&
-      pool<T>::operator[](std::size_t n)
+      pool<T, Q, I>::operator[](std::size_t n)
       {
         assert(alive(n));
         return nodes_[n].get();
       }
 
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline const T&
-      pool<T>::operator[](std::size_t n) const
+      pool<T, Q, I>::operator[](std::size_t n) const
       {
         assert(alive(n));
         return nodes_[n].get();
       }
 
     // Move inser the value x into the pool.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline std::size_t
-      pool<T>::insert(T&& x)
+      pool<T, Q, I>::insert(T&& x)
       {
         if (free_.empty())
           return append(std::move(x));
@@ -221,9 +279,9 @@ namespace origin
 
     // Copy the value x into the vector. If there are dead indices, reuse
     // one. Otherwise, append the vertex.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline std::size_t
-      pool<T>::insert(const T& x)
+      pool<T, Q, I>::insert(const T& x)
       {
         if (free_.empty())
           return append(x);
@@ -231,10 +289,10 @@ namespace origin
           return reuse(x);
       }
 
-    template<typename T>
+    template<typename T, typename Q, typename I>
       template<typename... Args>
       inline std::size_t
-      pool<T>::emplace(Args&&... args)
+      pool<T, Q, I>::emplace(Args&&... args)
       {
         if (free_.empty())
           return append(std::forward<Args>(args)...);
@@ -246,12 +304,13 @@ namespace origin
 
     // Insert the value x at the end of the node list, returning the index
     // at which the object was stored.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       template<typename... Args>
         inline std::size_t
-        pool<T>::append(Args&&... args)
+        pool<T, Q, I>::append(Args&&... args)
         {
           std::size_t n = nodes_.size();
+          assert(n < std::size_t(node_type::npos));
           if (nodes_.empty())
             append_empty(std::forward<Args>(args)...);
           else
@@ -261,10 +320,10 @@ namespace origin
 
     // Insert the value x into the front of the node list. This happens only
     // when the pool is completely empty.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       template<typename... Args>
         inline void
-        pool<T>::append_empty(Args&&... args)
+        pool<T, Q, I>::append_empty(Args&&... args)
         {
           nodes_.emplace_back(0, 0, std::forward<Args>(args)...);
           head_ = 0;
@@ -279,10 +338,10 @@ namespace origin
     // Here, h is followed by 0 or more live nodes, and we are inserting into
     // x. There are no free indexes in the pool. Note that n == nodes_.size(),
     // whichn is the index of x.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       template<typename... Args>
         inline void
-        pool<T>::append_nonempty(std::size_t n, Args&&... args)
+        pool<T, Q, I>::append_nonempty(std::size_t n, Args&&... args)
         {
           nodes_.emplace_back(tail_, n, std::forward<Args>(args)...);
           tail().next = n;
@@ -291,10 +350,10 @@ namespace origin
 
 
     // Reuse a free index to store the object x.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       template<typename... Args>
         inline std::size_t
-        pool<T>::reuse(Args&&... args)
+        pool<T, Q, I>::reuse(Args&&... args)
         {
           std::size_t n = take();
           if (n == 0)
@@ -317,10 +376,10 @@ namespace origin
     // There is a special case when there are no live nodes. Here, we simply
     // overwrite the initial element. Here, we make p the both the head and
     // the tail.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       template<typename... Args>
         inline void
-        pool<T>::reuse_front(Args&&... args)
+        pool<T, Q, I>::reuse_front(Args&&... args)
         {
           node_type& p = node(0);
           if (head_ != npos) {
@@ -345,10 +404,10 @@ namespace origin
     // number of live objects. Note that the node at n - 1 is always a live
     // object, q. Otherwise, n would not be the least free index. The next
     // live object, r, is directly accessible from q.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       template<typename... Args>
         inline void
-        pool<T>::reuse_middle(std::size_t n, Args&&... args)
+        pool<T, Q, I>::reuse_middle(std::size_t n, Args&&... args)
         {
           node_type& p = node(n);
           node_type& q = node(n - 1);
@@ -368,10 +427,10 @@ namespace origin
     // other words, there are no free indexes before t. The case where h == t is
     // also possible. Second, it is always the case that n == t + 1 (I'm not
     // sure what that knowledge buys me though).
-    template<typename T>
+    template<typename T, typename Q, typename I>
       template<typename... Args>
         inline void
-        pool<T>::reuse_end(std::size_t n, Args&&... args)
+        pool<T, Q, I>::reuse_end(std::size_t n, Args&&... args)
         {
           node_type& p = node(n);
           p.assign(tail_, n, std::forward<Args>(args)...);
@@ -380,9 +439,9 @@ namespace origin
         }
 
     // Take the next free index from the free list.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline std::size_t
-      pool<T>::take()
+      pool<T, Q, I>::take()
       {
         std::size_t n = free_.top();
         free_.pop();
@@ -391,9 +450,9 @@ namespace origin
 
     // Erase the element at the nth position in the pool, returning the index
     // n to the free list. If that element is not alive, do nothing.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline void
-      pool<T>::erase(std::size_t n)
+      pool<T, Q, I>::erase(std::size_t n)
       {
         assert(n < nodes_.size());
         if (alive(n)) {
@@ -402,9 +461,9 @@ namespace origin
       }
 
     // Reset the node at the nth position, depending on the value of n.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline void
-      pool<T>::reset(std::size_t n)
+      pool<T, Q, I>::reset(std::size_t n)
       {
         if (n == head_)
           reset_head(n);
@@ -428,9 +487,9 @@ namespace origin
     //
     // There is a special case when h == t, corresponding to the erasure of
     // the last live node. Both h and t are set to npos.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline void
-      pool<T>::reset_head(std::size_t n)
+      pool<T, Q, I>::reset_head(std::size_t n)
       {
         if (head_ != tail_) {
           node_type& p = next(head());
@@ -450,9 +509,9 @@ namespace origin
     // Note that there must be a previous element. If there is not, then
     // we must be removing the head, which is handled by reset_head. The 
     // previous live node is made the new tail.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline void
-      pool<T>::reset_tail(std::size_t n)
+      pool<T, Q, I>::reset_tail(std::size_t n)
       {
         node_type& p = prev(tail());
         p.next = tail().prev;
@@ -464,9 +523,9 @@ namespace origin
     //
     // Note that both the next and previos nodes must be valid. If not, the
     // node at the nth position would be either the head or the tail.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline void
-      pool<T>::reset_middle(std::size_t n)
+      pool<T, Q, I>::reset_middle(std::size_t n)
       {
         node_type& p = node(n); 
         prev(p).next = p.next;
@@ -476,23 +535,77 @@ namespace origin
 
     // Finally destroy the node at the nth position and return its index to the
     // free index list.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline void
-      pool<T>::recycle(std::size_t n)
+      pool<T, Q, I>::recycle(std::size_t n)
       {
         node(n).reset();
         free_.push(n);
       }
 
     // Reset the pool to its initial state.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline void
-      pool<T>::clear()
+      pool<T, Q, I>::clear()
       {
         // std::priority_queue does not have clear() method, so we have to
         // reset it by brute force.
         free_ = std::move(queue_type());
         nodes_.clear();
+        head_ = tail_ = npos;
+      }
+
+    // Move the live elements of the pool to the front of the node list, in
+    // order, and release the storage held by dead nodes. The free list is
+    // emptied. The result maps each old index to its new index; the indexes
+    // of dead nodes are mapped to npos.
+    template<typename T, typename Q, typename I>
+      std::vector<std::size_t>
+      pool<T, Q, I>::compact()
+      {
+        std::vector<std::size_t> map(bound(), npos);
+        list_type nodes;
+        nodes.reserve(size());
+        for (auto i = begin(); i != end(); ++i) {
+          std::size_t n = i.index();
+          std::size_t k = nodes.size();
+          map[n] = k;
+          nodes.emplace_back(k == 0 ? 0 : k - 1, k + 1, std::move(node(n).get()));
+        }
+        if (!nodes.empty())
+          nodes.back().next = nodes.size() - 1;
+
+        nodes_.swap(nodes);
+        free_ = std::move(queue_type());
+        head_ = nodes_.empty() ? npos : 0;
+        tail_ = nodes_.empty() ? npos : nodes_.size() - 1;
+        return map;
+      }
+
+    template<typename T, typename Q, typename I>
+      inline auto
+      pool<T, Q, I>::seek(std::size_t n) -> iterator
+      {
+        return iterator(this, pool_scanner<Q>::find(*this, n));
+      }
+
+    template<typename T, typename Q, typename I>
+      inline auto
+      pool<T, Q, I>::seek(std::size_t n) const -> const_iterator
+      {
+        return const_iterator(this, pool_scanner<Q>::find(*this, n));
+      }
+
+    // Split the live elements of the pool into k contiguous blocks containing
+    // about the same number of elements, for the purpose of parallel
+    // iteration. The result is a sequence of k + 1 indexes, b, such that the
+    // ith block contains the live elements with indexes in [b[i], b[i + 1]).
+    template<typename T, typename Q, typename I>
+      inline std::vector<std::size_t>
+      pool<T, Q, I>::split(std::size_t k) const
+      {
+        assert(k != 0);
+        return pool_scanner<Q>::split(*this, k);
       }
 
 
@@ -504,12 +617,12 @@ namespace origin
     // pool. The data buffer stores a possibly initialized value.
     //
     // A node is uninitialized when either of prev or next is the same as
-    // limit (i.e., size_t(-1)).
-    template<typename T>
+    // limit (i.e., I(-1)).
+    template<typename T, typename I>
       class pool_node
       {
       public:
-        static constexpr std::size_t npos = -1;
+        static constexpr I npos = -1;
 
         pool_node();
 
@@ -517,6 +630,14 @@ namespace origin
         template<typename... Args>
           pool_node(std::size_t p, std::size_t n, Args&&... args);
 
+        // Copy and move semantics
+        // The stored object is copied or moved only if it is initialized.
+        pool_node(const pool_node& x);
+        pool_node(pool_node&& x)
+          noexcept(std::is_nothrow_move_constructible<T>::value);
+
+        pool_node& operator=(const pool_node& x);
+        pool_node& operator=(pool_node&& x);
 
         ~pool_node();
 
@@ -540,76 +661,124 @@ namespace origin
         void reset();
         void destroy();
 
-        std::size_t prev;
-        std::size_t next;
+        I prev;
+        I next;
         Aligned_storage<sizeof(T), alignof(T)> data;
       };
 
-    template<typename T>
-      pool_node<T>::pool_node() : prev(npos), next(npos) { }
+    template<typename T, typename I>
+      constexpr I pool_node<T, I>::npos;
 
-    template<typename T>
+    template<typename T, typename I>
+      pool_node<T, I>::pool_node() : prev(npos), next(npos) { }
+
+    template<typename T, typename I>
       template<typename... Args>
-        pool_node<T>::pool_node(std::size_t p, std::size_t n, Args&&... args)
+        pool_node<T, I>::pool_node(std::size_t p, std::size_t n, Args&&... args)
           : prev(p), next(n)
         {
           new (&data) T(std::forward<Args>(args)...);
         }
 
-    template<typename T>
-      pool_node<T>::~pool_node() { destroy(); }
+    template<typename T, typename I>
+      pool_node<T, I>::pool_node(const pool_node& x)
+        : prev(x.prev), next(x.next)
+      {
+        if (x.valid())
+          new (&data) T(x.get());
+      }
 
-    template<typename T>
+    template<typename T, typename I>
+      pool_node<T, I>::pool_node(pool_node&& x)
+        noexcept(std::is_nothrow_move_constructible<T>::value)
+        : prev(x.prev), next(x.next)
+      {
+        if (x.valid())
+          new (&data) T(std::move(x.get()));
+      }
+
+    template<typename T, typename I>
+      inline pool_node<T, I>&
+      pool_node<T, I>::operator=(const pool_node& x)
+      {
+        if (this != &x) {
+          destroy();
+          prev = x.prev;
+          next = x.next;
+          if (x.valid())
+            new (&data) T(x.get());
+        }
+        return *this;
+      }
+
+    template<typename T, typename I>
+      inline pool_node<T, I>&
+      pool_node<T, I>::operator=(pool_node&& x)
+      {
+        if (this != &x) {
+          destroy();
+          prev = x.prev;
+          next = x.next;
+          if (x.valid())
+            new (&data) T(std::move(x.get()));
+        }
+        return *this;
+      }
+
+    template<typename T, typename I>
+      pool_node<T, I>::~pool_node() { destroy(); }
+
+    template<typename T, typename I>
       inline bool
-      pool_node<T>::valid() const { return next != npos; }
+      pool_node<T, I>::valid() const { return next != npos; }
 
-    template<typename T>
+    template<typename T, typename I>
       inline T*
-      pool_node<T>::ptr() 
+      pool_node<T, I>::ptr() 
       { 
         assert(valid());
         return reinterpret_cast<T*>(&data); 
       }
 
-    template<typename T>
+    template<typename T, typename I>
       inline const T*
-      pool_node<T>::ptr() const 
+      pool_node<T, I>::ptr() const 
       { 
         assert(valid());
         return reinterpret_cast<const T*>(&data); 
       }
 
-    template<typename T>
+    template<typename T, typename I>
       inline T&
-      pool_node<T>::get() { return *ptr(); }
+      pool_node<T, I>::get() { return *ptr(); }
 
-    template<typename T>
+    template<typename T, typename I>
       inline const T&
-      pool_node<T>::get() const { return *ptr(); }
+      pool_node<T, I>::get() const { return *ptr(); }
 
-    template<typename T>
+    template<typename T, typename I>
       template<typename... Args>
         inline void
-        pool_node<T>::assign(std::size_t p, std::size_t n, Args&&... args)
+        pool_node<T, I>::assign(std::size_t p, std::size_t n, Args&&... args)
         {
+          destroy();
           prev = p;
           next = n;
-          destroy();
           new (&data) T(std::forward<Args>(args)...);
         }
 
-    template<typename T>
+    template<typename T, typename I>
       inline void
-      pool_node<T>::reset()
+      pool_node<T, I>::reset()
       {
         assert(valid());
         get().~T();
         prev = next = npos;
       }
 
-    template<typename T>
+    template<typename T, typename I>
       inline void
-      pool_node<T>::destroy()
+      pool_node<T, I>::destroy()
       {
         if (valid())
           get().~T();
@@ -627,20 +796,22 @@ namespace origin
     // so that we can decrement it to reach the last element. Because the
     // current implementation uses a self-looped link to terminate the live
     // node list, we can't effectively define an "end" position.
-    template<typename T>
+    template<typename T, typename Q, typename I>
       class pool_iterator
       {
       public:
         using value_type = Remove_const<T>;
-        using pool_type = If<Const<T>(), const pool<value_type>, pool<value_type>>;
-        using node_type = If<Const<T>(), const pool_node<value_type>, pool_node<value_type>>;
+        using pool_type =
+          If<Const<T>(), const pool<value_type, Q, I>, pool<value_type, Q, I>>;
+        using node_type =
+          If<Const<T>(), const pool_node<value_type, I>, pool_node<value_type, I>>;
 
         pool_iterator();
         pool_iterator(pool_type* p, std::size_t i);
 
         // Const conversion.
         template<typename U>
-          pool_iterator(const pool_iterator<U>& x)
+          pool_iterator(const pool_iterator<U, Q, I>& x)
             : p_(x.container()), i_(x.index())
           { }
 
@@ -667,71 +838,187 @@ namespace origin
         std::size_t i_; // The current index
       };
 
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline
-      pool_iterator<T>::pool_iterator()
+      pool_iterator<T, Q, I>::pool_iterator()
         : p_(nullptr), i_(-1)
       { }
 
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline
-      pool_iterator<T>::pool_iterator(pool_type* p, std::size_t i)
+      pool_iterator<T, Q, I>::pool_iterator(pool_type* p, std::size_t i)
         : p_(p), i_(i)
       { }
 
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline T&
-      pool_iterator<T>::operator*() const
+      pool_iterator<T, Q, I>::operator*() const
       {
         return p_->node(i_).get();
       }
 
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline T*
-      pool_iterator<T>::operator->() const
+      pool_iterator<T, Q, I>::operator->() const
       {
         return p_->node(i_).get();
       }
 
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline bool
-      pool_iterator<T>::operator==(const pool_iterator& x) const
+      pool_iterator<T, Q, I>::operator==(const pool_iterator& x) const
       {
         assert(p_ == x.p_);
         return i_ == x.i_;
       }
 
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline bool
-      pool_iterator<T>::operator!=(const pool_iterator& x) const
+      pool_iterator<T, Q, I>::operator!=(const pool_iterator& x) const
       {
         return !operator==(x);
       }
 
-    template<typename T>
-      inline pool_iterator<T>&
-      pool_iterator<T>::operator++()
+    template<typename T, typename Q, typename I>
+      inline pool_iterator<T, Q, I>&
+      pool_iterator<T, Q, I>::operator++()
       {
         incr();
         return *this;
       }
 
-    template<typename T>
-      inline pool_iterator<T>
-      pool_iterator<T>::operator++(int)
+    template<typename T, typename Q, typename I>
+      inline pool_iterator<T, Q, I>
+      pool_iterator<T, Q, I>::operator++(int)
       {
         pool_iterator tmp = *this;
         incr();
         return tmp;
       }
 
-    template<typename T>
+    template<typename T, typename Q, typename I>
       inline void
-      pool_iterator<T>::incr() 
+      pool_iterator<T, Q, I>::incr() 
       {
-        const node_type& n = p_->node(i_);
-        i_ = (n.next == i_ ? pool_node<T>::npos : n.next);
+        i_ = pool_scanner<Q>::next(*p_, i_);
       }
 
+
+    // ---------------------------------------------------------------------- //
+    //                              Pool Scanner
+    //
+    // The pool scanner finds the live nodes of a pool during iteration. The
+    // scanner depends on the pool's free index list. By default, the scanner
+    // follows the list of live nodes embedded in the pool. Each step is a
+    // dependent load of a node that may be anywhere in the pool.
+    template<typename Q>
+      struct pool_scanner
+      {
+        // Returns the index of the first live node not less than n, or npos
+        // if there is no such node.
+        template<typename P>
+          static std::size_t
+          find(const P& p, std::size_t n)
+          {
+            while (n < p.bound() && !p.alive(n))
+              ++n;
+            return n < p.bound() ? n : P::npos;
+          }
+
+        // Returns the index of the live node following n, or npos if n is
+        // the last live node.
+        template<typename P>
+          static std::size_t
+          next(const P& p, std::size_t n)
+          {
+            const typename P::node_type& x = p.node(n);
+            return x.next == n ? P::npos : x.next;
+          }
+
+        // Split the live nodes into k blocks by walking the live node list.
+        template<typename P>
+          static std::vector<std::size_t>
+          split(const P& p, std::size_t k)
+          {
+            std::vector<std::size_t> b(1, 0);
+            std::size_t m = 0;
+            for (std::size_t n = p.head_; n != P::npos; n = next(p, n)) {
+              if (b.size() < k && m * k >= b.size() * p.size())
+                b.push_back(n);
+              ++m;
+            }
+            b.resize(k + 1, p.bound());
+            return b;
+          }
+      };
+
+    // When the free index list is a bitmap, the scanner finds live nodes by
+    // scanning the complement of the bitmap a word at a time, so the node
+    // links are never read. Each step also prefetches the following live
+    // node in the same word, so that its memory is being loaded while the
+    // current node is visited.
+    template<>
+      struct pool_scanner<bitmap_queue>
+      {
+        using word_type = bitmap_queue::word_type;
+        static constexpr std::size_t word_bits = bitmap_queue::word_bits;
+
+        // Returns the word of live bits at the index w.
+        template<typename P>
+          static word_type
+          live_word(const P& p, std::size_t w)
+          {
+            const bitmap_queue::word_list& dead = p.free().words();
+            word_type x = w < dead.size() ? ~dead[w] : ~word_type(0);
+            std::size_t r = p.bound() - w * word_bits;
+            if (r < word_bits)
+              x &= (word_type(1) << r) - 1;
+            return x;
+          }
+
+        template<typename P>
+          static std::size_t
+          find(const P& p, std::size_t n)
+          {
+            if (n >= p.bound())
+              return P::npos;
+            std::size_t w = n / word_bits;
+            word_type x = live_word(p, w) & (~word_type(0) << (n % word_bits));
+            while (x == 0) {
+              if (++w * word_bits >= p.bound())
+                return P::npos;
+              x = live_word(p, w);
+            }
+            n = w * word_bits + __builtin_ctzll(x);
+            x &= x - 1;
+            if (x != 0)
+              __builtin_prefetch(&p.node(w * word_bits + __builtin_ctzll(x)));
+            return n;
+          }
+
+        template<typename P>
+          static std::size_t
+          next(const P& p, std::size_t n) { return find(p, n + 1); }
+
+        // Split the live nodes into k blocks by counting the live bits in
+        // each word. Block boundaries are aligned to words.
+        template<typename P>
+          static std::vector<std::size_t>
+          split(const P& p, std::size_t k)
+          {
+            std::vector<std::size_t> b(1, 0);
+            std::size_t m = 0;
+            for (std::size_t w = 0; w * word_bits < p.bound(); ++w) {
+              while (b.size() < k && m * k >= b.size() * p.size())
+                b.push_back(w * word_bits);
+              m += __builtin_popcountll(live_word(p, w));
+            }
+            b.resize(k + 1, p.bound());
+            return b;
+          }
+      };
+
   } // namespace adjacency_list_impl
 } // namespace origin
+
+#endif
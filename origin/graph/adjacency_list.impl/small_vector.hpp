@@ -0,0 +1,310 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_SMALL_VECTOR_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_SMALL_VECTOR_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <type_traits>
+
+#include <origin/type/traits.hpp>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                              Small Vector
+    //
+    // A small vector is a sequence of trivially copyable objects that stores
+    // up to N elements inside the object itself, and only allocates memory
+    // when it grows beyond N elements. It is used as the incidence list of
+    // vertices in graphs where most vertices have a small degree, since each
+    // such vertex then requires no allocations at all.
+    //
+    // The inline buffer shares storage with the pointer to the allocated
+    // buffer, and the size and capacity are 32-bit integers, so a small
+    // vector of two edge handles is no larger than a std::vector. Once a
+    // small vector has allocated memory, it only returns to the inline
+    // buffer through shrink_to_fit().
+    //
+    // The small vector supports the subset of the vector interface that is
+    // used by the graph data structures. Iterators are pointers, and they
+    // are invalidated by any operation that changes the capacity.
+    template<typename T, std::size_t N>
+      class small_vector
+      {
+        static_assert(N > 0, "small vector requires an inline capacity");
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "small vector requires trivially copyable elements");
+      public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        static constexpr std::size_t inline_capacity = N;
+
+        small_vector();
+        small_vector(const small_vector& x);
+        small_vector(small_vector&& x) noexcept;
+
+        small_vector& operator=(const small_vector& x);
+        small_vector& operator=(small_vector&& x) noexcept;
+
+        ~small_vector();
+
+        // Observers
+        bool        empty() const    { return size_ == 0; }
+        std::size_t size() const     { return size_; }
+        std::size_t capacity() const { return cap_; }
+
+        // Returns true if the elements are stored in the inline buffer.
+        bool is_inline() const { return cap_ == N; }
+
+        // Element access
+        T*       data()       { return is_inline() ? local() : heap_; }
+        const T* data() const { return is_inline() ? local() : heap_; }
+
+        T&       operator[](std::size_t n)       { return data()[n]; }
+        const T& operator[](std::size_t n) const { return data()[n]; }
+
+        T&       front()       { return *begin(); }
+        const T& front() const { return *begin(); }
+
+        T&       back()       { return *(end() - 1); }
+        const T& back() const { return *(end() - 1); }
+
+        // Capacity
+        void reserve(std::size_t n);
+        void shrink_to_fit();
+
+        // Modifiers
+        void push_back(const T& x);
+        void pop_back();
+
+        iterator insert(const_iterator i, const T& x);
+
+        iterator erase(const_iterator i);
+        iterator erase(const_iterator first, const_iterator last);
+
+        void clear() { size_ = 0; }
+
+        // Iterators
+        iterator begin() { return data(); }
+        iterator end()   { return data() + size_; }
+
+        const_iterator begin() const { return data(); }
+        const_iterator end() const   { return data() + size_; }
+
+      private:
+        T*       local()       { return reinterpret_cast<T*>(&buf_); }
+        const T* local() const { return reinterpret_cast<const T*>(&buf_); }
+
+        void assign(const small_vector& x);
+        void steal(small_vector& x);
+        void release();
+
+      private:
+        std::uint32_t size_; // The number of elements
+        std::uint32_t cap_;  // The capacity, equal to N when inline
+        union {
+          T* heap_;          // The allocated buffer, when not inline
+          Aligned_storage<sizeof(T) * N, alignof(T)> buf_;
+        };
+      };
+
+    template<typename T, std::size_t N>
+      constexpr std::size_t small_vector<T, N>::inline_capacity;
+
+    template<typename T, std::size_t N>
+      inline
+      small_vector<T, N>::small_vector()
+        : size_(0), cap_(N)
+      { }
+
+    template<typename T, std::size_t N>
+      inline
+      small_vector<T, N>::small_vector(const small_vector& x)
+        : size_(0), cap_(N)
+      {
+        assign(x);
+      }
+
+    template<typename T, std::size_t N>
+      inline
+      small_vector<T, N>::small_vector(small_vector&& x) noexcept
+        : size_(0), cap_(N)
+      {
+        steal(x);
+      }
+
+    template<typename T, std::size_t N>
+      inline small_vector<T, N>&
+      small_vector<T, N>::operator=(const small_vector& x)
+      {
+        if (this != &x) {
+          clear();
+          assign(x);
+        }
+        return *this;
+      }
+
+    template<typename T, std::size_t N>
+      inline small_vector<T, N>&
+      small_vector<T, N>::operator=(small_vector&& x) noexcept
+      {
+        if (this != &x) {
+          release();
+          steal(x);
+        }
+        return *this;
+      }
+
+    template<typename T, std::size_t N>
+      inline
+      small_vector<T, N>::~small_vector() { release(); }
+
+    // Copy the elements of x into this empty vector.
+    template<typename T, std::size_t N>
+      inline void
+      small_vector<T, N>::assign(const small_vector& x)
+      {
+        reserve(x.size());
+        std::memcpy(data(), x.data(), x.size() * sizeof(T));
+        size_ = x.size_;
+      }
+
+    // Take the elements of x, leaving it empty. This vector must not own an
+    // allocated buffer.
+    template<typename T, std::size_t N>
+      inline void
+      small_vector<T, N>::steal(small_vector& x)
+      {
+        if (x.is_inline()) {
+          std::memcpy(local(), x.local(), x.size() * sizeof(T));
+        } else {
+          heap_ = x.heap_;
+          cap_ = x.cap_;
+          x.cap_ = N;
+        }
+        size_ = x.size_;
+        x.size_ = 0;
+      }
+
+    // Release the allocated buffer, if any, and return to the inline buffer.
+    template<typename T, std::size_t N>
+      inline void
+      small_vector<T, N>::release()
+      {
+        if (!is_inline())
+          delete[] reinterpret_cast<char*>(heap_);
+        size_ = 0;
+        cap_ = N;
+      }
+
+    // Ensure that the vector can store n elements without reallocating. The
+    // capacity at least doubles when the vector grows.
+    template<typename T, std::size_t N>
+      void
+      small_vector<T, N>::reserve(std::size_t n)
+      {
+        if (n <= cap_)
+          return;
+        assert(n <= UINT32_MAX);
+        std::size_t c = std::max<std::size_t>(n, 2 * std::size_t(cap_));
+        c = std::min<std::size_t>(c, UINT32_MAX);
+        T* p = reinterpret_cast<T*>(new char[c * sizeof(T)]);
+        std::memcpy(p, data(), size_ * sizeof(T));
+        std::uint32_t s = size_;
+        release();
+        heap_ = p;
+        cap_ = c;
+        size_ = s;
+      }
+
+    // Return to the inline buffer if the elements fit.
+    template<typename T, std::size_t N>
+      void
+      small_vector<T, N>::shrink_to_fit()
+      {
+        if (is_inline() || size_ > N)
+          return;
+        T* p = heap_;
+        std::memcpy(local(), p, size_ * sizeof(T));
+        delete[] reinterpret_cast<char*>(p);
+        cap_ = N;
+      }
+
+    template<typename T, std::size_t N>
+      inline void
+      small_vector<T, N>::push_back(const T& x)
+      {
+        if (size_ == cap_) {
+          T y = x; // x may refer to an element of this vector
+          reserve(size_ + 1);
+          new (data() + size_) T(y);
+        } else {
+          new (data() + size_) T(x);
+        }
+        ++size_;
+      }
+
+    template<typename T, std::size_t N>
+      inline void
+      small_vector<T, N>::pop_back()
+      {
+        assert(!empty());
+        --size_;
+      }
+
+    // Insert x before the element at i, shifting the elements that follow
+    // toward the back of the vector.
+    template<typename T, std::size_t N>
+      inline auto
+      small_vector<T, N>::insert(const_iterator i, const T& x) -> iterator
+      {
+        std::size_t n = i - begin();
+        T y = x; // x may refer to an element of this vector
+        reserve(size_ + 1);
+        T* p = begin() + n;
+        std::memmove(p + 1, p, (size_ - n) * sizeof(T));
+        new (p) T(y);
+        ++size_;
+        return p;
+      }
+
+    template<typename T, std::size_t N>
+      inline auto
+      small_vector<T, N>::erase(const_iterator i) -> iterator
+      {
+        return erase(i, i + 1);
+      }
+
+    // Erase the elements in [first, last), shifting the elements that follow
+    // toward the front of the vector.
+    template<typename T, std::size_t N>
+      inline auto
+      small_vector<T, N>::erase(const_iterator first, const_iterator last)
+        -> iterator
+      {
+        T* f = begin() + (first - begin());
+        std::memmove(f, last, (end() - last) * sizeof(T));
+        size_ -= last - first;
+        return f;
+      }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
@@ -0,0 +1,73 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_SORTED_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_SORTED_HPP
+
+#include <algorithm>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                            Sorted Incidence
+    //
+    // These functions maintain and search incidence lists that are ordered
+    // by a key, which is the opposite endpoint of each edge. The key function
+    // k maps an edge handle to its key. Edges with equal keys are kept in
+    // the order in which they were inserted, so the first edge found for a
+    // key is the oldest edge connecting to that vertex.
+
+    // Insert the edge e, whose key is x, after all edges whose key is not
+    // greater than x.
+    template<typename L, typename H, typename K>
+      inline void
+      insert_sorted(L& seq, H e, std::size_t x, K k)
+      {
+        auto i = std::upper_bound(seq.begin(), seq.end(), x,
+                                  [&k](std::size_t a, H b) { return a < k(b); });
+        seq.insert(i, e);
+      }
+
+    // Returns an iterator to the first edge whose key is x, or the end of
+    // seq if there is no such edge.
+    template<typename L, typename K>
+      inline auto
+      find_sorted(const L& seq, std::size_t x, K k) -> decltype(seq.begin())
+      {
+        using H = typename L::value_type;
+        auto i = std::lower_bound(seq.begin(), seq.end(), x,
+                                  [&k](H a, std::size_t b) { return k(a) < b; });
+        return (i != seq.end() && k(*i) == x) ? i : seq.end();
+      }
+
+    // Order seq by key. The sort is stable, so edges with equal keys keep
+    // their relative order. In particular, the two entries of a loop in an
+    // undirected graph remain adjacent.
+    template<typename L, typename K>
+      inline void
+      sort_incidence(L& seq, K k)
+      {
+        using H = typename L::value_type;
+        std::stable_sort(seq.begin(), seq.end(),
+                         [&k](H a, H b) { return k(a) < k(b); });
+      }
+
+    // Returns true if the key x is not less than that of the last edge in
+    // seq, so that appending an edge with key x keeps seq ordered.
+    template<typename L, typename K>
+      inline bool
+      extends_sorted(const L& seq, std::size_t x, K k)
+      {
+        return seq.empty() || k(seq.back()) <= x;
+      }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
@@ -0,0 +1,184 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Traits that index every vertex with many out edges.
+struct tiny_hash_traits : hashed_adjacency_list_traits
+{
+  static constexpr std::size_t hash_threshold = 4;
+};
+
+using endpoints = pair<size_t, size_t>;
+
+// Returns the number of edges connecting each pair of endpoints.
+template<typename G>
+  map<endpoints, size_t>
+  edge_counts(const G& g)
+  {
+    map<endpoints, size_t> m;
+    for (auto e : g.edges())
+      ++m[endpoints(g.source(e), g.target(e))];
+    return m;
+  }
+
+// Check that the incidence lists of g agree with its edges, that sorted
+// lists are sorted, and that the edge relation finds every edge.
+template<typename G>
+  void
+  check_structure(const G& g)
+  {
+    size_t outs = 0, ins = 0;
+    for (auto v : g.vertices()) {
+      size_t last = 0;
+      for (auto e : g.out_edges(v)) {
+        assert(g.source(e) == v);
+        assert(!g.sorted() || last <= size_t(g.target(e)));
+        last = g.target(e);
+        ++outs;
+      }
+      last = 0;
+      for (auto e : g.in_edges(v)) {
+        assert(g.target(e) == v);
+        assert(!g.sorted() || last <= size_t(g.source(e)));
+        last = g.source(e);
+        ++ins;
+      }
+    }
+    assert(outs == g.size() && ins == g.size());
+    for (auto e : g.edges())
+      assert(g(g.source(e), g.target(e)));
+  }
+
+// Apply random batches to g, and the same operations one at a time to h.
+// Insertions and removals of the same endpoints are not mixed within a
+// batch, so both graphs have the same edges.
+template<typename G>
+  void
+  check_random_batches()
+  {
+    cout << "*** random batches (" << typestr<G>() << ") ***\n";
+    using V = Vertex<G>;
+    minstd_rand gen;
+    size_t n = 40;
+    G g = build_n_graph<G>(n);
+    G h = build_n_graph<G>(n);
+    for (size_t round = 0; round < 30; ++round) {
+      mutation_batch<G> b(g);
+      map<endpoints, bool> inserting;
+      vector<tuple<size_t, size_t, int>> added;
+      for (size_t i = 0; i < 400; ++i) {
+        size_t u = gen() % n, v = gen() % (n / 2);
+        auto p = inserting.emplace(endpoints(u, v), gen() % 3 != 0);
+        if (p.first->second) {
+          int x = gen() % 1000;
+          b.add_edge(V(u), V(v), x);
+          h.add_edge(V(u), V(v), x);
+          added.emplace_back(u, v, x);
+        } else if (gen() % 4 == 0) {
+          b.remove_edges(V(u), V(v));
+          h.remove_edges(V(u), V(v));
+        } else {
+          b.remove_edge(V(u), V(v));
+          h.remove_edge(V(u), V(v));
+        }
+      }
+      assert(b.size() == 400);
+      auto es = b.apply();
+      assert(b.empty() && es.size() == added.size());
+      for (size_t i = 0; i < es.size(); ++i) {
+        assert(g.source(es[i]) == V(get<0>(added[i])));
+        assert(g.target(es[i]) == V(get<1>(added[i])));
+        assert(g(es[i]) == get<2>(added[i]));
+      }
+      assert(g.size() == h.size());
+      assert(edge_counts(g) == edge_counts(h));
+      check_structure(g);
+
+      // Single removals still work on the updated lists.
+      for (size_t i = 0; i < 5 && !g.empty(); ++i) {
+        auto e = *g.edges().begin();
+        auto u = g.source(e), v = g.target(e);
+        g.remove_edge(e);
+        h.remove_edge(h(u, v));
+      }
+      check_structure(g);
+    }
+  }
+
+// Insertions and removals of the same endpoints within a batch cancel.
+template<typename G>
+  void
+  check_cancellation()
+  {
+    cout << "*** batch cancellation (" << typestr<G>() << ") ***\n";
+    using V = Vertex<G>;
+    G g = build_n_graph<G>(4);
+    g.add_edge(V(0), V(1), 1);
+    g.add_edge(V(0), V(2), 2);
+    g.add_edge(V(0), V(1), 3);
+    g.add_edge(V(2), V(0), 4);
+
+    mutation_batch<G> b(g);
+    b.add_edge(V(0), V(3), 10);  // Kept
+    b.add_edge(V(0), V(3), 11);  // Cancelled by the removal below
+    b.remove_edge(V(0), V(3));
+    b.remove_edge(V(0), V(1));   // Removes the first edge from 0 to 1
+    b.add_edge(V(2), V(0), 12);  // Cancelled by removing all edges
+    b.remove_edges(V(2), V(0));
+    b.add_edge(V(2), V(0), 13);  // Kept
+    b.remove_edge(V(3), V(3));   // No such edge
+    b.add_edge(V(3), V(3), 14);  // A loop
+    auto es = b.apply();
+
+    assert(es.size() == 5);
+    assert(!es[1] && !es[2]);
+    assert(g(es[0]) == 10 && g(es[3]) == 13 && g(es[4]) == 14);
+    assert(g.size() == 5);
+    assert(g.out_degree(V(0)) == 3 && g.in_degree(V(0)) == 1);
+    assert(g.out_degree(V(2)) == 1 && g.in_degree(V(3)) == 2);
+    for (auto e : g.out_edges(V(0)))
+      assert(g(e) != 1);
+    assert(g(g(V(0), V(1))) == 3);
+    assert(g(g(V(2), V(0))) == 13);
+    check_structure(g);
+
+    // An empty batch changes nothing.
+    assert(b.apply().empty() && g.size() == 5);
+  }
+
+int main()
+{
+  using D = directed_adjacency_list<char, int>;
+  check_cancellation<D>();
+  check_cancellation<directed_adjacency_list<char, int, sorted_adjacency_list_traits>>();
+  check_cancellation<directed_adjacency_list<char, int, indexed_adjacency_list_traits>>();
+
+  check_random_batches<D>();
+  check_random_batches<directed_adjacency_list<char, int, sorted_adjacency_list_traits>>();
+  check_random_batches<directed_adjacency_list<char, int, indexed_adjacency_list_traits>>();
+  check_random_batches<directed_adjacency_list<char, int, tiny_hash_traits>>();
+  check_random_batches<directed_adjacency_list<char, int, small_adjacency_list_traits<2>>>();
+  check_random_batches<directed_adjacency_list<char, int, split_adjacency_list_traits>>();
+  check_random_batches<directed_adjacency_list<char, int, narrow_adjacency_list_traits>>();
+  check_random_batches<directed_adjacency_list<char, int, bitmap_adjacency_list_traits>>();
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <queue>
+#include <random>
+
+#include <origin/graph/adjacency_list.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::adjacency_list_impl;
+using namespace testing;
+
+// Check that indices are returned in increasing order, regardless of the
+// order of insertion.
+void
+check_queue_order()
+{
+  cout << "*** queue order ***\n";
+  bitmap_queue q;
+  assert(q.empty());
+  for (size_t n : {5, 3, 64, 0, 4095, 4096, 63})
+    q.push(n);
+  assert(q.size() == 7);
+  assert(q.contains(4096));
+  assert(!q.contains(1));
+
+  for (size_t n : {0, 3, 5, 63, 64, 4095, 4096}) {
+    assert(q.top() == n);
+    q.pop();
+  }
+  assert(q.empty());
+}
+
+// Check the bitmap queue against the min-queue under random churn. The
+// indices span several levels of the hierarchy.
+void
+check_queue_churn()
+{
+  cout << "*** queue churn ***\n";
+  minstd_rand gen;
+  uniform_int_distribution<size_t> dist(0, 300000);
+  bitmap_queue q;
+  min_queue r;
+  vector<bool> in(300001, false);
+  for (int i = 0; i < 100000; ++i) {
+    if (gen() % 3 != 0) {
+      size_t n = dist(gen);
+      if (!in[n]) {
+        q.push(n);
+        r.push(n);
+        in[n] = true;
+      }
+    } else if (!r.empty()) {
+      assert(q.top() == r.top());
+      in[r.top()] = false;
+      q.pop();
+      r.pop();
+    }
+    assert(q.size() == r.size());
+  }
+}
+
+// Check that a bitmap pool reuses the least free index.
+void
+check_pool_reuse()
+{
+  cout << "*** pool reuse ***\n";
+  pool<int, bitmap_queue> p;
+  for (int i = 0; i < 100; ++i)
+    p.insert(i);
+  for (int i = 99; i >= 0; i -= 3)
+    p.erase(i);
+  assert(p.free().contains(0));
+  assert(!p.free().contains(1));
+  for (int i = 0; i <= 99; i += 3)
+    assert(p.insert(i) == size_t(i));
+  assert(p.free().empty());
+
+  int n = 0;
+  for (int x : p)
+    assert(x == n++);
+  assert(n == 100);
+}
+
+int main()
+{
+  check_queue_order();
+  check_queue_churn();
+  check_pool_reuse();
+
+  using G = undirected_adjacency_list<char, int, bitmap_adjacency_list_traits>;
+  check_remove_specific_edge<G>();
+  check_remove_first_multi_edge<G>();
+  check_remove_vertex_edges<G>();
+
+  using D = directed_adjacency_list<char, int, bitmap_adjacency_list_traits>;
+  check_remove_specific_edge<D>();
+  check_remove_first_multi_edge<D>();
+  check_remove_vertex_edges<D>();
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::adjacency_list_impl;
+using namespace testing;
+
+// Check that compacting a pool preserves the order of its elements and
+// removes its dead nodes.
+template<typename Q>
+  void
+  check_pool_compact()
+  {
+    cout << "*** pool compact ***\n";
+    pool<vector<int>, Q> p;
+    for (int i = 0; i < 10; ++i)
+      p.insert(vector<int>(i, i));
+    for (int i : {0, 3, 4, 9})
+      p.erase(i);
+
+    vector<size_t> m = p.compact();
+    assert(m.size() == 10);
+    assert(p.size() == 6);
+    assert(p.bound() == 6);
+    assert(p.free().empty());
+    assert(m[0] == p.npos && m[9] == p.npos);
+    assert(m[1] == 0 && m[2] == 1 && m[5] == 2 && m[8] == 5);
+
+    size_t n = 0;
+    for (const vector<int>& x : p) {
+      assert(!x.empty());
+      assert(p[n++] == x);
+    }
+    assert(n == 6);
+    assert(p[2] == vector<int>(5, 5));
+
+    // The compacted pool can be appended to and emptied.
+    assert(p.insert(vector<int>(1, 42)) == 6);
+    p.erase(0);
+    assert(p.insert(vector<int>()) == 0);
+  }
+
+// Check that compaction renumbers the vertices and edges of a graph and
+// preserves its structure.
+template<typename G>
+  void
+  check_graph_compact()
+  {
+    cout << "*** compact (" << typestr<G>() << ") ***\n";
+    G g = build_reflexive_clique<G>(5);
+    vector<pair<char, char>> ends;
+    for (auto e : g.edges())
+      ends.emplace_back(g(g.source(e)), g(g.target(e)));
+
+    g.remove_vertex(1);
+    g.remove_vertex(3);
+    G h = g;
+    auto m = g.compact();
+
+    assert(g.order() == 3);
+    assert(g.vertex_bound() == 3);
+    assert(g.size() == h.size());
+    assert(g.edge_bound() == g.size());
+    assert(!m.vertices[1] && !m.vertices[3]);
+    assert(m.vertices[4] == Vertex<G>(2));
+
+    for (auto v : h.vertices())
+      assert(g(m.vertices[v]) == h(v));
+
+    for (auto e : h.edges()) {
+      auto f = m.edges[e];
+      assert(f);
+      assert(g(f) == h(e));
+      assert(g.source(f) == m.vertices[h.source(e)]);
+      assert(g.target(f) == m.vertices[h.target(e)]);
+      assert(ends[g(f)] == make_pair(g(g.source(f)), g(g.target(f))));
+    }
+
+    // The graph is still mutable.
+    auto v = g.add_vertex('z');
+    assert(v == Vertex<G>(3));
+    g.add_edge(v, 0, 99);
+    for (int i = 0; i < 100; ++i)
+      g.add_vertex();
+    assert(g(g(v, 0)) == 99);
+    g.remove_vertex(0);
+    assert(g.size() == 3);
+  }
+
+int main()
+{
+  check_pool_compact<min_queue>();
+  check_pool_compact<bitmap_queue>();
+
+  check_graph_compact<directed_adjacency_list<char, int>>();
+  check_graph_compact<undirected_adjacency_list<char, int>>();
+  check_graph_compact<directed_adjacency_list<char, int, bitmap_adjacency_list_traits>>();
+  check_graph_compact<undirected_adjacency_list<char, int, bitmap_adjacency_list_traits>>();
+  check_graph_compact<directed_adjacency_list<char, int, narrow_adjacency_list_traits>>();
+  check_graph_compact<undirected_adjacency_list<char, int, narrow_adjacency_list_traits>>();
+}
@@ -0,0 +1,224 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <random>
+#include <tuple>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::adjacency_list_impl;
+using namespace testing;
+
+// Traits that index every vertex, with and without position tracking, so
+// that the small graphs of the shared tests exercise the neighbor tables.
+struct tiny_hash_traits : adjacency_list_traits
+{
+  static constexpr std::size_t hash_threshold = 1;
+};
+
+struct tiny_indexed_hash_traits : indexed_adjacency_list_traits
+{
+  static constexpr std::size_t hash_threshold = 1;
+};
+
+struct tiny_vector_hash_traits : adjacency_vector_traits
+{
+  static constexpr std::size_t hash_threshold = 1;
+};
+
+// Check the neighbor table against a map under random churn. The keys are
+// drawn from a small range so that probe sequences collide and erasure has
+// to shift entries.
+void
+check_table_churn()
+{
+  cout << "*** table churn ***\n";
+  minstd_rand gen;
+  neighbor_table t;
+  map<size_t, size_t> r;
+  for (size_t i = 0; i < 100000; ++i) {
+    size_t v = gen() % 200;
+    if (gen() % 2) {
+      t.insert(v, i);
+      if (r[v]++ == 0)
+        assert(t.find(v) == i);
+    } else if (r.count(v)) {
+      size_t e = t.find(v);
+      bool replace = t.erase(v, e);
+      assert(replace == (--r[v] != 0));
+      if (replace)
+        t.replace(v, i);
+      if (r[v] == 0)
+        r.erase(v);
+    }
+    assert(t.size() == r.size());
+  }
+  for (size_t v = 0; v < 200; ++v) {
+    assert(t.count(v) == (r.count(v) ? r[v] : 0));
+    assert((t.find(v) == neighbor_table::npos) == (r.count(v) == 0));
+  }
+}
+
+// Returns true if some edge connects u to v, by searching the incidence
+// lists directly.
+template<typename G>
+  bool
+  connected(const G& g, Vertex<G> u, Vertex<G> v, Requires<Directed_graph<G>()>* = nullptr)
+  {
+    for (auto e : g.out_edges(u))
+      if (g.target(e) == v)
+        return true;
+    return false;
+  }
+
+template<typename G>
+  bool
+  connected(const G& g, Vertex<G> u, Vertex<G> v, Requires<Undirected_graph<G>()>* = nullptr)
+  {
+    for (auto e : g.edges(u))
+      if (opposite(g, e, u) == v)
+        return true;
+    return false;
+  }
+
+// Check that the edge relation agrees with the incidence lists for every
+// pair of vertices.
+template<typename G>
+  void
+  check_relation(const G& g)
+  {
+    for (auto u : g.vertices()) {
+      for (auto v : g.vertices()) {
+        Edge<G> e = g(u, v);
+        assert(bool(e) == connected(g, u, v));
+        if (e)
+          assert(are_endpoints(g, e, u, v));
+      }
+    }
+  }
+
+// Build a graph with a few hubs, whose degrees exceed the threshold, and
+// apply a random sequence of insertions and removals, checking the edge
+// relation as the neighbor tables are built and updated.
+template<typename G>
+  void
+  check_hubs()
+  {
+    cout << "*** hubs (" << typestr<G>() << ") ***\n";
+    minstd_rand gen;
+    G g = build_n_graph<G>(40);
+    for (int i = 0; i < 20000; ++i) {
+      int op = gen() % 8;
+      Vertex<G> u = gen() % 40;
+      Vertex<G> v = gen() % 40;
+      if (op < 4) {
+        // Most edges have one of the first four vertices as an endpoint.
+        if (gen() % 4 != 0)
+          u = gen() % 4;
+        g.add_edge(u, v, i);
+      } else if (op < 6) {
+        g.remove_edge(u % 4, v);
+      } else if (op == 6 && !g.empty()) {
+        g.remove_edge(*g.edges().begin());
+      } else if (op == 7 && gen() % 16 == 0) {
+        g.remove_edges(u % 4, v);
+      }
+      if (i % 1000 == 0)
+        check_relation(g);
+    }
+    check_relation(g);
+
+    // Removing a hub drops its neighbor table, and the handle is reused.
+    g.remove_vertex(Vertex<G>(0));
+    Vertex<G> w = g.add_vertex();
+    assert(w == Vertex<G>(0));
+    check_relation(g);
+    for (int i = 0; i < 100; ++i)
+      g.add_edge(w, gen() % 40, i);
+    check_relation(g);
+
+    // The tables are rebuilt after compaction.
+    g.remove_vertex(Vertex<G>(17));
+    g.compact();
+    check_relation(g);
+  }
+
+// Adjacency vectors only grow, so it is enough to check the relation after
+// building the graph edge by edge and in bulk.
+template<typename G>
+  void
+  check_vector_hubs()
+  {
+    cout << "*** vector hubs (" << typestr<G>() << ") ***\n";
+    minstd_rand gen;
+    G g = build_n_graph<G>(40);
+    vector<tuple<size_t, size_t>> es;
+    for (int i = 0; i < 2000; ++i) {
+      Vertex<G> u = gen() % 4;
+      Vertex<G> v = gen() % 40;
+      g.add_edge(u, v);
+      es.emplace_back(u, v);
+    }
+    check_relation(g);
+
+    G h(40, es);
+    check_relation(h);
+  }
+
+int main()
+{
+  check_table_churn();
+
+  using G = undirected_adjacency_list<char, int, tiny_hash_traits>;
+  check_default_init<G>();
+  check_add_vertices<G>();
+  check_add_edges<G>();
+  check_remove_specific_edge<G>();
+  check_remove_first_simple_edge<G>();
+  check_remove_first_multi_edge<G>();
+  check_remove_multi_edge<G>();
+  check_remove_vertex_edges<G>();
+  check_remove_all_edges<G>();
+
+  using D = directed_adjacency_list<char, int, tiny_hash_traits>;
+  check_default_init<D>();
+  check_add_vertices<D>();
+  check_add_edges<D>();
+  check_remove_specific_edge<D>();
+  check_remove_first_simple_edge<D>();
+  check_remove_first_multi_edge<D>();
+  check_remove_multi_edge<D>();
+  check_remove_vertex_edges<D>();
+  check_remove_all_edges<D>();
+
+  using GI = undirected_adjacency_list<char, int, tiny_indexed_hash_traits>;
+  check_remove_first_multi_edge<GI>();
+  check_remove_multi_edge<GI>();
+  check_remove_vertex_edges<GI>();
+
+  using DI = directed_adjacency_list<char, int, tiny_indexed_hash_traits>;
+  check_remove_first_multi_edge<DI>();
+  check_remove_multi_edge<DI>();
+  check_remove_vertex_edges<DI>();
+
+  check_hubs<undirected_adjacency_list<char, int, hashed_adjacency_list_traits>>();
+  check_hubs<directed_adjacency_list<char, int, hashed_adjacency_list_traits>>();
+  check_hubs<undirected_adjacency_list<char, int, tiny_hash_traits>>();
+  check_hubs<directed_adjacency_list<char, int, tiny_hash_traits>>();
+
+  check_vector_hubs<directed_adjacency_vector<char, empty_t, hashed_adjacency_vector_traits>>();
+  check_vector_hubs<undirected_adjacency_vector<char, empty_t, hashed_adjacency_vector_traits>>();
+  check_vector_hubs<undirected_adjacency_vector<char, empty_t, tiny_vector_hash_traits>>();
+}
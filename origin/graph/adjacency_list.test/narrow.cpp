@@ -0,0 +1,155 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::adjacency_list_impl;
+using namespace testing;
+
+using narrow_vertex = basic_vertex_handle<uint32_t>;
+using narrow_edge = basic_edge_handle<uint32_t>;
+
+// Narrow handles combine with position tracking.
+struct indexed_narrow_traits : narrow_adjacency_list_traits
+{
+  static constexpr bool track_positions = true;
+};
+
+// Check that narrow handles have the same interface as the default handles.
+// In particular, the invalid handle converts to npos.
+void
+check_narrow_handles()
+{
+  cout << "*** narrow handles ***\n";
+  static_assert(sizeof(narrow_vertex) == 4, "");
+  static_assert(sizeof(narrow_edge) == 4, "");
+
+  narrow_vertex a;
+  narrow_vertex b = 3;
+  assert(!a && b);
+  assert(a.value == uint32_t(-1));
+  assert(size_t(a) == size_t(-1));
+  assert(size_t(a) == narrow_vertex::npos);
+  assert(size_t(b) == 3);
+  assert(a < b && b > a && a != b);
+  assert(narrow_vertex(size_t(-1)) == a);
+  assert(narrow_vertex(vertex_handle()) == a);
+  assert(vertex_handle(b) == vertex_handle(3));
+
+  vector<int> v {3, 2, 1, 0};
+  assert(v[b] == 0);
+}
+
+// Check that the nodes of a pool are linked by narrow indexes, and that the
+// interface of the pool still reports npos.
+void
+check_narrow_pool()
+{
+  cout << "*** narrow pool ***\n";
+  using P = pool<int, min_queue, uint32_t>;
+  static_assert(sizeof(P::node_type) == 12, "");
+
+  P p;
+  for (int i = 0; i < 10; ++i)
+    p.insert(i);
+  p.erase(0);
+  p.erase(5);
+  assert(p.seek(10).index() == P::npos);
+  assert(p.insert(42) == 0);
+  assert(p.insert(43) == 5);
+
+  int n = 0;
+  for (int x : p)
+    n += x;
+  assert(n == 45 - 5 + 42 + 43);
+
+  vector<size_t> m = p.compact();
+  assert(m.size() == 10 && p.bound() == 10);
+}
+
+// Check that narrow graphs store narrow handles, and that the edge relation
+// returns a handle that converts to npos when there is no edge.
+template<typename G>
+  void
+  check_narrow_graph()
+  {
+    cout << "*** narrow graph (" << typestr<G>() << ") ***\n";
+    static_assert(sizeof(Vertex<G>) == 4, "");
+    static_assert(sizeof(Edge<G>) == 4, "");
+
+    G g = build_n_graph<G>(4);
+    g.add_edge(Vertex<G>(0), Vertex<G>(1), 1);
+    g.add_edge(Vertex<G>(1), Vertex<G>(2), 2);
+    Edge<G> e = g(Vertex<G>(2), Vertex<G>(3));
+    assert(!e);
+    assert(size_t(e) == size_t(-1));
+    assert(g(g(Vertex<G>(1), Vertex<G>(2))) == 2);
+  }
+
+int main()
+{
+  check_narrow_handles();
+  check_narrow_pool();
+
+  using T = narrow_adjacency_list_traits;
+  using G = undirected_adjacency_list<char, int, T>;
+  check_default_init<G>();
+  check_add_vertices<G>();
+  check_add_edges<G>();
+  check_remove_specific_edge<G>();
+  check_remove_first_simple_edge<G>();
+  check_remove_first_multi_edge<G>();
+  check_remove_multi_edge<G>();
+  check_remove_vertex_edges<G>();
+  check_remove_all_edges<G>();
+  check_narrow_graph<G>();
+
+  using D = directed_adjacency_list<char, int, T>;
+  check_default_init<D>();
+  check_add_vertices<D>();
+  check_add_edges<D>();
+  check_remove_specific_edge<D>();
+  check_remove_first_simple_edge<D>();
+  check_remove_first_multi_edge<D>();
+  check_remove_multi_edge<D>();
+  check_remove_vertex_edges<D>();
+  check_remove_all_edges<D>();
+  check_narrow_graph<D>();
+
+  using GI = undirected_adjacency_list<char, int, indexed_narrow_traits>;
+  check_remove_first_multi_edge<GI>();
+  check_remove_multi_edge<GI>();
+  check_remove_vertex_edges<GI>();
+
+  using U = narrow_adjacency_vector_traits;
+  using GV = undirected_adjacency_vector<char, int, U>;
+  check_default_init<GV>();
+  check_add_vertices<GV>();
+  check_add_edges<GV>();
+  check_narrow_graph<GV>();
+
+  using DV = directed_adjacency_vector<char, int, U>;
+  check_default_init<DV>();
+  check_add_vertices<DV>();
+  check_add_edges<DV>();
+  check_narrow_graph<DV>();
+
+  vector<tuple<size_t, size_t>> es {make_tuple(0, 1), make_tuple(1, 2)};
+  DV h(3, es);
+  assert(h.size() == 2 && h(Vertex<DV>(1), Vertex<DV>(2)));
+}
@@ -0,0 +1,200 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the sorted values of the edges incident to v, with the edges
+// leaving v distinguished from those entering v in directed graphs.
+template<typename G>
+  vector<int>
+  incident_values(const G& g, Vertex<G> v, Requires<Directed_graph<G>()>* = nullptr)
+  {
+    vector<int> r;
+    for (auto e : g.out_edges(v))
+      r.push_back(g(e));
+    for (auto e : g.in_edges(v))
+      r.push_back(-g(e) - 1);
+    sort(r.begin(), r.end());
+    return r;
+  }
+
+template<typename G>
+  vector<int>
+  incident_values(const G& g, Vertex<G> v, Requires<Undirected_graph<G>()>* = nullptr)
+  {
+    vector<int> r;
+    for (auto e : g.edges(v))
+      r.push_back(g(e));
+    sort(r.begin(), r.end());
+    return r;
+  }
+
+// Returns the edge of g with the value x.
+template<typename G>
+  Edge<G>
+  find_value(const G& g, int x)
+  {
+    for (auto e : g.edges())
+      if (g(e) == x)
+        return e;
+    return {};
+  }
+
+// Returns the sorted values of the edges of g.
+template<typename G>
+  vector<int>
+  edge_values(const G& g)
+  {
+    vector<int> r;
+    for (auto e : g.edges())
+      r.push_back(g(e));
+    sort(r.begin(), r.end());
+    return r;
+  }
+
+// Returns a randomly chosen vertex of g.
+template<typename G, typename R>
+  Vertex<G>
+  random_vertex(const G& g, R& gen)
+  {
+    Vertex<G> v = *g.vertices().begin();
+    for (auto x : g.vertices())
+      if (gen() % 2)
+        v = x;
+    return v;
+  }
+
+// Apply the same random sequence of insertions and removals to a graph with
+// tracked positions (G) and one without (H), and check that they contain the
+// same edges. Edges are identified by their values, since the graphs may
+// assign different handles after removing different edges that connect the
+// same vertices.
+template<typename G, typename H>
+  void
+  check_churn()
+  {
+    cout << "*** churn (" << typestr<G>() << ") ***\n";
+    minstd_rand gen;
+    G g = build_n_graph<G>(8);
+    H h = build_n_graph<H>(8);
+    for (int i = 0; i < 5000; ++i) {
+      int op = gen() % 8;
+      if (op < 4) {
+        Vertex<G> u = random_vertex(g, gen);
+        Vertex<G> v = random_vertex(g, gen);
+        g.add_edge(u, v, i);
+        h.add_edge(u, v, i);
+      } else if (op < 6 && !g.empty()) {
+        Edge<G> e = *g.edges().begin();
+        for (auto x : g.edges())
+          if (gen() % 4 == 0)
+            e = x;
+        h.remove_edge(find_value(h, g(e)));
+        g.remove_edge(e);
+      } else if (op == 6 && !g.empty()) {
+        Edge<G> e = *g.edges().begin();
+        Vertex<G> u = g.source(e);
+        Vertex<G> v = g.target(e);
+        if (gen() % 2) {
+          // Remove the same edge from h that was removed from g.
+          vector<int> before = edge_values(g);
+          g.remove_edge(u, v);
+          vector<int> after = edge_values(g);
+          auto i = mismatch(after.begin(), after.end(), before.begin());
+          h.remove_edge(find_value(h, *i.second));
+        } else {
+          g.remove_edges(u, v);
+          h.remove_edges(u, v);
+        }
+      } else if (op == 7 && gen() % 8 == 0) {
+        Vertex<G> v = random_vertex(g, gen);
+        g.remove_vertex(v);
+        h.remove_vertex(v);
+        g.add_vertex();
+        h.add_vertex();
+      }
+      assert(g.size() == h.size());
+    }
+
+    // Vertices are added and removed in the same order, so their handles
+    // agree.
+    assert(edge_values(g) == edge_values(h));
+    for (auto v : g.vertices())
+      assert(incident_values(g, v) == incident_values(h, v));
+
+    // Positions survive compaction.
+    g.compact();
+    while (!g.empty())
+      g.remove_edge(*g.edges().begin());
+    for (auto v : g.vertices())
+      assert(incident_values(g, v).empty());
+  }
+
+// Check that removing edges by handle keeps the remaining edges intact.
+template<typename G>
+  void
+  check_remove_by_handle()
+  {
+    cout << "*** remove by handle (" << typestr<G>() << ") ***\n";
+    minstd_rand gen;
+    G g = build_n_graph<G>(4);
+    vector<Edge<G>> es;
+    for (int i = 0; i < 1000; ++i)
+      es.push_back(g.add_edge(gen() % 4, gen() % 4, i));
+    shuffle(es.begin(), es.end(), gen);
+    for (size_t i = 0; i < es.size(); ++i) {
+      g.remove_edge(es[i]);
+      if (i % 97 == 0) {
+        for (size_t j = i + 1; j < es.size(); ++j)
+          assert(!incident_values(g, g.source(es[j])).empty());
+      }
+    }
+    assert(g.empty());
+  }
+
+int main()
+{
+  using T = indexed_adjacency_list_traits;
+
+  using G = undirected_adjacency_list<char, int, T>;
+  check_default_init<G>();
+  check_add_vertices<G>();
+  check_add_edges<G>();
+  check_remove_specific_edge<G>();
+  check_remove_first_simple_edge<G>();
+  check_remove_first_multi_edge<G>();
+  check_remove_multi_edge<G>();
+  check_remove_vertex_edges<G>();
+  check_remove_all_edges<G>();
+  check_remove_by_handle<G>();
+  check_churn<G, undirected_adjacency_list<char, int>>();
+
+  using D = directed_adjacency_list<char, int, T>;
+  check_default_init<D>();
+  check_add_vertices<D>();
+  check_add_edges<D>();
+  check_remove_specific_edge<D>();
+  check_remove_first_simple_edge<D>();
+  check_remove_first_multi_edge<D>();
+  check_remove_multi_edge<D>();
+  check_remove_vertex_edges<D>();
+  check_remove_all_edges<D>();
+  check_remove_by_handle<D>();
+  check_churn<D, directed_adjacency_list<char, int>>();
+}
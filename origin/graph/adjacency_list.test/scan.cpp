@@ -0,0 +1,142 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::adjacency_list_impl;
+using namespace testing;
+
+// Check that the blocks of the pool p cover its live elements exactly once,
+// in order.
+template<typename P>
+  void
+  check_split(const P& p, size_t k)
+  {
+    vector<size_t> b = p.split(k);
+    assert(b.size() == k + 1);
+    assert(b.front() == 0);
+    assert(b.back() == p.bound());
+
+    auto i = p.begin();
+    for (size_t j = 0; j < k; ++j) {
+      assert(b[j] <= b[j + 1]);
+      for (auto x = p.seek(b[j]); x != p.seek(b[j + 1]); ++x, ++i)
+        assert(x == i);
+    }
+    assert(i == p.end());
+  }
+
+// Check that the bitmap pool iterates over the same elements as the default
+// pool under random churn, and that both pools can be split into blocks.
+void
+check_pool_scan()
+{
+  cout << "*** pool scan ***\n";
+  minstd_rand gen;
+  pool<int> p;
+  pool<int, bitmap_queue> q;
+  for (int i = 0; i < 5000; ++i) {
+    if (gen() % 3 != 0 || p.empty()) {
+      size_t n = p.insert(i);
+      assert(q.insert(i) == n);
+    } else {
+      size_t n = p.seek(gen() % p.bound()).index();
+      if (n != p.npos) {
+        p.erase(n);
+        q.erase(n);
+      }
+    }
+    assert(p.size() == q.size());
+  }
+
+  auto j = q.begin();
+  for (auto i = p.begin(); i != p.end(); ++i, ++j) {
+    assert(i.index() == j.index());
+    assert(*i == *j);
+  }
+  assert(j == q.end());
+
+  for (size_t k : {1, 2, 3, 7, 64}) {
+    check_split(p, k);
+    check_split(q, k);
+  }
+}
+
+// Check that an emptied pool has no elements to iterate over.
+template<typename Q>
+  void
+  check_pool_empty()
+  {
+    cout << "*** pool empty ***\n";
+    pool<int, Q> p;
+    assert(p.begin() == p.end());
+    check_split(p, 4);
+
+    for (int i = 0; i < 10; ++i)
+      p.insert(i);
+    p.clear();
+    assert(p.begin() == p.end());
+    assert(p.seek(0) == p.end());
+
+    for (int i = 0; i < 100; ++i)
+      p.insert(i);
+    for (int i = 0; i < 100; ++i)
+      p.erase(i);
+    assert(p.begin() == p.end());
+    check_split(p, 4);
+  }
+
+// Check that the vertex and edge blocks of a graph partition its vertex and
+// edge sets.
+template<typename G>
+  void
+  check_graph_blocks()
+  {
+    cout << "*** graph blocks (" << typestr<G>() << ") ***\n";
+    G g = build_reflexive_clique<G>(5);
+    g.remove_vertex(1);
+    g.remove_vertex(3);
+
+    for (size_t k : {1, 2, 3, 8}) {
+      auto vb = g.vertex_blocks(k);
+      assert(vb.size() == k);
+      auto v = g.vertices().begin();
+      for (auto r : vb)
+        for (auto x : r)
+          assert(x == *v++);
+      assert(v == g.vertices().end());
+
+      auto eb = g.edge_blocks(k);
+      assert(eb.size() == k);
+      auto e = g.edges().begin();
+      for (auto r : eb)
+        for (auto x : r)
+          assert(x == *e++);
+      assert(e == g.edges().end());
+    }
+  }
+
+int main()
+{
+  check_pool_scan();
+  check_pool_empty<min_queue>();
+  check_pool_empty<bitmap_queue>();
+
+  check_graph_blocks<directed_adjacency_list<char, int>>();
+  check_graph_blocks<undirected_adjacency_list<char, int>>();
+  check_graph_blocks<directed_adjacency_list<char, int, bitmap_adjacency_list_traits>>();
+  check_graph_blocks<undirected_adjacency_list<char, int, bitmap_adjacency_list_traits>>();
+}
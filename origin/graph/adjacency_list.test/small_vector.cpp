@@ -0,0 +1,151 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::adjacency_list_impl;
+using namespace testing;
+
+using S = small_vector<edge_handle, 2>;
+
+template<typename R>
+  bool
+  same_elements(const S& s, const R& r)
+  {
+    return s.size() == r.size() && std::equal(s.begin(), s.end(), r.begin());
+  }
+
+// Check that the vector stays inline up to its inline capacity, and then
+// allocates.
+void
+check_growth()
+{
+  cout << "*** small vector growth ***\n";
+  S s;
+  vector<edge_handle> r;
+  assert(s.empty() && s.is_inline());
+  for (int i = 0; i < 2; ++i) {
+    s.push_back(i);
+    r.push_back(i);
+  }
+  assert(s.is_inline());
+  assert(same_elements(s, r));
+
+  for (int i = 2; i < 100; ++i) {
+    s.push_back(i);
+    r.push_back(i);
+  }
+  assert(!s.is_inline());
+  assert(same_elements(s, r));
+
+  // Pushing an element of the vector into itself while growing.
+  while (s.size() != s.capacity()) {
+    s.push_back(s[0]);
+    r.push_back(r[0]);
+  }
+  s.push_back(s.back());
+  r.push_back(r.back());
+  assert(same_elements(s, r));
+}
+
+// Check erasure of single elements and ranges.
+void
+check_erase()
+{
+  cout << "*** small vector erase ***\n";
+  S s;
+  vector<edge_handle> r;
+  for (int i = 0; i < 10; ++i) {
+    s.push_back(i);
+    r.push_back(i);
+  }
+  s.erase(s.begin() + 3);
+  r.erase(r.begin() + 3);
+  assert(same_elements(s, r));
+
+  s.erase(s.begin() + 1, s.begin() + 5);
+  r.erase(r.begin() + 1, r.begin() + 5);
+  assert(same_elements(s, r));
+
+  s.erase(s.end() - 1);
+  r.erase(r.end() - 1);
+  assert(same_elements(s, r));
+
+  while (s.size() > 2)
+    s.pop_back();
+  s.shrink_to_fit();
+  assert(s.is_inline());
+  assert(s[0] == edge_handle(0) && s[1] == edge_handle(6));
+
+  s.clear();
+  assert(s.empty());
+}
+
+// Check copy and move semantics for inline and allocated vectors.
+void
+check_copy_move()
+{
+  cout << "*** small vector copy and move ***\n";
+  for (int n : {1, 2, 3, 50}) {
+    S s;
+    for (int i = 0; i < n; ++i)
+      s.push_back(i);
+
+    S c = s;
+    assert(same_elements(c, s));
+    S m = std::move(c);
+    assert(same_elements(m, s));
+    assert(c.empty());
+
+    S a;
+    a.push_back(42);
+    a = s;
+    assert(same_elements(a, s));
+    a = S();
+    assert(a.empty() && a.is_inline());
+    a = std::move(m);
+    assert(same_elements(a, s));
+  }
+}
+
+int main()
+{
+  check_growth();
+  check_erase();
+  check_copy_move();
+
+  using G = undirected_adjacency_list<char, int, small_adjacency_list_traits<2>>;
+  check_default_init<G>();
+  check_add_vertices<G>();
+  check_add_edges<G>();
+  check_remove_specific_edge<G>();
+  check_remove_first_simple_edge<G>();
+  check_remove_first_multi_edge<G>();
+  check_remove_multi_edge<G>();
+  check_remove_vertex_edges<G>();
+  check_remove_all_edges<G>();
+
+  using D = directed_adjacency_list<char, int, small_adjacency_list_traits<2>>;
+  check_default_init<D>();
+  check_add_vertices<D>();
+  check_add_edges<D>();
+  check_remove_specific_edge<D>();
+  check_remove_first_simple_edge<D>();
+  check_remove_first_multi_edge<D>();
+  check_remove_multi_edge<D>();
+  check_remove_vertex_edges<D>();
+  check_remove_all_edges<D>();
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// A large edge value. Its string member checks that values are moved and
+// released correctly.
+struct payload
+{
+  payload() : id(-1) { }
+  payload(int n) : id(n), name(to_string(n)) { }
+
+  int id;
+  string name;
+  char pad[32];
+};
+
+// Check that the values of a split graph follow their edges through random
+// insertions, removals and compaction. The expected value of each edge is
+// recorded in a map keyed by its endpoints and value.
+template<typename G>
+  void
+  check_split_churn()
+  {
+    cout << "*** split churn (" << typestr<G>() << ") ***\n";
+    using key = tuple<size_t, size_t, int>;
+    minstd_rand gen;
+    G g = build_n_graph<G>(20);
+    map<key, int> expect;
+    for (int i = 0; i < 5000; ++i) {
+      Vertex<G> u = gen() % 20;
+      Vertex<G> v = gen() % 20;
+      if (gen() % 3 != 0) {
+        Edge<G> e = g.add_edge(u, v, payload(i));
+        ++expect[key(g.source(e), g.target(e), i)];
+      } else if (!g.empty()) {
+        Edge<G> e = *g.edges().begin();
+        key k(g.source(e), g.target(e), g(e).id);
+        assert(g(e).name == to_string(g(e).id));
+        if (--expect[k] == 0)
+          expect.erase(k);
+        g.remove_edge(e);
+      }
+    }
+    g.remove_vertex(Vertex<G>(3));
+    g.compact();
+
+    // Compaction renumbers the vertices, so compare edges by the values of
+    // their endpoints.
+    map<key, int> found;
+    for (auto e : g.edges()) {
+      assert(g(e).name == to_string(g(e).id));
+      ++found[key(g(g.source(e)), g(g.target(e)), g(e).id)];
+    }
+    map<key, int> kept;
+    for (auto& x : expect) {
+      size_t u = get<0>(x.first);
+      size_t v = get<1>(x.first);
+      if (u != 3 && v != 3)
+        kept[key('a' + u, 'a' + v, get<2>(x.first))] = x.second;
+    }
+    assert(found == kept);
+  }
+
+// Values may be modified through the reference returned by g(e).
+template<typename G>
+  void
+  check_split_access()
+  {
+    cout << "*** split access (" << typestr<G>() << ") ***\n";
+    G g = build_n_graph<G>(3);
+    Edge<G> e1 = g.add_edge(Vertex<G>(0), Vertex<G>(1), payload(1));
+    Edge<G> e2 = g.add_edge(Vertex<G>(1), Vertex<G>(2));
+    assert(g(e1).id == 1 && g(e2).id == -1);
+    g(e2).id = 7;
+    const G& cg = g;
+    assert(cg(e2).id == 7);
+    assert(g.source(e2) == Vertex<G>(1) && g.target(e2) == Vertex<G>(2));
+  }
+
+int main()
+{
+  using T = split_adjacency_list_traits;
+  using G = undirected_adjacency_list<char, int, T>;
+  check_default_init<G>();
+  check_add_vertices<G>();
+  check_add_edges<G>();
+  check_remove_specific_edge<G>();
+  check_remove_first_simple_edge<G>();
+  check_remove_first_multi_edge<G>();
+  check_remove_multi_edge<G>();
+  check_remove_vertex_edges<G>();
+  check_remove_all_edges<G>();
+
+  using D = directed_adjacency_list<char, int, T>;
+  check_default_init<D>();
+  check_add_vertices<D>();
+  check_add_edges<D>();
+  check_remove_specific_edge<D>();
+  check_remove_first_simple_edge<D>();
+  check_remove_first_multi_edge<D>();
+  check_remove_multi_edge<D>();
+  check_remove_vertex_edges<D>();
+  check_remove_all_edges<D>();
+
+  check_split_churn<undirected_adjacency_list<char, payload, T>>();
+  check_split_churn<directed_adjacency_list<char, payload, T>>();
+  check_split_access<undirected_adjacency_list<char, payload, T>>();
+  check_split_access<directed_adjacency_list<char, payload, T>>();
+
+  using U = split_adjacency_vector_traits;
+  using GV = undirected_adjacency_vector<char, int, U>;
+  check_default_init<GV>();
+  check_add_vertices<GV>();
+  check_add_edges<GV>();
+
+  using DV = directed_adjacency_vector<char, int, U>;
+  check_default_init<DV>();
+  check_add_vertices<DV>();
+  check_add_edges<DV>();
+
+  check_split_access<undirected_adjacency_vector<char, payload, U>>();
+  check_split_access<directed_adjacency_vector<char, payload, U>>();
+
+  // Bulk loading stores the values of the edge tuples.
+  vector<tuple<size_t, size_t, int>> es;
+  for (int i = 0; i < 100; ++i)
+    es.emplace_back(i % 10, (i * 7) % 10, i);
+  DV h(10, es);
+  for (auto e : h.edges())
+    assert(get<2>(es[e]) == h(e));
+}
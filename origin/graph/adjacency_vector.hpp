@@ -10,6 +10,7 @@
 
 #include <cassert>
 
+#include <atomic>
 #include <iostream>
 #include <queue>
 #include <tuple>
@@ -25,8 +26,13 @@
 #include <origin/graph/handle.hpp>
 #include <origin/graph/graph.hpp>
 #include <origin/graph/io.hpp>
+#include <origin/graph/parallel.hpp>
 
+#include <origin/graph/adjacency_list.impl/edge_values.hpp>
+#include <origin/graph/adjacency_list.impl/neighbor_table.hpp>
 #include <origin/graph/adjacency_list.impl/pool.hpp>
+#include <origin/graph/adjacency_list.impl/small_vector.hpp>
+#include <origin/graph/adjacency_list.impl/sorted.hpp>
 
 namespace origin
 {
@@ -34,8 +40,9 @@ namespace origin
   namespace adjacency_vector_impl
   {
 
-    // The handle iterator wraps a constant iterator of the container type C and
-    // returns handles of type H when dereferenced.
+    // The handle counter is an iterator over a contiguous sequence of handles
+    // of type H. Dereferencing the iterator returns the current count as a
+    // handle.
     //
     // TODO: Make this a random access iterator.
     template<typename T, typename H>
@@ -48,7 +55,7 @@ namespace origin
           : count(n)
         { }
 
-        handle_type operator*() const { H(count); }
+        handle_type operator*() const { return H(count); }
 
         handle_counter& operator++();
         handle_counter  operator++(int);
@@ -100,60 +107,166 @@ namespace origin
     // In an undirected adjacency list, the source and target vertices refer to
     // the vertices in the order they were specified on addition. There is no
     // other meaning attributed to them.
-    template<typename E>
+    //
+    // The vertex handles are stored as indexes of type I.
+    template<typename E, typename I = std::size_t>
       struct edge
       {
         using value_type = E;
+        using vertex_type = basic_vertex_handle<I>;
 
         edge()
           : data(-1, -1, E{})
         { }
 
-        edge(vertex_handle s, vertex_handle t)
+        edge(vertex_type s, vertex_type t)
           : data(s, t, E{})
         { }
 
         template<typename... Args>
-          edge(vertex_handle s, vertex_handle t, Args&&... args)
+          edge(vertex_type s, vertex_type t, Args&&... args)
             : data(s, t, std::forward<Args>(args)...)
           { }
 
-        vertex_handle& source()       { return std::get<0>(data); }
-        vertex_handle  source() const { return std::get<0>(data); }
+        vertex_type& source()       { return std::get<0>(data); }
+        vertex_type  source() const { return std::get<0>(data); }
 
-        vertex_handle& target()       { return std::get<1>(data); }
-        vertex_handle  target() const { return std::get<1>(data); }
+        vertex_type& target()       { return std::get<1>(data); }
+        vertex_type  target() const { return std::get<1>(data); }
 
         E&       value()       { return std::get<2>(data); }
         const E& value() const { return std::get<2>(data); }
 
-        std::tuple<vertex_handle, vertex_handle,  E> data;
+        std::tuple<vertex_type, vertex_type,  E> data;
       };
 
     // An (incident) edge list is a vector of indexes.
-    using edge_list = std::vector<edge_handle>;
+    template<typename I>
+      using basic_edge_list = std::vector<basic_edge_handle<I>>;
+
+    using edge_list = basic_edge_list<std::size_t>;
   
     // An alias for the edge pool.
-    template<typename E>
-      using edge_set = std::vector<edge<E>>;
+    template<typename E, typename I = std::size_t>
+      using edge_set = std::vector<edge<E, I>>;
 
     // An alias for the edge iterator.
-    template<typename E>
-      using edge_iterator = handle_counter<std::size_t, edge_handle>;
+    template<typename E, typename I = std::size_t>
+      using edge_iterator = handle_counter<std::size_t, basic_edge_handle<I>>;
 
     // An alias for the edge range.
-    template<typename E>
-      using edge_range = bounded_range<edge_iterator<E>>;
+    template<typename E, typename I = std::size_t>
+      using edge_range = bounded_range<edge_iterator<E, I>>;
 
-    // An alias for the incident edge iterator.
-    using incidence_iterator = typename edge_list::const_iterator;
+    // An alias for the incident edge iterator over the incidence list L.
+    template<typename L>
+      using incidence_iterator = typename L::const_iterator;
 
     // An alias for the icident edge range.
-    using incidence_range = bounded_range<incidence_iterator>;
+    template<typename L>
+      using incidence_range = bounded_range<incidence_iterator<L>>;
+
+
+    // ---------------------------------------------------------------------- //
+    //                            Edge Tuples
+    //
+    // The bulk edge operations accept ranges of edge tuples. An edge tuple is
+    // a pair (u, v) or a tuple (u, v, x) describing an edge from u to v with
+    // the value x. When no value is given, the edge value is default
+    // constructed.
+
+    // Returns the source vertex of an edge tuple.
+    template<typename T>
+      inline std::size_t
+      tuple_source(const T& t) { return std::get<0>(t); }
+
+    // Returns the target vertex of an edge tuple.
+    template<typename T>
+      inline std::size_t
+      tuple_target(const T& t) { return std::get<1>(t); }
+
+    // Returns the value of an edge tuple.
+    template<typename E, typename T>
+      inline Requires<(std::tuple_size<T>::value > 2), E>
+      tuple_value(const T& t) { return std::get<2>(t); }
+
+    template<typename E, typename T>
+      inline Requires<(std::tuple_size<T>::value == 2), E>
+      tuple_value(const T&) { return E{}; }
 
   } // namespace adjacency_vector_impl
 
 
+  // ------------------------------------------------------------------------ //
+  //                                                      [graph.adj_vec.traits]
+  //                        Adjacency Vector Traits
+  //
+  // The adjacency vector traits class configures the storage used by the
+  // directed and undirected adjacency vectors. Alternative configurations are
+  // defined by deriving from this class and redefining some of its members.
+  //
+  //    index_type -- The unsigned integer type in which vertex and edge
+  //        handles are stored.
+  //    incidence_list -- The list of edge handles incident to each vertex.
+  //        Its elements must be edge handles with the same index type.
+  //    hash_threshold -- If nonzero, a vertex whose degree reaches this value
+  //        indexes its neighbors in a hash table.
+  //    sorted_incidence -- If true, edges are inserted into the incidence
+  //        lists in order of their opposite endpoints.
+  //    split_edge_values -- If true, edge values are stored in an array
+  //        apart from the edge records. Edge values must be default
+  //        constructible and move assignable.
+  struct adjacency_vector_traits
+  {
+    using index_type = std::size_t;
+    using incidence_list = adjacency_vector_impl::edge_list;
+    static constexpr std::size_t hash_threshold = 0;
+    static constexpr bool sorted_incidence = false;
+    static constexpr bool split_edge_values = false;
+  };
+
+  // Traits for adjacency vectors whose incidence lists are always sorted by
+  // opposite endpoint. Bulk loading sorts each list once.
+  struct sorted_adjacency_vector_traits : adjacency_vector_traits
+  {
+    static constexpr bool sorted_incidence = true;
+  };
+
+  // Traits for adjacency vectors with high degree vertices that are
+  // frequently queried using the edge relation g(u, v). Once the degree of a
+  // vertex reaches the threshold, g(u, v) takes expected constant time.
+  struct hashed_adjacency_vector_traits : adjacency_vector_traits
+  {
+    static constexpr std::size_t hash_threshold = 32;
+  };
+
+  // Traits for adjacency vectors whose vertices mostly have small degree. The
+  // first N incident edges of each vertex are stored inside the vertex.
+  template<std::size_t N>
+    struct small_adjacency_vector_traits : adjacency_vector_traits
+    {
+      using incidence_list = adjacency_list_impl::small_vector<edge_handle, N>;
+    };
+
+  // Traits for adjacency vectors with large edge values that are mostly
+  // traversed without reading those values. The edge records contain only
+  // the endpoints of each edge, and the values are stored in a separate
+  // array.
+  struct split_adjacency_vector_traits : adjacency_vector_traits
+  {
+    static constexpr bool split_edge_values = true;
+  };
+
+  // Traits for adjacency vectors with fewer than 2^32 - 1 vertices and
+  // edges. Handles are stored as 32-bit indexes, which halves the size of
+  // the incidence lists and edge records.
+  struct narrow_adjacency_vector_traits : adjacency_vector_traits
+  {
+    using index_type = std::uint32_t;
+    using incidence_list = adjacency_vector_impl::basic_edge_list<std::uint32_t>;
+  };
+
+
 
   // ------------------------------------------------------------------------ //
   //                                                         [graph.adj_vec.dir]
@@ -181,12 +294,13 @@ namespace origin
     // separate edge container.
     //
     // Note that the class will compress the value type if it is empty.
-    template<typename V>
+    template<typename V, typename L = edge_list>
       struct vertex
       {
         using value_type = V;
-        using iterator = typename edge_list::iterator;
-        using const_iterator = typename edge_list::const_iterator;
+        using handle_type = typename L::value_type;
+        using iterator = typename L::iterator;
+        using const_iterator = typename L::const_iterator;
     
         vertex()
           : data()
@@ -194,24 +308,24 @@ namespace origin
 
         template<typename... Args>
           vertex(Args&&... args) 
-            : data(edge_list{}, edge_list{}, std::forward<Args>(args)...)
+            : data(L{}, L{}, std::forward<Args>(args)...)
           { }
 
         // Returns the out ege list
-        edge_list&       out()       { return std::get<0>(data); }
-        const edge_list& out() const { return std::get<0>(data); }
+        L&       out()       { return std::get<0>(data); }
+        const L& out() const { return std::get<0>(data); }
         
         // Returns the in edge list
-        edge_list&       in()       { return std::get<1>(data); }
-        const edge_list& in() const { return std::get<1>(data); }
+        L&       in()       { return std::get<1>(data); }
+        const L& in() const { return std::get<1>(data); }
 
         // Returns the user-supplied data object.
         V&       value()       { return std::get<2>(data); }
         const V& value() const { return std::get<2>(data); }
 
         // Edge insertion
-        void insert_out(edge_handle e) { insert_edge(out(), e); }
-        void insert_in(edge_handle e) { insert_edge(in(), e); }
+        void insert_out(handle_type e) { insert_edge(out(), e); }
+        void insert_in(handle_type e) { insert_edge(in(), e); }
 
         // Out edges
         std::size_t out_degree() const { return out().size(); }
@@ -231,60 +345,89 @@ namespace origin
 
 
         // Helper functions
-        void insert_edge(edge_list& l, edge_handle e);
+        void insert_edge(L& l, handle_type e);
 
       public:
-        std::tuple<edge_list, edge_list, V> data;
+        std::tuple<L, L, V> data;
       };
 
-    template<typename V>
+    template<typename V, typename L>
       inline void
-      vertex<V>::insert_edge(edge_list& l, edge_handle e)
+      vertex<V, L>::insert_edge(L& l, handle_type e)
       {
         l.push_back(e);
       }
 
     // A vertex set simply a vector of vertices.
-    template<typename V>
-      using vertex_set = std::vector<vertex<V>>;
+    template<typename V, typename L>
+      using vertex_set = std::vector<vertex<V, L>>;
 
     // An alias for the vertex iterator.
-    template<typename V>
-      using vertex_iterator = handle_counter<std::size_t, vertex_handle>;
+    template<typename V, typename I = std::size_t>
+      using vertex_iterator =
+        handle_counter<std::size_t, basic_vertex_handle<I>>;
 
     // An alias for the vertex range.
-    template<typename V>
-      using vertex_range = bounded_range<vertex_iterator<V>>;
+    template<typename V, typename I = std::size_t>
+      using vertex_range = bounded_range<vertex_iterator<V, I>>;
 
 
   } // namespace directed_adjacency_vector_impl
 
 
 
+  // Concurrent edge insertion, defined below.
+  template<typename G>
+    class concurrent_edge_inserter;
+
+
   // Implementation of a diretected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  template<typename V = empty_t,
+           typename E = empty_t,
+           typename T = adjacency_vector_traits>
     class directed_adjacency_vector
     {
-      using this_type = directed_adjacency_vector<V, E>;
-
-      using vertex_node = directed_adjacency_vector_impl::vertex<V>;
-      using vertex_set = directed_adjacency_vector_impl::vertex_set<V>;
-      using vertex_iter = directed_adjacency_vector_impl::vertex_iterator<V>;
+      using this_type = directed_adjacency_vector<V, E, T>;
+      using index_type = typename T::index_type;
+      using incidence_list = typename T::incidence_list;
+
+      static_assert(std::is_same<typename incidence_list::value_type,
+                                 basic_edge_handle<index_type>>::value,
+                    "incidence lists must store edge handles of the index type");
+
+      using vertex_node = directed_adjacency_vector_impl::vertex<V, incidence_list>;
+      using vertex_set = directed_adjacency_vector_impl::vertex_set<V, incidence_list>;
+      using vertex_iter =
+        directed_adjacency_vector_impl::vertex_iterator<V, index_type>;
+
+      using value_store = If<T::split_edge_values,
+                             adjacency_list_impl::split_values<E>,
+                             adjacency_list_impl::inline_values<E>>;
+      using record_value = typename value_store::record_value;
+
+      using edge_node = adjacency_vector_impl::edge<record_value, index_type>;
+      using edge_set = adjacency_vector_impl::edge_set<record_value, index_type>;
+      using edge_iter = adjacency_vector_impl::edge_iterator<E, index_type>;
+
+      using incidence_iter =
+        adjacency_vector_impl::incidence_iterator<incidence_list>;
+    public:
+      using vertex = basic_vertex_handle<index_type>;
+      using vertex_range =
+        directed_adjacency_vector_impl::vertex_range<V, index_type>;
 
-      using edge_node = adjacency_vector_impl::edge<E>;
-      using edge_set = adjacency_vector_impl::edge_set<E>;
-      using edge_iter = adjacency_vector_impl::edge_iterator<E>;
+      using edge = basic_edge_handle<index_type>;
+      using edge_range = adjacency_vector_impl::edge_range<E, index_type>;
 
-      using incidence_iter = adjacency_vector_impl::incidence_iterator;
-    public:
-      using vertex = vertex_handle;
-      using vertex_range = directed_adjacency_vector_impl::vertex_range<V>;
+      using incidence_range =
+        adjacency_vector_impl::incidence_range<incidence_list>;
 
-      using edge = edge_handle;
-      using edge_range = adjacency_vector_impl::edge_range<E>;
 
-      using incidence_range = adjacency_vector_impl::incidence_range;
+      directed_adjacency_vector() = default;
 
+      // Construct a graph with n default vertices and the edges in r.
+      template<typename R>
+        directed_adjacency_vector(std::size_t n, const R& r);
 
       // Observers
       bool        null() const  { return verts_.empty(); }
@@ -293,6 +436,10 @@ namespace origin
       bool        empty() const { return edges_.empty(); }
       std::size_t size() const  { return edges_.size(); }
 
+      // Handle bounds
+      std::size_t vertex_bound() const { return verts_.size(); }
+      std::size_t edge_bound() const   { return edges_.size(); }
+
       // Vertex observers
       std::size_t out_degree(vertex v) const { return node(v).out_degree(); }
       std::size_t in_degree(vertex v) const  { return node(v).in_degree(); }
@@ -306,8 +453,8 @@ namespace origin
       V&       operator()(vertex v)       { return node(v).value(); }
       const V& operator()(vertex v) const { return node(v).value(); }
 
-      E&       operator()(edge e)       { return get_edge(e).value(); }
-      const E& operator()(edge e) const { return get_edge(e).value(); }
+      E&       operator()(edge e)       { return values_.get(edges_, e); }
+      const E& operator()(edge e) const { return values_.get(edges_, e); }
 
       // Edge relation
       edge operator()(vertex u, vertex v) const;
@@ -328,6 +475,16 @@ namespace origin
       template<typename... Args>
         edge emplace_edge(vertex u, vertex v, Args&&...);
 
+      template<typename R>
+        void assign_edges(const R& r);
+
+      // Incidence order
+      // The graph is sorted when the out edges of each vertex are ordered by
+      // target and its in edges by source. The edge relation of a sorted
+      // graph is a binary search.
+      bool sorted() const { return sorted_; }
+      void sort_adjacency();
+
       // Iterators
       vertex_range    vertices() const;
       edge_range      edges() const;
@@ -335,6 +492,8 @@ namespace origin
       incidence_range in_edges(vertex v) const;
 
     private:
+      friend class concurrent_edge_inserter<this_type>;
+
       vertex_node&       node(vertex v)       { return verts_[v]; }
       const vertex_node& node(vertex v) const { return verts_[v]; }
 
@@ -349,44 +508,65 @@ namespace origin
         edge find_edge(const S& seq, P pred) const;
 
       void link_edge(vertex u, vertex v, edge e);
+      void append_edge(vertex u, vertex v, edge e);
+
+      // Helper functions for neighbor indexing.
+      static constexpr bool hashing() { return T::hash_threshold != 0; }
+
+      void index_edge(vertex u, vertex v, edge e);
 
     private:
       vertex_set verts_;
       edge_set   edges_;
+      value_store values_; // Edge values, if split
+      adjacency_list_impl::neighbor_index index_; // Out edges by target
+      bool sorted_ = true; // True if the incidence lists are sorted
     };
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::operator()(vertex u, vertex v) const -> edge
+    directed_adjacency_vector<V, E, T>::operator()(vertex u, vertex v) const -> edge
     {
+      if (hashing() && index_.indexed(u))
+        return index_.find(u, v);
       if (out_degree(u) <= in_degree(v))
         return find_out_edge(u, v);
       else
         return find_in_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::find_out_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_vector<V, E, T>::find_out_edge(vertex u, vertex v) const -> edge
     {
       using P = has_target<this_type>;
       const vertex_node& n = node(u);
+      if (sorted()) {
+        auto key = [this](edge e) -> std::size_t { return target(e); };
+        auto i = adjacency_list_impl::find_sorted(n.out(), v, key);
+        return i == n.out().end() ? edge() : *i;
+      }
       return find_edge(n.out(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::find_in_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_vector<V, E, T>::find_in_edge(vertex u, vertex v) const -> edge
     {
       using P = has_source<this_type>;
       const vertex_node& n = node(v);
+      if (sorted()) {
+        auto key = [this](edge e) -> std::size_t { return source(e); };
+        auto i = adjacency_list_impl::find_sorted(n.in(), u, key);
+        return i == n.in().end() ? edge() : *i;
+      }
       return find_edge(n.in(), P(*this, u));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename S, typename P>
     inline auto
-    directed_adjacency_vector<V, E>::find_edge(const S& seq, P pred) const -> edge
+    directed_adjacency_vector<V, E, T>::find_edge(const S& seq, P pred) const -> edge
     {
       auto i = find_if(seq, pred);
       return i == seq.end() ? edge() : *i;
@@ -394,32 +574,33 @@ namespace origin
 
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::add_vertex() -> vertex
+    directed_adjacency_vector<V, E, T>::add_vertex() -> vertex
     {
       return emplace_vertex();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::add_vertex(V&& x) -> vertex
+    directed_adjacency_vector<V, E, T>::add_vertex(V&& x) -> vertex
     {
       return emplace_vertex(std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::add_vertex(const V& x) -> vertex
+    directed_adjacency_vector<V, E, T>::add_vertex(const V& x) -> vertex
     {
       return emplace_vertex(x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename... Args>
       inline auto
-      directed_adjacency_vector<V, E>::emplace_vertex(Args&&... args) -> vertex
+      directed_adjacency_vector<V, E, T>::emplace_vertex(Args&&... args) -> vertex
       {
+        assert(verts_.size() < std::size_t(index_type(-1)));
         vertex n = verts_.size();
         verts_.emplace_back(std::forward<Args>(args)...);
         return n;
@@ -427,81 +608,197 @@ namespace origin
 
 
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::add_edge(vertex u, vertex v) -> edge
+    directed_adjacency_vector<V, E, T>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    directed_adjacency_vector<V, E, T>::add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::
+    directed_adjacency_vector<V, E, T>::
       add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename... Args>
       inline auto
-      directed_adjacency_vector<V, E>::
+      directed_adjacency_vector<V, E, T>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
-        edge e = edges_.size();
-        edges_.emplace_back(u, v, std::forward<Args>(args)...);
+        assert(edges_.size() < std::size_t(index_type(-1)));
+        edge e = values_.insert(edges_, u, v, std::forward<Args>(args)...);
         link_edge(u, v, e);
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
+    inline void
+    directed_adjacency_vector<V, E, T>::link_edge(vertex u, vertex v, edge e)
+    {
+      if (!T::sorted_incidence) {
+        append_edge(u, v, e);
+        return;
+      }
+      auto by_target = [this](edge x) -> std::size_t { return target(x); };
+      auto by_source = [this](edge x) -> std::size_t { return source(x); };
+      adjacency_list_impl::insert_sorted(node(u).out(), e, v, by_target);
+      adjacency_list_impl::insert_sorted(node(v).in(), e, u, by_source);
+      if (hashing())
+        index_edge(u, v, e);
+    }
+
+  // Append the edge e to the incidence lists of its endpoints, noting whether
+  // the lists remain sorted.
+  template<typename V, typename E, typename T>
     inline void
-    directed_adjacency_vector<V, E>::link_edge(vertex u, vertex v, edge e)
+    directed_adjacency_vector<V, E, T>::append_edge(vertex u, vertex v, edge e)
     {
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
+      auto by_target = [this](edge x) -> std::size_t { return target(x); };
+      auto by_source = [this](edge x) -> std::size_t { return source(x); };
+      sorted_ = sorted_
+             && adjacency_list_impl::extends_sorted(un.out(), v, by_target)
+             && adjacency_list_impl::extends_sorted(vn.in(), u, by_source);
       un.insert_out(e);
       vn.insert_in(e);
+      if (hashing())
+        index_edge(u, v, e);
+    }
+
+  // Record the edge e from u to v in the neighbor table of u. The table is
+  // built when the out degree of u reaches the threshold.
+  template<typename V, typename E, typename T>
+    void
+    directed_adjacency_vector<V, E, T>::index_edge(vertex u, vertex v, edge e)
+    {
+      if (index_.indexed(u)) {
+        index_.insert(u, v, e);
+      } else if (out_degree(u) >= T::hash_threshold) {
+        index_.build(u, out_degree(u));
+        for (edge x : node(u).out())
+          index_.insert(u, target(x), x);
+      }
+    }
+
+  template<typename V, typename E, typename T>
+    template<typename R>
+      inline
+      directed_adjacency_vector<V, E, T>::
+        directed_adjacency_vector(std::size_t n, const R& r)
+          : verts_(n)
+      {
+        assign_edges(r);
+      }
+
+  // Replace the edge set of the graph with the edge tuples in r. Edge handles
+  // are assigned in the order of the range. The endpoints of every edge must
+  // be vertices in the graph, and r must be a multipass range.
+  //
+  // The edges are loaded in two passes over r. The first pass computes the
+  // degrees of each vertex so that every incidence list can be allocated
+  // exactly, and the second fills the lists. Loading is linear in the size
+  // of r, and requires only O(V) allocations. If the traits class requires
+  // sorted incidence lists, they are sorted once at the end.
+  template<typename V, typename E, typename T>
+    template<typename R>
+      void
+      directed_adjacency_vector<V, E, T>::assign_edges(const R& r)
+      {
+        using namespace adjacency_vector_impl;
+
+        std::vector<std::size_t> outs(order(), 0);
+        std::vector<std::size_t> ins(order(), 0);
+        std::size_t m = 0;
+        for (const auto& x : r) {
+          assert(tuple_source(x) < order() && tuple_target(x) < order());
+          ++outs[tuple_source(x)];
+          ++ins[tuple_target(x)];
+          ++m;
+        }
+
+        for (std::size_t i = 0; i < order(); ++i) {
+          vertex_node& n = verts_[i];
+          n.out().clear();
+          n.out().reserve(outs[i]);
+          n.in().clear();
+          n.in().reserve(ins[i]);
+        }
+
+        assert(m < std::size_t(index_type(-1)));
+        edges_.clear();
+        values_.clear();
+        index_.clear();
+        sorted_ = true;
+        edges_.reserve(m);
+        values_.reserve(m);
+        for (const auto& x : r) {
+          using X = Decay<decltype(x)>;
+          edge e = values_.insert(edges_, tuple_source(x), tuple_target(x),
+                                  tuple_value<E, X>(x));
+          append_edge(tuple_source(x), tuple_target(x), e);
+        }
+        if (T::sorted_incidence)
+          sort_adjacency();
+      }
+
+  // Sort the out edges of each vertex by target and its in edges by source.
+  // Edges with the same endpoints keep their relative order.
+  template<typename V, typename E, typename T>
+    void
+    directed_adjacency_vector<V, E, T>::sort_adjacency()
+    {
+      auto by_target = [this](edge x) -> std::size_t { return target(x); };
+      auto by_source = [this](edge x) -> std::size_t { return source(x); };
+      for (vertex_node& n : verts_) {
+        adjacency_list_impl::sort_incidence(n.out(), by_target);
+        adjacency_list_impl::sort_incidence(n.in(), by_source);
+      }
+      sorted_ = true;
     }
 
 
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::vertices() const -> vertex_range
+    directed_adjacency_vector<V, E, T>::vertices() const -> vertex_range
     {
-      return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
+      return {vertex_iter(0), vertex_iter(verts_.size())};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::edges() const -> edge_range
+    directed_adjacency_vector<V, E, T>::edges() const -> edge_range
     {
-      return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
+      return {edge_iter(0), edge_iter(edges_.size())};
     }
 
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::out_edges(vertex v) const -> incidence_range
+    directed_adjacency_vector<V, E, T>::out_edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin_out()), incidence_iter(vn.end_out())};
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    directed_adjacency_vector<V, E>::in_edges(vertex v) const -> incidence_range
+    directed_adjacency_vector<V, E, T>::in_edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin_in()), incidence_iter(vn.end_in())};
@@ -509,6 +806,236 @@ namespace origin
 
 
 
+  // ------------------------------------------------------------------------ //
+  //                                                    [graph.adj_vec.insert]
+  //                        Concurrent Edge Insertion
+  //
+  // A concurrent edge inserter lets a team of threads add edges to a
+  // directed adjacency vector at the same time. Each thread has an index t
+  // and appends to its own buffer. The handle of each edge is reserved from
+  // an atomic counter when it is added, so handles are unique and dense, and
+  // add_edge returns the handle the edge will have in the graph.
+  //
+  // Buffered edges are not part of the graph until they are published. The
+  // graph itself is not modified by add_edge, so it may be read while edges
+  // are added. Publishing must not be concurrent with any use of the graph
+  // or the inserter, and must follow the completion of every add_edge call,
+  // for example by joining the threads that add edges.
+  //
+  // Publishing runs in three phases on a team of threads, separated by
+  // barriers. First, each thread writes the records of its buffer into the
+  // edge vector, which has been extended to the new size. Second, each thread
+  // takes a range of new edge handles and sorts them into buckets by the
+  // thread that owns their source and target, where each thread owns a
+  // contiguous block of vertices. Third, each thread appends the edges of
+  // its buckets to the incidence lists of the vertices it owns. Because the
+  // buckets are filled and emptied in handle order, each incidence list
+  // ends in the same order as if the edges had been added one at a time, in
+  // order of their handles.
+  template<typename V, typename E, typename T>
+    class concurrent_edge_inserter<directed_adjacency_vector<V, E, T>>
+    {
+      using graph_type = directed_adjacency_vector<V, E, T>;
+    public:
+      using vertex = typename graph_type::vertex;
+      using edge = typename graph_type::edge;
+
+      // Create an inserter adding edges to g from the given number of
+      // threads. If threads is 0, the hardware concurrency is used.
+      explicit concurrent_edge_inserter(graph_type& g, std::size_t threads = 0);
+
+      std::size_t threads() const { return buffers_.size(); }
+
+      // Returns the number of edges added but not yet published.
+      std::size_t pending() const { return next_ - g_.size(); }
+
+      // Add an edge from u to v on behalf of thread t. The vertices must be
+      // in the graph. Returns the handle of the new edge.
+      edge add_edge(std::size_t t, vertex u, vertex v) { return emplace_edge(t, u, v); }
+      edge add_edge(std::size_t t, vertex u, vertex v, E&& x);
+      edge add_edge(std::size_t t, vertex u, vertex v, const E& x);
+
+      template<typename... Args>
+        edge emplace_edge(std::size_t t, vertex u, vertex v, Args&&... args);
+
+      // Add the buffered edges to the graph.
+      void publish();
+
+    private:
+      struct record
+      {
+        template<typename... Args>
+          record(edge e, vertex u, vertex v, Args&&... args)
+            : e(e), u(u), v(v), value(std::forward<Args>(args)...)
+          { }
+
+        edge e;
+        vertex u;
+        vertex v;
+        E value;
+      };
+
+      // A buffer, aligned so that buffers of different threads do not share
+      // a cache line.
+      struct alignas(parallel_impl::cache_line) buffer
+      {
+        std::vector<record> records;
+      };
+
+      void link(std::size_t t, std::size_t base,
+                std::vector<std::vector<std::vector<edge>>>& outs,
+                std::vector<std::vector<std::vector<edge>>>& ins,
+                std::vector<char>& touched, char& sorted,
+                parallel_impl::barrier& sync);
+
+    private:
+      graph_type& g_;
+      std::vector<buffer, parallel_impl::cache_aligned_allocator<buffer>> buffers_;
+      std::atomic<std::size_t> next_;
+    };
+
+  template<typename V, typename E, typename T>
+    inline
+    concurrent_edge_inserter<directed_adjacency_vector<V, E, T>>::
+      concurrent_edge_inserter(graph_type& g, std::size_t threads)
+        : g_(g), buffers_(parallel_impl::team_size(threads)), next_(g.size())
+    { }
+
+  template<typename V, typename E, typename T>
+    inline auto
+    concurrent_edge_inserter<directed_adjacency_vector<V, E, T>>::
+      add_edge(std::size_t t, vertex u, vertex v, E&& x) -> edge
+    {
+      return emplace_edge(t, u, v, std::move(x));
+    }
+
+  template<typename V, typename E, typename T>
+    inline auto
+    concurrent_edge_inserter<directed_adjacency_vector<V, E, T>>::
+      add_edge(std::size_t t, vertex u, vertex v, const E& x) -> edge
+    {
+      return emplace_edge(t, u, v, x);
+    }
+
+  template<typename V, typename E, typename T>
+    template<typename... Args>
+      inline auto
+      concurrent_edge_inserter<directed_adjacency_vector<V, E, T>>::
+        emplace_edge(std::size_t t, vertex u, vertex v, Args&&... args) -> edge
+      {
+        assert(t < buffers_.size());
+        assert(std::size_t(u) < g_.order() && std::size_t(v) < g_.order());
+        edge e = next_.fetch_add(1, std::memory_order_relaxed);
+        assert(std::size_t(e) < std::size_t(typename T::index_type(-1)));
+        buffers_[t].records.emplace_back(e, u, v, std::forward<Args>(args)...);
+        return e;
+      }
+
+  template<typename V, typename E, typename T>
+    void
+    concurrent_edge_inserter<directed_adjacency_vector<V, E, T>>::publish()
+    {
+      std::size_t base = g_.size();
+      std::size_t total = next_;
+      if (total == base)
+        return;
+
+      std::size_t k = buffers_.size();
+      g_.edges_.resize(total);
+      g_.values_.resize(total);
+      std::vector<std::vector<std::vector<edge>>> outs(k, std::vector<std::vector<edge>>(k));
+      std::vector<std::vector<std::vector<edge>>> ins(k, std::vector<std::vector<edge>>(k));
+      std::vector<char> touched(g_.order(), 0);
+      std::vector<char> sorted(k, 1);
+      parallel_impl::barrier sync(k);
+      parallel_impl::run_team(k, [&](std::size_t t) {
+        for (record& x : buffers_[t].records)
+          g_.values_.assign(g_.edges_, x.e, x.u, x.v, std::move(x.value));
+        std::vector<record>().swap(buffers_[t].records);
+        sync.wait();
+        link(t, base, outs, ins, touched, sorted[t], sync);
+      });
+      for (char s : sorted)
+        g_.sorted_ = g_.sorted_ && s;
+
+      // Neighbor tables are shared by all vertices, so they are updated
+      // after the team has finished.
+      if (graph_type::hashing()) {
+        for (std::size_t i = 0; i < touched.size(); ++i) {
+          if (!touched[i])
+            continue;
+          vertex u = i;
+          auto& out = g_.node(u).out();
+          if (g_.index_.indexed(u)) {
+            for (edge x : out)
+              if (std::size_t(x) >= base)
+                g_.index_.insert(u, g_.target(x), x);
+          } else if (out.size() >= T::hash_threshold) {
+            g_.index_.build(u, out.size());
+            for (edge x : out)
+              g_.index_.insert(u, g_.target(x), x);
+          }
+        }
+      }
+    }
+
+  // Bucket a block of the new edges by the owners of their endpoints, then
+  // append the buckets of the vertices owned by thread t to their lists.
+  template<typename V, typename E, typename T>
+    void
+    concurrent_edge_inserter<directed_adjacency_vector<V, E, T>>::
+      link(std::size_t t, std::size_t base,
+           std::vector<std::vector<std::vector<edge>>>& outs,
+           std::vector<std::vector<std::vector<edge>>>& ins,
+           std::vector<char>& touched, char& sorted,
+           parallel_impl::barrier& sync)
+    {
+      std::size_t k = buffers_.size();
+      std::size_t n = g_.order();
+      std::size_t m = g_.size() - base;
+      auto owner = [k, n](std::size_t v) { return v * k / n; };
+      for (std::size_t e = base + m * t / k; e < base + m * (t + 1) / k; ++e) {
+        outs[t][owner(g_.source(e))].push_back(e);
+        ins[t][owner(g_.target(e))].push_back(e);
+      }
+      sync.wait();
+
+      auto by_target = [this](edge x) -> std::size_t { return g_.target(x); };
+      auto by_source = [this](edge x) -> std::size_t { return g_.source(x); };
+      for (std::size_t s = 0; s < k; ++s) {
+        for (edge e : outs[s][t]) {
+          vertex u = g_.source(e);
+          auto& out = g_.node(u).out();
+          if (sorted)
+            sorted = adjacency_list_impl::extends_sorted(out, g_.target(e), by_target);
+          out.push_back(e);
+          touched[u] = 1;
+        }
+        for (edge e : ins[s][t]) {
+          vertex v = g_.target(e);
+          auto& in = g_.node(v).in();
+          if (sorted)
+            sorted = adjacency_list_impl::extends_sorted(in, g_.source(e), by_source);
+          in.push_back(e);
+          touched[v] = 1;
+        }
+      }
+
+      if (T::sorted_incidence) {
+        std::size_t first = (t * n + k - 1) / k;
+        std::size_t last = ((t + 1) * n + k - 1) / k;
+        for (std::size_t v = first; v < last; ++v) {
+          if (touched[v]) {
+            adjacency_list_impl::sort_incidence(g_.node(v).out(), by_target);
+            adjacency_list_impl::sort_incidence(g_.node(v).in(), by_source);
+          }
+        }
+        sorted = 1;
+      }
+    }
+
+
+
   // ------------------------------------------------------------------------ //
   //                                                      [graph.adj_list.undir]
   //                        Undirected Adjacency List
@@ -525,12 +1052,13 @@ namespace origin
     
     // A vertex in an undirected adjacency list is simply a list of incident
     // edges. No distinction is made between in or out edges.
-    template<typename V>
+    template<typename V, typename L = edge_list>
       struct vertex
       {
         using value_type = V;
-        using iterator = typename edge_list::iterator;
-        using const_iterator = typename edge_list::const_iterator;
+        using handle_type = typename L::value_type;
+        using iterator = typename L::iterator;
+        using const_iterator = typename L::const_iterator;
     
         vertex()
           : data()
@@ -538,12 +1066,12 @@ namespace origin
 
         template<typename... Args>
           vertex(Args&&... args) 
-            : data(edge_list{}, std::forward<Args>(args)...)
+            : data(L{}, std::forward<Args>(args)...)
           { }
 
         // Returns the out ege list
-        edge_list&       edges()       { return std::get<0>(data); }
-        const edge_list& edges() const { return std::get<0>(data); }
+        L&       edges()       { return std::get<0>(data); }
+        const L& edges() const { return std::get<0>(data); }
         
         // Returns the user-supplied data object.
         V&       value()       { return std::get<1>(data); }
@@ -552,7 +1080,7 @@ namespace origin
         // Out edges
         std::size_t degree() const { return edges().size(); }
 
-        void insert(edge_handle e);
+        void insert(handle_type e);
 
         iterator begin() { return edges().begin(); }
         iterator end()   { return edges().end(); }
@@ -560,55 +1088,79 @@ namespace origin
         const_iterator end() const   { return edges().end(); }
 
       public:
-        std::tuple<edge_list, V> data;
+        std::tuple<L, V> data;
       };
 
-    template<typename V>
+    template<typename V, typename L>
       inline void
-      vertex<V>::insert(edge_handle e)
+      vertex<V, L>::insert(handle_type e)
       {
         edges().push_back(e);
       }
 
     // A vertex set is a vector of vertices.
-    template<typename V>
-      using vertex_set = std::vector<vertex<V>>;
+    template<typename V, typename L>
+      using vertex_set = std::vector<vertex<V, L>>;
 
     // An alias for the vertex iterator.
-    template<typename V>
-      using vertex_iterator = handle_counter<vertex_set<V>, vertex_handle>;
+    template<typename V, typename I = std::size_t>
+      using vertex_iterator =
+        handle_counter<std::size_t, basic_vertex_handle<I>>;
 
     // An alias for the vertex range.
-    template<typename V>
-      using vertex_range = bounded_range<vertex_iterator<V>>;
+    template<typename V, typename I = std::size_t>
+      using vertex_range = bounded_range<vertex_iterator<V, I>>;
 
   } // namespace undirected_adjacency_vector_impl
 
 
   // Implementation of the undirected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  template<typename V = empty_t,
+           typename E = empty_t,
+           typename T = adjacency_vector_traits>
     class undirected_adjacency_vector
     {
-      using this_type = undirected_adjacency_vector<V, E>;
-
-      using vertex_node = undirected_adjacency_vector_impl::vertex<V>;
-      using vertex_set = undirected_adjacency_vector_impl::vertex_set<V>;
-      using vertex_iter = undirected_adjacency_vector_impl::vertex_iterator<V>;
+      using this_type = undirected_adjacency_vector<V, E, T>;
+      using index_type = typename T::index_type;
+      using incidence_list = typename T::incidence_list;
+
+      static_assert(std::is_same<typename incidence_list::value_type,
+                                 basic_edge_handle<index_type>>::value,
+                    "incidence lists must store edge handles of the index type");
+
+      using vertex_node = undirected_adjacency_vector_impl::vertex<V, incidence_list>;
+      using vertex_set = undirected_adjacency_vector_impl::vertex_set<V, incidence_list>;
+      using vertex_iter =
+        undirected_adjacency_vector_impl::vertex_iterator<V, index_type>;
+
+      using value_store = If<T::split_edge_values,
+                             adjacency_list_impl::split_values<E>,
+                             adjacency_list_impl::inline_values<E>>;
+      using record_value = typename value_store::record_value;
+
+      using edge_node = adjacency_vector_impl::edge<record_value, index_type>;
+      using edge_set = adjacency_vector_impl::edge_set<record_value, index_type>;
+      using edge_iter = adjacency_vector_impl::edge_iterator<E, index_type>;
+
+      using incidence_iter =
+        adjacency_vector_impl::incidence_iterator<incidence_list>;
+    public:
+      using vertex = basic_vertex_handle<index_type>;
+      using vertex_range =
+        undirected_adjacency_vector_impl::vertex_range<V, index_type>;
 
-      using edge_node = adjacency_vector_impl::edge<E>;
-      using edge_set = adjacency_vector_impl::edge_set<E>;
-      using edge_iter = adjacency_vector_impl::edge_iterator<E>;
+      using edge = basic_edge_handle<index_type>;
+      using edge_range = adjacency_vector_impl::edge_range<E, index_type>;
 
-      using incidence_iter = adjacency_vector_impl::incidence_iterator;
-    public:
-      using vertex = vertex_handle;
-      using vertex_range = undirected_adjacency_vector_impl::vertex_range<V>;
+      using incidence_range =
+        adjacency_vector_impl::incidence_range<incidence_list>;
 
-      using edge = edge_handle;
-      using edge_range = adjacency_vector_impl::edge_range<E>;
 
-      using incidence_range = adjacency_vector_impl::incidence_range;
+      undirected_adjacency_vector() = default;
 
+      // Construct a graph with n default vertices and the edges in r.
+      template<typename R>
+        undirected_adjacency_vector(std::size_t n, const R& r);
 
       // Observers
       bool        null() const  { return verts_.empty(); }
@@ -617,6 +1169,10 @@ namespace origin
       bool        empty() const { return edges_.empty(); }
       std::size_t size() const  { return edges_.size(); }
 
+      // Handle bounds
+      std::size_t vertex_bound() const { return verts_.size(); }
+      std::size_t edge_bound() const   { return edges_.size(); }
+
       // Vertex observers
       std::size_t degree(vertex v) const { return node(v).degree(); }
 
@@ -632,8 +1188,8 @@ namespace origin
       V&       operator()(vertex v)       { return node(v).value(); }
       const V& operator()(vertex v) const { return node(v).value(); }
 
-      E&       operator()(edge e)       { return get_edge(e).value(); }
-      const E& operator()(edge e) const { return get_edge(e).value(); }
+      E&       operator()(edge e)       { return values_.get(edges_, e); }
+      const E& operator()(edge e) const { return values_.get(edges_, e); }
 
       // Relation
       edge operator()(vertex u, vertex v) const;
@@ -654,6 +1210,16 @@ namespace origin
       template<typename... Args>
         edge emplace_edge(vertex u, vertex v, Args&&... args);
 
+      template<typename R>
+        void assign_edges(const R& r);
+
+      // Incidence order
+      // The graph is sorted when the incident edges of each vertex are
+      // ordered by their opposite endpoints. The edge relation of a sorted
+      // graph is a binary search.
+      bool sorted() const { return sorted_; }
+      void sort_adjacency();
+
       // Iterators
       vertex_range    vertices() const;
       edge_range      edges() const;
@@ -673,17 +1239,30 @@ namespace origin
         edge find_endpoints(const S& seq, P pred) const;
 
       void link_edge(vertex u, vertex v, edge e);
+      void append_edge(vertex u, vertex v, edge e);
+
+      // Helper functions for neighbor indexing.
+      static constexpr bool hashing() { return T::hash_threshold != 0; }
+
+      void index_edge(vertex u, vertex v, edge e);
     
     private:
       vertex_set verts_;
       edge_set   edges_;
+      value_store values_; // Edge values, if split
+      adjacency_list_impl::neighbor_index index_; // Edges by opposite end
+      bool sorted_ = true; // True if the incidence lists are sorted
     };
 
   // Returns true if the an edge {u, v} is in the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::operator()(vertex u, vertex v) const -> edge
+    undirected_adjacency_vector<V, E, T>::operator()(vertex u, vertex v) const -> edge
     {
+      if (hashing() && index_.indexed(u))
+        return index_.find(u, v);
+      if (hashing() && index_.indexed(v))
+        return index_.find(v, u);
       if (degree(u) <= degree(v))
         return find_edge(u, v);
       else
@@ -695,22 +1274,27 @@ namespace origin
   //
   // Note that, if u and v are connected, then the edge was added as either
   // (u, v) or (v, u). We prefer to search the vertex with the smaller degree
-  // for evidence of either construction.
-  template<typename V, typename E>
+  // for evidence of either construction, which the caller passes as u.
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::find_edge(vertex u, vertex v) const -> edge
+    undirected_adjacency_vector<V, E, T>::find_edge(vertex u, vertex v) const -> edge
     {
       using P = has_endpoints<this_type>;
-      const vertex_node& n = node(v);
+      const vertex_node& n = node(u);
+      if (sorted()) {
+        auto key = [this, u](edge e) -> std::size_t { return opposite(*this, e, u); };
+        auto i = adjacency_list_impl::find_sorted(n.edges(), v, key);
+        return i == n.edges().end() ? edge() : *i;
+      }
       return find_endpoints(n.edges(), P(*this, u, v));
     }
 
   // Return an edge whose endpoints satisfy the given predicate. The primary
   // function of this operation is to find endpoints with source/target pairs.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename S, typename P>
       inline auto
-      undirected_adjacency_vector<V, E>::
+      undirected_adjacency_vector<V, E, T>::
         find_endpoints(const S& seq, P pred) const -> edge
         {
           auto i = find_if(seq, pred);
@@ -720,103 +1304,220 @@ namespace origin
 
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::add_vertex() -> vertex
+    undirected_adjacency_vector<V, E, T>::add_vertex() -> vertex
     {
       return emplace_vertex();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::add_vertex(V&& x) -> vertex
+    undirected_adjacency_vector<V, E, T>::add_vertex(V&& x) -> vertex
     {
       return emplace_vertex(std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::add_vertex(const V& x) -> vertex
+    undirected_adjacency_vector<V, E, T>::add_vertex(const V& x) -> vertex
     {
       return emplace_vertex(x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename... Args>
       inline auto
-      undirected_adjacency_vector<V, E>::emplace_vertex(Args&&... args) -> vertex
+      undirected_adjacency_vector<V, E, T>::emplace_vertex(Args&&... args) -> vertex
       {
+        assert(verts_.size() < std::size_t(index_type(-1)));
         vertex v = verts_.size();
         verts_.emplace_back(std::forward<Args>(args)...);
         return v;
       }
 
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::add_edge(vertex u, vertex v) -> edge
+    undirected_adjacency_vector<V, E, T>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    undirected_adjacency_vector<V, E, T>::add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::add_edge(vertex u, vertex v, const E& x) -> edge
+    undirected_adjacency_vector<V, E, T>::add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     template<typename... Args>
       inline auto
-      undirected_adjacency_vector<V, E>::
+      undirected_adjacency_vector<V, E, T>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
-        edge e = edges_.size();
-        edges_.emplace_back(u, v, std::forward<Args>(args)...);
+        assert(edges_.size() < std::size_t(index_type(-1)));
+        edge e = values_.insert(edges_, u, v, std::forward<Args>(args)...);
         link_edge(u, v, e);
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
+    inline void
+    undirected_adjacency_vector<V, E, T>::link_edge(vertex u, vertex v, edge e)
+    {
+      if (!T::sorted_incidence) {
+        append_edge(u, v, e);
+        return;
+      }
+      auto from_u = [this, u](edge x) -> std::size_t { return opposite(*this, x, u); };
+      auto from_v = [this, v](edge x) -> std::size_t { return opposite(*this, x, v); };
+      adjacency_list_impl::insert_sorted(node(u).edges(), e, v, from_u);
+      adjacency_list_impl::insert_sorted(node(v).edges(), e, u, from_v);
+      if (hashing()) {
+        index_edge(u, v, e);
+        if (u != v)
+          index_edge(v, u, e);
+      }
+    }
+
+  // Append the edge e to the incidence lists of its endpoints, noting whether
+  // the lists remain sorted.
+  template<typename V, typename E, typename T>
     inline void
-    undirected_adjacency_vector<V, E>::link_edge(vertex u, vertex v, edge e)
+    undirected_adjacency_vector<V, E, T>::append_edge(vertex u, vertex v, edge e)
     {
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
+      auto from_u = [this, u](edge x) -> std::size_t { return opposite(*this, x, u); };
+      auto from_v = [this, v](edge x) -> std::size_t { return opposite(*this, x, v); };
+      sorted_ = sorted_
+             && adjacency_list_impl::extends_sorted(un.edges(), v, from_u)
+             && adjacency_list_impl::extends_sorted(vn.edges(), u, from_v);
       un.insert(e);
       vn.insert(e);
+      if (hashing()) {
+        index_edge(u, v, e);
+        if (u != v)
+          index_edge(v, u, e);
+      }
+    }
+
+  // Record the edge e connecting u to v in the neighbor table of u. The table
+  // is built when the degree of u reaches the threshold. A loop is counted
+  // twice, as in the incidence list.
+  template<typename V, typename E, typename T>
+    void
+    undirected_adjacency_vector<V, E, T>::index_edge(vertex u, vertex v, edge e)
+    {
+      if (index_.indexed(u)) {
+        index_.insert(u, v, e);
+        if (u == v)
+          index_.insert(u, v, e);
+      } else if (degree(u) >= T::hash_threshold) {
+        index_.build(u, degree(u));
+        for (edge x : node(u).edges())
+          index_.insert(u, opposite(*this, x, u), x);
+      }
+    }
+
+  template<typename V, typename E, typename T>
+    template<typename R>
+      inline
+      undirected_adjacency_vector<V, E, T>::
+        undirected_adjacency_vector(std::size_t n, const R& r)
+          : verts_(n)
+      {
+        assign_edges(r);
+      }
+
+  // Replace the edge set of the graph with the edge tuples in r. This is the
+  // same as the directed version, except that each edge is counted in the
+  // degree of both endpoints. Note that a loop is counted twice.
+  template<typename V, typename E, typename T>
+    template<typename R>
+      void
+      undirected_adjacency_vector<V, E, T>::assign_edges(const R& r)
+      {
+        using namespace adjacency_vector_impl;
+
+        std::vector<std::size_t> degs(order(), 0);
+        std::size_t m = 0;
+        for (const auto& x : r) {
+          assert(tuple_source(x) < order() && tuple_target(x) < order());
+          ++degs[tuple_source(x)];
+          ++degs[tuple_target(x)];
+          ++m;
+        }
+
+        for (std::size_t i = 0; i < order(); ++i) {
+          vertex_node& n = verts_[i];
+          n.edges().clear();
+          n.edges().reserve(degs[i]);
+        }
+
+        assert(m < std::size_t(index_type(-1)));
+        edges_.clear();
+        values_.clear();
+        index_.clear();
+        sorted_ = true;
+        edges_.reserve(m);
+        values_.reserve(m);
+        for (const auto& x : r) {
+          using X = Decay<decltype(x)>;
+          edge e = values_.insert(edges_, tuple_source(x), tuple_target(x),
+                                  tuple_value<E, X>(x));
+          append_edge(tuple_source(x), tuple_target(x), e);
+        }
+        if (T::sorted_incidence)
+          sort_adjacency();
+      }
+
+  // Sort the incident edges of each vertex by their opposite endpoints.
+  // Edges with the same endpoints keep their relative order.
+  template<typename V, typename E, typename T>
+    void
+    undirected_adjacency_vector<V, E, T>::sort_adjacency()
+    {
+      for (std::size_t v = 0; v < order(); ++v) {
+        auto key = [this, v](edge x) -> std::size_t {
+          return opposite(*this, x, vertex(v));
+        };
+        adjacency_list_impl::sort_incidence(node(v).edges(), key);
+      }
+      sorted_ = true;
     }
 
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::vertices() const -> vertex_range
+    undirected_adjacency_vector<V, E, T>::vertices() const -> vertex_range
     {
-      return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
+      return {vertex_iter(0), vertex_iter(verts_.size())};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::edges() const -> edge_range
+    undirected_adjacency_vector<V, E, T>::edges() const -> edge_range
     {
-      return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
+      return {edge_iter(0), edge_iter(edges_.size())};
     }
 
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename T>
     inline auto
-    undirected_adjacency_vector<V, E>::edges(vertex v) const -> incidence_range
+    undirected_adjacency_vector<V, E, T>::edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin()), incidence_iter(vn.end())};
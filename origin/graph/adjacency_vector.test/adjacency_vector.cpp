@@ -27,4 +27,15 @@ int main()
   check_default_init<D>();
   check_add_vertices<D>();
   check_add_edges<D>();
+
+  using T = small_adjacency_vector_traits<2>;
+  using SG = undirected_adjacency_vector<char, int, T>;
+  check_default_init<SG>();
+  check_add_vertices<SG>();
+  check_add_edges<SG>();
+
+  using SD = directed_adjacency_vector<char, int, T>;
+  check_default_init<SD>();
+  check_add_vertices<SD>();
+  check_add_edges<SD>();
 }
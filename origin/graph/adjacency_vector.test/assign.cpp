@@ -0,0 +1,73 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Check that bulk loading a list of valued edges produces the same graph as
+// adding the edges one at a time.
+template<typename G>
+  void
+  check_assign_values()
+  {
+    cout << "*** assign values (" << typestr<G>() << ") ***\n";
+    vector<tuple<int, int, int>> es {
+      make_tuple(0, 1, 10), make_tuple(0, 2, 20), make_tuple(1, 2, 30),
+      make_tuple(2, 2, 40), make_tuple(2, 0, 50)
+    };
+
+    G g(3, es);
+    assert(g.order() == 3);
+    assert(g.size() == es.size());
+    for (size_t i = 0; i < es.size(); ++i) {
+      Edge<G> e = i;
+      assert(g.source(e) == Vertex<G>(get<0>(es[i])));
+      assert(g.target(e) == Vertex<G>(get<1>(es[i])));
+      assert(g(e) == get<2>(es[i]));
+    }
+    assert(g(g(1, 2)) == 30);
+    assert(has_degrees(g, 0, {2, 1, 3}));
+    assert(has_degrees(g, 2, {2, 3, 5}));
+  }
+
+// Check that loading pairs default constructs edge values, and that the
+// bulk load replaces any existing edges.
+template<typename G>
+  void
+  check_assign_pairs()
+  {
+    cout << "*** assign pairs (" << typestr<G>() << ") ***\n";
+    G g = build_reflexive_clique<G>(3);
+    vector<pair<int, int>> es {{0, 1}, {1, 2}};
+    g.assign_edges(es);
+    assert(g.size() == 2);
+    assert(g(g(0, 1)) == 0);
+    assert(!g(0, 0));
+    assert(has_degrees(g, 1, {1, 1, 2}));
+  }
+
+int main()
+{
+  using G = undirected_adjacency_vector<char, int>;
+  check_assign_values<G>();
+  check_assign_pairs<G>();
+
+  using D = directed_adjacency_vector<char, int>;
+  check_assign_values<D>();
+  check_assign_pairs<D>();
+}
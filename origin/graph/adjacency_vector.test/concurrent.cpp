@@ -0,0 +1,148 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+using edge_tuple = tuple<size_t, size_t, int>;
+
+// Returns the handles of an incidence range.
+template<typename R>
+  vector<size_t>
+  handles(const R& r)
+  {
+    vector<size_t> x;
+    for (auto e : r)
+      x.push_back(e);
+    return x;
+  }
+
+// Check that g and h have the same edges and incidence lists.
+template<typename G>
+  void
+  check_same(const G& g, const G& h)
+  {
+    assert(g.order() == h.order() && g.size() == h.size());
+    assert(g.sorted() == h.sorted());
+    for (auto e : g.edges()) {
+      assert(g.source(e) == h.source(e) && g.target(e) == h.target(e));
+      assert(g(e) == h(e));
+    }
+    for (auto v : g.vertices()) {
+      assert(handles(g.out_edges(v)) == handles(h.out_edges(v)));
+      assert(handles(g.in_edges(v)) == handles(h.in_edges(v)));
+    }
+  }
+
+// Add the edges es to g from a team of threads, in two rounds, and check
+// that the result is the graph built by adding the edges one at a time in
+// order of their handles.
+template<typename G>
+  void
+  check_concurrent(size_t n, const vector<edge_tuple>& initial,
+                   const vector<edge_tuple>& es, size_t threads)
+  {
+    cout << "*** concurrent insertion (" << typestr<G>() << ") ***\n";
+    G g(n, initial);
+    G h(n, initial);
+    concurrent_edge_inserter<G> ins(g, threads);
+    assert(ins.threads() == threads && ins.pending() == 0);
+
+    size_t half = es.size() / 2;
+    for (size_t round = 0; round < 2; ++round) {
+      size_t first = round == 0 ? 0 : half;
+      size_t last = round == 0 ? half : es.size();
+      size_t size = g.size();
+
+      // Each thread adds a strided slice of the edges, while the graph is
+      // read by the same threads.
+      vector<size_t> handle(es.size());
+      atomic<size_t> reads(0);
+      parallel_impl::run_team(threads, [&](size_t t) {
+        for (size_t i = first + t; i < last; i += threads) {
+          Vertex<G> u(get<0>(es[i]));
+          Vertex<G> v(get<1>(es[i]));
+          handle[i] = ins.add_edge(t, u, v, get<2>(es[i]));
+          reads += g.out_degree(u);
+        }
+      });
+      assert(g.size() == size);
+      assert(ins.pending() == last - first);
+      ins.publish();
+      assert(ins.pending() == 0 && g.size() == size + last - first);
+
+      // Handles are unique and dense.
+      vector<size_t> order(handle.begin() + first, handle.begin() + last);
+      sort(order.begin(), order.end());
+      for (size_t i = 0; i < order.size(); ++i)
+        assert(order[i] == size + i);
+
+      vector<size_t> by_handle(last - first);
+      for (size_t i = first; i < last; ++i)
+        by_handle[handle[i] - size] = i;
+      for (size_t i : by_handle) {
+        Edge<G> e = h.add_edge(Vertex<G>(get<0>(es[i])), Vertex<G>(get<1>(es[i])),
+                               get<2>(es[i]));
+        assert(size_t(e) == handle[i]);
+      }
+      check_same(g, h);
+    }
+
+    // The edge relation finds the new edges.
+    for (auto e : g.edges())
+      assert(g(g.source(e), g.target(e)));
+
+    // Publishing without new edges changes nothing.
+    ins.publish();
+    check_same(g, h);
+  }
+
+template<typename R>
+  vector<edge_tuple>
+  random_edges(R& gen, size_t n, size_t m)
+  {
+    vector<edge_tuple> es;
+    for (size_t i = 0; i < m; ++i)
+      es.emplace_back(gen() % n, gen() % n, gen() % 1000);
+    return es;
+  }
+
+int main()
+{
+  minstd_rand gen;
+  size_t n = 500;
+  auto initial = random_edges(gen, n, 1000);
+  auto es = random_edges(gen, n, 20000);
+
+  // A few vertices with high degree.
+  for (size_t i = 0; i < 200; ++i)
+    es.emplace_back(i % 3, gen() % n, i);
+
+  check_concurrent<directed_adjacency_vector<char, int>>(n, initial, es, 4);
+  check_concurrent<directed_adjacency_vector<char, int>>(n, initial, es, 1);
+  check_concurrent<directed_adjacency_vector<char, int, split_adjacency_vector_traits>>(n, initial, es, 3);
+  check_concurrent<directed_adjacency_vector<char, int, sorted_adjacency_vector_traits>>(n, initial, es, 4);
+  check_concurrent<directed_adjacency_vector<char, int, hashed_adjacency_vector_traits>>(n, initial, es, 4);
+  check_concurrent<directed_adjacency_vector<char, int, narrow_adjacency_vector_traits>>(n, initial, es, 4);
+  check_concurrent<directed_adjacency_vector<char, int, small_adjacency_vector_traits<4>>>(n, initial, es, 4);
+
+  // More threads than vertices.
+  check_concurrent<directed_adjacency_vector<char, int>>(3, {}, random_edges(gen, 3, 50), 8);
+}
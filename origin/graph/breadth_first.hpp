@@ -0,0 +1,458 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_BREADTH_FIRST_HPP
+#define ORIGIN_GRAPH_BREADTH_FIRST_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/neighbors.hpp>
+#include <origin/graph/parallel.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                               [graph.bfs]
+  //                          Breadth-First Search
+  //
+  // The breadth-first search engine computes the distance of every vertex
+  // from a source vertex, and a parent of each reached vertex on a shortest
+  // path from the source. The search is direction optimizing: each level is
+  // expanded either top down, by following the edges leaving the frontier,
+  // or bottom up, by searching the edges entering each unvisited vertex for
+  // one leaving the frontier. Bottom-up steps stop at the first such edge,
+  // so they examine far fewer edges when the frontier is large.
+  //
+  // The engine switches to bottom-up steps when the number of edges leaving
+  // the frontier exceeds the number of edges leaving unvisited vertices
+  // divided by alpha, and back to top-down steps when the frontier contains
+  // fewer than n / beta vertices, where n is the vertex bound of the graph.
+  //
+  // Each level is expanded by a team of threads. Visited vertices are
+  // recorded in a bitmap whose words are updated atomically, so that each
+  // vertex is claimed by exactly one thread. The top-down frontier is a
+  // queue of vertices, and the bottom-up frontier is a bitmap.
+  //
+  // For directed graphs, the search follows out edges, and bottom-up steps
+  // use in edges. For undirected graphs, both use the incident edges.
+
+  namespace breadth_first_impl
+  {
+    using word_type = std::uint64_t;
+    constexpr std::size_t word_bits = 64;
+
+    // Returns the number of words needed to store n bits.
+    inline std::size_t
+    words_for(std::size_t n) { return (n + word_bits - 1) / word_bits; }
+
+    // Returns true if the ith bit of the bitmap b is set.
+    inline bool
+    test_bit(const std::vector<word_type>& b, std::size_t i)
+    {
+      return (b[i / word_bits] >> (i % word_bits)) & 1;
+    }
+
+    // Returns the number of edges followed from v by a top-down step.
+    template<typename G>
+      inline std::size_t
+      forward_degree(const G& g, Vertex<G> v,
+                     Requires<Directed_graph<G>()>* = nullptr)
+      {
+        return g.out_degree(v);
+      }
+
+    template<typename G>
+      inline std::size_t
+      forward_degree(const G& g, Vertex<G> v,
+                     Requires<Undirected_graph<G>()>* = nullptr)
+      {
+        return g.degree(v);
+      }
+
+    // Returns the sum of the forward degrees of the vertices of g.
+    template<typename G>
+      inline std::size_t
+      forward_size(const G& g, Requires<Directed_graph<G>()>* = nullptr)
+      {
+        return g.size();
+      }
+
+    template<typename G>
+      inline std::size_t
+      forward_size(const G& g, Requires<Undirected_graph<G>()>* = nullptr)
+      {
+        return 2 * g.size();
+      }
+
+    // ---------------------------------------------------------------------- //
+    //                             Atomic Bitmap
+    //
+    // A fixed-size bitmap whose words may be read and updated concurrently.
+    // All operations are relaxed: the threads of a search synchronize at
+    // the end of each level.
+    class atomic_bitmap
+    {
+    public:
+      atomic_bitmap() : size_(0) { }
+
+      // Allocate n words, whose values are unspecified.
+      void allocate(std::size_t n)
+      {
+        words_.reset(new std::atomic<word_type>[n]);
+        size_ = n;
+      }
+
+      std::size_t words() const { return size_; }
+
+      word_type load(std::size_t w) const
+      {
+        return words_[w].load(std::memory_order_relaxed);
+      }
+
+      void store(std::size_t w, word_type x)
+      {
+        words_[w].store(x, std::memory_order_relaxed);
+      }
+
+      // Set the ith bit. Returns true if the bit was clear, so that of all
+      // the threads setting the same bit, exactly one sees true. The word is
+      // read before it is updated, since most attempts find the bit set.
+      bool set(std::size_t i)
+      {
+        word_type m = word_type(1) << (i % word_bits);
+        std::atomic<word_type>& w = words_[i / word_bits];
+        if (w.load(std::memory_order_relaxed) & m)
+          return false;
+        return !(w.fetch_or(m, std::memory_order_relaxed) & m);
+      }
+
+    private:
+      std::unique_ptr<std::atomic<word_type>[]> words_;
+      std::size_t size_;
+    };
+
+  } // namespace breadth_first_impl
+
+
+  // The breadth-first search engine for the graph type G. The engine holds
+  // the scratch memory of a search, so that repeated searches of the same
+  // graph do not allocate. The graph must not be modified while the engine
+  // is in use.
+  //
+  // A search writes the distance of every vertex handle less than the
+  // vertex bound of the graph to dist, and its parent to parent. Unreached
+  // vertices, and handles of removed vertices, have distance npos and an
+  // invalid parent. The parent of the source is the source itself. Either
+  // array may be null.
+  template<typename G>
+    class bfs_engine
+    {
+      using word_type = breadth_first_impl::word_type;
+      static constexpr std::size_t word_bits = breadth_first_impl::word_bits;
+
+      // The number of vertices or words claimed by a thread at a time.
+      static constexpr std::size_t vertex_chunk = 64;
+      static constexpr std::size_t word_chunk = 16;
+
+    public:
+      using vertex = Vertex<G>;
+
+      static constexpr std::size_t npos = -1;
+
+      // Create an engine for g that runs searches on the given number of
+      // threads. If threads is 0, the hardware concurrency is used.
+      explicit bfs_engine(const G& g, std::size_t threads = 0);
+
+      std::size_t threads() const { return threads_; }
+
+      // Search from s, returning the number of reached vertices.
+      std::size_t search(vertex s, std::size_t* dist, vertex* parent);
+
+      // Direction switching parameters.
+      std::size_t alpha = 15;
+      std::size_t beta = 18;
+
+    private:
+      // The results of a thread for the current level, aligned to keep
+      // threads from sharing cache lines.
+      struct alignas(parallel_impl::cache_line) local
+      {
+        std::vector<vertex> next; // Discovered vertices (top down)
+        std::size_t count;        // Number of discovered vertices
+        std::size_t edges;        // Sum of their forward degrees
+      };
+
+      void work(std::size_t t);
+      void start();
+      void top_down(std::size_t t);
+      void bottom_up(std::size_t t);
+      void advance();
+      void discover(local& l, vertex u, vertex v);
+
+    private:
+      const G& g_;
+      std::size_t threads_;
+      std::size_t bound_;                  // The vertex bound of g
+      std::size_t words_;                  // Words in each bitmap
+      std::vector<word_type> live_;        // The vertices of g
+      breadth_first_impl::atomic_bitmap visited_;
+      std::vector<word_type> frontier_;    // Bottom-up frontier
+      std::vector<word_type> next_;        // Next bottom-up frontier
+      std::vector<vertex> queue_;          // Top-down frontier
+      std::vector<local, parallel_impl::cache_aligned_allocator<local>> locals_;
+      std::atomic<std::size_t> cursor_;    // Next chunk of work
+      parallel_impl::barrier sync_;
+
+      // The state of the current search.
+      vertex source_;
+      std::size_t* dist_;
+      vertex* parent_;
+      std::size_t level_;
+      std::size_t reached_;
+      std::size_t unexplored_; // Sum of forward degrees of unvisited vertices
+      bool top_down_;
+      bool done_;
+    };
+
+  template<typename G>
+    constexpr std::size_t bfs_engine<G>::npos;
+
+  template<typename G>
+    bfs_engine<G>::bfs_engine(const G& g, std::size_t threads)
+      : g_(g),
+        threads_(parallel_impl::team_size(threads)),
+        bound_(vertex_bound(g)),
+        words_(breadth_first_impl::words_for(bound_)),
+        live_(words_, 0),
+        frontier_(words_, 0),
+        next_(words_, 0),
+        locals_(threads_),
+        sync_(threads_)
+    {
+      for (vertex v : g.vertices())
+        live_[v / word_bits] |= word_type(1) << (v % word_bits);
+      visited_.allocate(words_);
+    }
+
+  template<typename G>
+    std::size_t
+    bfs_engine<G>::search(vertex s, std::size_t* dist, vertex* parent)
+    {
+      assert(std::size_t(s) < bound_ && breadth_first_impl::test_bit(live_, s));
+      source_ = s;
+      dist_ = dist;
+      parent_ = parent;
+      parallel_impl::run_team(threads_, [this](std::size_t t) { work(t); });
+      return reached_;
+    }
+
+  // The body of each thread. Each thread initializes a slice of the output
+  // arrays and the visited bitmap, and then takes part in each level. The
+  // first thread plans each level between barriers.
+  template<typename G>
+    void
+    bfs_engine<G>::work(std::size_t t)
+    {
+      std::size_t per = (words_ + threads_ - 1) / threads_;
+      std::size_t first = std::min(words_, t * per);
+      std::size_t last = std::min(words_, first + per);
+      for (std::size_t w = first; w < last; ++w)
+        visited_.store(w, ~live_[w]);
+      for (std::size_t i = first * word_bits; i < std::min(bound_, last * word_bits); ++i) {
+        if (dist_)
+          dist_[i] = npos;
+        if (parent_)
+          parent_[i] = vertex();
+      }
+
+      sync_.wait();
+      if (t == 0)
+        start();
+      sync_.wait();
+      while (!done_) {
+        if (top_down_)
+          top_down(t);
+        else
+          bottom_up(t);
+        sync_.wait();
+        if (t == 0)
+          advance();
+        sync_.wait();
+      }
+    }
+
+  // Visit the source and make it the frontier.
+  template<typename G>
+    void
+    bfs_engine<G>::start()
+    {
+      visited_.set(source_);
+      if (dist_)
+        dist_[source_] = 0;
+      if (parent_)
+        parent_[source_] = source_;
+      queue_.assign(1, source_);
+      level_ = 0;
+      reached_ = 1;
+      unexplored_ = breadth_first_impl::forward_size(g_)
+                  - breadth_first_impl::forward_degree(g_, source_);
+      top_down_ = true;
+      done_ = false;
+      cursor_ = 0;
+      for (local& l : locals_) {
+        l.next.clear();
+        l.count = l.edges = 0;
+      }
+    }
+
+  // Record v as discovered from u by the thread owning l.
+  template<typename G>
+    inline void
+    bfs_engine<G>::discover(local& l, vertex u, vertex v)
+    {
+      if (dist_)
+        dist_[v] = level_ + 1;
+      if (parent_)
+        parent_[v] = u;
+      ++l.count;
+      l.edges += breadth_first_impl::forward_degree(g_, v);
+    }
+
+  // Claim chunks of the frontier queue, and visit the unvisited neighbors
+  // of each vertex.
+  template<typename G>
+    void
+    bfs_engine<G>::top_down(std::size_t t)
+    {
+      using namespace neighbors_impl;
+      local& l = locals_[t];
+      std::size_t n = queue_.size();
+      while (true) {
+        std::size_t i = cursor_.fetch_add(vertex_chunk);
+        if (i >= n)
+          break;
+        std::size_t end = std::min(n, i + vertex_chunk);
+        for (; i < end; ++i) {
+          vertex u = queue_[i];
+          for (auto e : neighbor_edges(g_, u)) {
+            vertex v = neighbor(g_, e, u);
+            if (visited_.set(v)) {
+              discover(l, u, v);
+              l.next.push_back(v);
+            }
+          }
+        }
+      }
+    }
+
+  // Claim chunks of bitmap words, and search the predecessors of each
+  // unvisited vertex for one in the frontier. Each word of the visited and
+  // next bitmaps is written only by the thread that claimed it.
+  template<typename G>
+    void
+    bfs_engine<G>::bottom_up(std::size_t t)
+    {
+      using namespace breadth_first_impl;
+      using namespace neighbors_impl;
+      local& l = locals_[t];
+      while (true) {
+        std::size_t w = cursor_.fetch_add(word_chunk);
+        if (w >= words_)
+          break;
+        std::size_t end = std::min(words_, w + word_chunk);
+        for (; w < end; ++w) {
+          word_type seen = visited_.load(w);
+          word_type todo = ~seen;
+          word_type found = 0;
+          while (todo != 0) {
+            std::size_t b = __builtin_ctzll(todo);
+            todo &= todo - 1;
+            vertex v = w * word_bits + b;
+            for (auto e : reverse_edges(g_, v)) {
+              vertex u = reverse_neighbor(g_, e, v);
+              if (test_bit(frontier_, u)) {
+                found |= word_type(1) << b;
+                discover(l, u, v);
+                break;
+              }
+            }
+          }
+          next_[w] = found;
+          if (found != 0)
+            visited_.store(w, seen | found);
+        }
+      }
+    }
+
+  // Collect the results of the level, and choose the direction of the next
+  // level, converting the frontier if the direction changes.
+  template<typename G>
+    void
+    bfs_engine<G>::advance()
+    {
+      std::size_t count = 0;
+      std::size_t edges = 0;
+      for (local& l : locals_) {
+        count += l.count;
+        edges += l.edges;
+        l.count = l.edges = 0;
+      }
+      reached_ += count;
+      unexplored_ -= edges;
+      ++level_;
+      cursor_ = 0;
+      if (count == 0) {
+        done_ = true;
+        return;
+      }
+
+      if (top_down_) {
+        queue_.clear();
+        for (local& l : locals_) {
+          queue_.insert(queue_.end(), l.next.begin(), l.next.end());
+          l.next.clear();
+        }
+        if (edges > unexplored_ / alpha) {
+          std::fill(frontier_.begin(), frontier_.end(), 0);
+          for (vertex v : queue_)
+            frontier_[v / word_bits] |= word_type(1) << (v % word_bits);
+          top_down_ = false;
+        }
+      } else {
+        frontier_.swap(next_);
+        if (count < bound_ / beta) {
+          queue_.clear();
+          for (std::size_t w = 0; w < words_; ++w)
+            for (word_type x = frontier_[w]; x != 0; x &= x - 1)
+              queue_.push_back(w * word_bits + __builtin_ctzll(x));
+          top_down_ = true;
+        }
+      }
+    }
+
+
+  // Search g from s, writing the distance and parent of each vertex to dist
+  // and parent. Returns the number of reached vertices. See bfs_engine.
+  template<typename G>
+    inline std::size_t
+    breadth_first_search(const G& g, Vertex<G> s, std::size_t* dist,
+                         Vertex<G>* parent, std::size_t threads = 0)
+    {
+      bfs_engine<G> bfs(g, threads);
+      return bfs.search(s, dist, parent);
+    }
+
+} // namespace origin
+
+#endif
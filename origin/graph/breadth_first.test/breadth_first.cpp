@@ -0,0 +1,168 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/breadth_first.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+constexpr size_t npos = -1;
+
+// Returns the distances from s computed by a serial breadth-first search.
+template<typename G>
+  vector<size_t>
+  serial_distances(const G& g, Vertex<G> s)
+  {
+    using namespace neighbors_impl;
+    vector<size_t> dist(vertex_bound(g), npos);
+    queue<Vertex<G>> q;
+    dist[s] = 0;
+    q.push(s);
+    while (!q.empty()) {
+      Vertex<G> u = q.front();
+      q.pop();
+      for (auto e : neighbor_edges(g, u)) {
+        Vertex<G> v = neighbor(g, e, u);
+        if (dist[v] == npos) {
+          dist[v] = dist[u] + 1;
+          q.push(v);
+        }
+      }
+    }
+    return dist;
+  }
+
+// Returns the pairs (u, v) such that v is a neighbor of u.
+template<typename G>
+  set<pair<size_t, size_t>>
+  neighbor_pairs(const G& g)
+  {
+    using namespace neighbors_impl;
+    set<pair<size_t, size_t>> r;
+    for (auto u : g.vertices())
+      for (auto e : neighbor_edges(g, u))
+        r.emplace(u, neighbor(g, e, u));
+    return r;
+  }
+
+// Check the searches of the engine from several sources against a serial
+// search. Every parent must be a neighbor one level closer to the source.
+template<typename G>
+  void
+  check_searches(const G& g, bfs_engine<G>& bfs)
+  {
+    set<pair<size_t, size_t>> adj = neighbor_pairs(g);
+    vector<size_t> dist(vertex_bound(g));
+    vector<Vertex<G>> parent(vertex_bound(g));
+    for (auto s : g.vertices()) {
+      if (size_t(s) % 97 != 0 && size_t(s) != 1)
+        continue;
+      vector<size_t> expect = serial_distances(g, s);
+      size_t n = bfs.search(s, dist.data(), parent.data());
+      assert(dist == expect);
+
+      size_t reached = 0;
+      for (size_t v = 0; v < dist.size(); ++v) {
+        if (dist[v] == npos) {
+          assert(!parent[v]);
+          continue;
+        }
+        ++reached;
+        if (v == size_t(s)) {
+          assert(parent[v] == s);
+        } else {
+          size_t u = parent[v];
+          assert(adj.count(make_pair(u, v)));
+          assert(dist[u] + 1 == dist[v]);
+        }
+      }
+      assert(n == reached);
+
+      // Either output may be omitted.
+      assert(bfs.search(s, nullptr, parent.data()) == n);
+      assert(bfs.search(s, dist.data(), nullptr) == n);
+      assert(dist == expect);
+    }
+  }
+
+// Check a graph with the default switching parameters, and with parameters
+// that force early bottom-up steps and that keep the search bottom up.
+template<typename G>
+  void
+  check_engine(const G& g)
+  {
+    cout << "*** bfs engine (" << typestr<G>() << ") ***\n";
+    const size_t params[][2] {{15, 18}, {1, 1 << 30}, {1 << 30, 1 << 30}};
+    for (size_t t : {1, 4}) {
+      bfs_engine<G> bfs(g, t);
+      assert(bfs.threads() == t);
+      for (auto& p : params) {
+        bfs.alpha = p[0];
+        bfs.beta = p[1];
+        check_searches(g, bfs);
+      }
+    }
+  }
+
+// Returns random edges over n vertices. Vertex 0 is a hub, and the last
+// tenth of the vertices are isolated.
+template<typename R>
+  vector<tuple<size_t, size_t>>
+  random_edges(R& gen, size_t n, size_t m)
+  {
+    vector<tuple<size_t, size_t>> es;
+    size_t k = n - n / 10;
+    for (size_t i = 0; i < m; ++i)
+      es.emplace_back(gen() % 5 == 0 ? 0 : gen() % k, gen() % k);
+    return es;
+  }
+
+int main()
+{
+  minstd_rand gen;
+  size_t n = 1000;
+  auto es = random_edges(gen, n, 3000);
+
+  check_engine(directed_adjacency_vector<char>(n, es));
+  check_engine(undirected_adjacency_vector<char>(n, es));
+  check_engine(directed_adjacency_vector<char, empty_t, narrow_adjacency_vector_traits>(n, es));
+
+  using U = undirected_adjacency_list<char, int>;
+  using D = directed_adjacency_list<char, int>;
+  check_engine(build_graph<U>(n, es));
+  check_engine(build_graph<D>(n, es));
+
+  // Removed vertices are neither searched nor reached.
+  U g = build_graph<U>(n, es);
+  g.remove_vertex(Vertex<U>(5));
+  g.remove_vertex(Vertex<U>(100));
+  check_engine(g);
+
+  // A path, searched one vertex per level.
+  D p = build_n_graph<D>(300);
+  for (size_t i = 0; i + 1 < 300; ++i)
+    p.add_edge(Vertex<D>(i), Vertex<D>(i + 1));
+  vector<size_t> dist(300);
+  assert(breadth_first_search(p, Vertex<D>(0), dist.data(), nullptr, 3) == 300);
+  assert(dist[299] == 299);
+  assert(breadth_first_search(p, Vertex<D>(150), dist.data(), nullptr) == 150);
+  assert(dist[0] == npos && dist[299] == 149);
+}
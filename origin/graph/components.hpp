@@ -0,0 +1,348 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_COMPONENTS_HPP
+#define ORIGIN_GRAPH_COMPONENTS_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/parallel.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                        [graph.components]
+  //                          Connected Components
+  //
+  // The connected components of an undirected graph are labeled by the
+  // least vertex handle in each component, so the labels do not depend on
+  // the order in which edges are processed.
+  //
+  // The components are computed by a team of threads sharing a union-find
+  // forest, stored in the label array. Trees are linked by a compare and
+  // swap that makes the root with the greater index point to the lesser, so
+  // the root of each tree is its least vertex. The forest is built in the
+  // style of Afforest: the first few neighbors of every vertex are linked,
+  // which usually joins most of the graph into one large component. The
+  // remaining edges are then linked only for vertices outside of that
+  // component. Each edge appears in the incidence lists of both endpoints,
+  // so an edge skipped at one endpoint is linked at the other.
+  //
+  // The incremental components track the components of a graph as vertices
+  // and edges are added, using a serial union-find forest with the same
+  // labels.
+
+  namespace components_impl
+  {
+    constexpr std::size_t npos = -1;
+
+    // The number of neighbors of each vertex linked before sampling.
+    constexpr std::size_t sample_rounds = 2;
+
+    // The number of vertices sampled to find the largest component.
+    constexpr std::size_t sample_size = 1024;
+
+    // The number of vertices claimed by a thread at a time.
+    constexpr std::size_t chunk = 256;
+
+    // The forest is stored in a caller's array of std::size_t, so its
+    // entries are accessed through the atomic builtins.
+    inline std::size_t
+    load(const std::size_t* p) { return __atomic_load_n(p, __ATOMIC_RELAXED); }
+
+    inline void
+    store(std::size_t* p, std::size_t x) { __atomic_store_n(p, x, __ATOMIC_RELAXED); }
+
+    // Replace the value of *p by x if it is equal to y. Returns true if the
+    // value was replaced.
+    inline bool
+    replace(std::size_t* p, std::size_t y, std::size_t x)
+    {
+      return __atomic_compare_exchange_n(p, &y, x, false,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
+
+    // Join the trees containing u and v.
+    inline void
+    link(std::size_t* comp, std::size_t u, std::size_t v)
+    {
+      std::size_t p1 = load(comp + u);
+      std::size_t p2 = load(comp + v);
+      while (p1 != p2) {
+        std::size_t high = std::max(p1, p2);
+        std::size_t low = std::min(p1, p2);
+        std::size_t p = load(comp + high);
+        if (p == low || (p == high && replace(comp + high, high, low)))
+          break;
+        p1 = load(comp + load(comp + high));
+        p2 = load(comp + low);
+      }
+    }
+
+    // Point v directly at the root of its tree.
+    inline void
+    compress(std::size_t* comp, std::size_t v)
+    {
+      std::size_t p = load(comp + v);
+      std::size_t q = load(comp + p);
+      while (p != q) {
+        store(comp + v, q);
+        p = q;
+        q = load(comp + p);
+      }
+    }
+
+    // Link v to its neighbors at positions [first, last) of its incidence
+    // list.
+    template<typename G>
+      void
+      link_neighbors(const G& g, std::size_t* comp, Vertex<G> v,
+                     std::size_t first, std::size_t last)
+      {
+        std::size_t i = 0;
+        for (auto e : g.edges(v)) {
+          if (i >= last)
+            break;
+          if (i++ >= first)
+            link(comp, v, opposite(g, e, v));
+        }
+      }
+
+    // Returns the most frequent label of a sample of the vertices vs. The
+    // forest must be compressed.
+    template<typename V>
+      std::size_t
+      frequent_label(const std::size_t* comp, const std::vector<V>& vs)
+      {
+        std::unordered_map<std::size_t, std::size_t> counts;
+        std::minstd_rand gen;
+        std::uniform_int_distribution<std::size_t> pick(0, vs.size() - 1);
+        for (std::size_t i = 0; i < sample_size; ++i)
+          ++counts[comp[vs[pick(gen)]]];
+        auto best = std::max_element(counts.begin(), counts.end(),
+          [](const std::pair<const std::size_t, std::size_t>& a,
+             const std::pair<const std::size_t, std::size_t>& b) {
+            return a.second < b.second;
+          });
+        return best->first;
+      }
+
+  } // namespace components_impl
+
+
+  // Write the component label of every vertex handle less than the vertex
+  // bound of g to label, using the given number of threads. If threads is 0,
+  // the hardware concurrency is used. Handles of removed vertices are
+  // labeled npos. Returns the number of components.
+  template<typename G>
+    std::size_t
+    connected_components(const G& g, std::size_t* label, std::size_t threads = 0)
+    {
+      static_assert(Undirected_graph<G>(), "");
+      using namespace components_impl;
+      using parallel_impl::parallel_for;
+
+      threads = parallel_impl::team_size(threads);
+      std::size_t n = vertex_bound(g);
+      std::vector<Vertex<G>> vs;
+      for (Vertex<G> v : g.vertices())
+        vs.push_back(v);
+      if (vs.empty()) {
+        std::fill(label, label + n, npos);
+        return 0;
+      }
+
+      parallel_for(threads, n, chunk, [&](std::size_t, std::size_t i, std::size_t j) {
+        std::fill(label + i, label + j, npos);
+      });
+      parallel_for(threads, vs.size(), chunk, [&](std::size_t, std::size_t i, std::size_t j) {
+        for (; i < j; ++i)
+          label[vs[i]] = vs[i];
+      });
+
+      // Link the first neighbors of each vertex, one round at a time.
+      for (std::size_t r = 0; r < sample_rounds; ++r) {
+        parallel_for(threads, vs.size(), chunk, [&](std::size_t, std::size_t i, std::size_t j) {
+          for (; i < j; ++i)
+            link_neighbors(g, label, vs[i], r, r + 1);
+        });
+        parallel_for(threads, vs.size(), chunk, [&](std::size_t, std::size_t i, std::size_t j) {
+          for (; i < j; ++i)
+            compress(label, vs[i]);
+        });
+      }
+
+      // Link the remaining neighbors of vertices outside of the largest
+      // component.
+      std::size_t c = frequent_label(label, vs);
+      parallel_for(threads, vs.size(), chunk, [&](std::size_t, std::size_t i, std::size_t j) {
+        for (; i < j; ++i)
+          if (load(label + vs[i]) != c)
+            link_neighbors(g, label, vs[i], sample_rounds, npos);
+      });
+
+      std::vector<std::size_t> roots(threads, 0);
+      parallel_for(threads, vs.size(), chunk, [&](std::size_t t, std::size_t i, std::size_t j) {
+        for (; i < j; ++i) {
+          compress(label, vs[i]);
+          if (label[vs[i]] == std::size_t(vs[i]))
+            ++roots[t];
+        }
+      });
+
+      std::size_t count = 0;
+      for (std::size_t k : roots)
+        count += k;
+      return count;
+    }
+
+
+  // The incremental components of a graph. The tracker computes the
+  // components of a graph, and then updates them as vertices and edges are
+  // added through it. Edges added to the graph directly are recorded by
+  // calling connect(). Removing vertices or edges requires the components to
+  // be recomputed by reset().
+  template<typename G>
+    class incremental_components
+    {
+    public:
+      using vertex = Vertex<G>;
+      using edge = Edge<G>;
+
+      static constexpr std::size_t npos = -1;
+
+      // Compute the components of g using the given number of threads.
+      explicit incremental_components(G& g, std::size_t threads = 0);
+
+      const G& graph() const { return g_; }
+
+      // Returns the number of components.
+      std::size_t count() const { return count_; }
+
+      // Returns the label of the component containing v.
+      std::size_t component(vertex v) const;
+
+      // Returns true if u and v are in the same component.
+      bool connected(vertex u, vertex v) const
+      {
+        return component(u) == component(v);
+      }
+
+      // Add a vertex to the graph in a component of its own.
+      template<typename... Args>
+        vertex add_vertex(Args&&... args);
+
+      // Add an edge to the graph, joining the components of its endpoints.
+      template<typename... Args>
+        edge add_edge(vertex u, vertex v, Args&&... args);
+
+      // Join the components of u and v, after an edge has been added between
+      // them. Returns true if they were in different components.
+      bool connect(vertex u, vertex v);
+
+      // Recompute the components of the graph.
+      void reset(std::size_t threads = 0);
+
+    private:
+      std::size_t find(std::size_t v) const;
+
+    private:
+      G& g_;
+      mutable std::vector<std::size_t> parent_; // The union-find forest
+      std::size_t count_;
+    };
+
+  template<typename G>
+    constexpr std::size_t incremental_components<G>::npos;
+
+  template<typename G>
+    incremental_components<G>::incremental_components(G& g, std::size_t threads)
+      : g_(g)
+    {
+      reset(threads);
+    }
+
+  template<typename G>
+    void
+    incremental_components<G>::reset(std::size_t threads)
+    {
+      parent_.resize(vertex_bound(g_));
+      count_ = connected_components(g_, parent_.data(), threads);
+    }
+
+  // Returns the root of the tree containing v, halving the path to it.
+  template<typename G>
+    inline std::size_t
+    incremental_components<G>::find(std::size_t v) const
+    {
+      while (parent_[v] != v) {
+        parent_[v] = parent_[parent_[v]];
+        v = parent_[v];
+      }
+      return v;
+    }
+
+  template<typename G>
+    inline std::size_t
+    incremental_components<G>::component(vertex v) const
+    {
+      assert(std::size_t(v) < parent_.size() && parent_[v] != npos);
+      return find(v);
+    }
+
+  template<typename G>
+    template<typename... Args>
+      auto
+      incremental_components<G>::add_vertex(Args&&... args) -> vertex
+      {
+        vertex v = g_.add_vertex(std::forward<Args>(args)...);
+        if (parent_.size() <= std::size_t(v))
+          parent_.resize(std::size_t(v) + 1, npos);
+        parent_[v] = v;
+        ++count_;
+        return v;
+      }
+
+  template<typename G>
+    template<typename... Args>
+      auto
+      incremental_components<G>::add_edge(vertex u, vertex v, Args&&... args)
+        -> edge
+      {
+        edge e = g_.add_edge(u, v, std::forward<Args>(args)...);
+        connect(u, v);
+        return e;
+      }
+
+  // The root with the greater index is linked to the lesser, so that each
+  // component remains labeled by its least vertex.
+  template<typename G>
+    bool
+    incremental_components<G>::connect(vertex u, vertex v)
+    {
+      std::size_t a = component(u);
+      std::size_t b = component(v);
+      if (a == b)
+        return false;
+      if (a < b)
+        parent_[b] = a;
+      else
+        parent_[a] = b;
+      --count_;
+      return true;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,169 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/components.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+constexpr size_t npos = -1;
+
+// Returns the component labels of g computed by a serial search from each
+// vertex in increasing order, so that each component is labeled by its
+// least vertex.
+template<typename G>
+  vector<size_t>
+  serial_labels(const G& g)
+  {
+    vector<size_t> label(vertex_bound(g), npos);
+    vector<Vertex<G>> stack;
+    for (auto s : g.vertices()) {
+      if (label[s] != npos)
+        continue;
+      label[s] = s;
+      stack.push_back(s);
+      while (!stack.empty()) {
+        Vertex<G> u = stack.back();
+        stack.pop_back();
+        for (auto e : g.edges(u)) {
+          Vertex<G> v = opposite(g, e, u);
+          if (label[v] == npos) {
+            label[v] = s;
+            stack.push_back(v);
+          }
+        }
+      }
+    }
+    return label;
+  }
+
+// Returns the number of components of a labeling.
+size_t
+count_labels(const vector<size_t>& label)
+{
+  size_t n = 0;
+  for (size_t v = 0; v < label.size(); ++v)
+    n += label[v] == v;
+  return n;
+}
+
+template<typename G>
+  void
+  check_components(const G& g)
+  {
+    cout << "*** components (" << typestr<G>() << ") ***\n";
+    vector<size_t> expect = serial_labels(g);
+    for (size_t t : {1, 4}) {
+      vector<size_t> label(vertex_bound(g));
+      size_t n = connected_components(g, label.data(), t);
+      assert(label == expect);
+      assert(n == count_labels(expect));
+    }
+  }
+
+// Returns m random edges over n vertices. Most edges join vertices in the
+// first half, so that it forms a large component, and the rest join nearby
+// vertices of the second half into small components.
+template<typename R>
+  vector<tuple<size_t, size_t>>
+  random_edges(R& gen, size_t n, size_t m)
+  {
+    vector<tuple<size_t, size_t>> es;
+    for (size_t i = 0; i < m; ++i) {
+      if (gen() % 4 != 0) {
+        es.emplace_back(gen() % (n / 2), gen() % (n / 2));
+      } else {
+        size_t u = n / 2 + gen() % (n / 2 - 3);
+        es.emplace_back(u, u + gen() % 3);
+      }
+    }
+    return es;
+  }
+
+// Check that the incremental components agree with the serial labeling as
+// edges are added to the graph.
+template<typename G>
+  void
+  check_incremental()
+  {
+    cout << "*** incremental components (" << typestr<G>() << ") ***\n";
+    minstd_rand gen;
+    G g = build_n_graph<G>(300);
+    incremental_components<G> cc(g, 2);
+    assert(cc.count() == 300);
+    for (int i = 0; i < 400; ++i) {
+      Vertex<G> u = gen() % 300;
+      Vertex<G> v = gen() % 300;
+      cc.add_edge(u, v);
+      assert(cc.connected(u, v));
+      if (i % 50 == 0) {
+        vector<size_t> expect = serial_labels(g);
+        assert(cc.count() == count_labels(expect));
+        for (auto x : g.vertices())
+          assert(cc.component(x) == expect[x]);
+      }
+    }
+
+    // Edges added directly to the graph are recorded by connect().
+    Vertex<G> a = cc.add_vertex();
+    Vertex<G> b = cc.add_vertex();
+    assert(!cc.connected(a, b) && cc.component(b) == size_t(b));
+    g.add_edge(b, a);
+    assert(cc.connect(b, a));
+    assert(!cc.connect(a, b));
+    assert(cc.component(b) == size_t(a));
+    assert(cc.count() == count_labels(serial_labels(g)));
+  }
+
+int main()
+{
+  minstd_rand gen;
+  size_t n = 2000;
+  auto es = random_edges(gen, n, 3000);
+
+  check_components(undirected_adjacency_vector<char>(n, es));
+  check_components(undirected_adjacency_vector<char, empty_t, narrow_adjacency_vector_traits>(n, es));
+
+  using U = undirected_adjacency_list<char, int>;
+  U g = build_graph<U>(n, es);
+  check_components(g);
+
+  // Removed vertices are labeled npos, and may split their components.
+  g.remove_vertex(Vertex<U>(1));
+  g.remove_vertex(Vertex<U>(n - 5));
+  check_components(g);
+  vector<size_t> label(vertex_bound(g));
+  connected_components(g, label.data());
+  assert(label[1] == npos && label[n - 5] == npos);
+
+  // A graph without edges.
+  check_components(build_n_graph<U>(10));
+  check_components(U());
+
+  check_incremental<undirected_adjacency_list<char, int>>();
+  check_incremental<undirected_adjacency_vector<char>>();
+
+  // The tracker can be reset after vertices are removed.
+  U h = build_graph<U>(100, random_edges(gen, 100, 80));
+  incremental_components<U> cc(h);
+  h.remove_vertex(Vertex<U>(3));
+  cc.reset();
+  assert(cc.count() == count_labels(serial_labels(h)));
+  Vertex<U> v = cc.add_vertex();
+  assert(cc.component(v) == size_t(v));
+}
@@ -0,0 +1,339 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_COMPRESSED_GRAPH_HPP
+#define ORIGIN_GRAPH_COMPRESSED_GRAPH_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <origin/type/concepts.hpp>
+#include <origin/type/empty.hpp>
+#include <origin/sequence/range.hpp>
+
+#include <origin/graph/handle.hpp>
+#include <origin/graph/graph.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.compressed]
+  //                            Compressed Graph
+  //
+  // A compressed graph is an immutable directed graph stored in compressed
+  // sparse row (CSR) format. The out edges of all vertices are stored in a
+  // single array of targets, delimited by an array of offsets, and edge
+  // values are stored in a parallel array. Edge handles are positions in the
+  // target array, so scanning the out edges of a vertex is a sequential read.
+  //
+  // The out edges of each vertex are ordered by target. The edge relation
+  // g(u, v) is a binary search over the out edges of u.
+  //
+  // The source of an edge is not stored: source(e) is computed by binary
+  // search over the offsets.
+  //
+  // The graph optionally maintains a compressed sparse column (CSC) index of
+  // its in edges. The index stores the handles of the in edges of each vertex
+  // contiguously (ordered by source), together with their sources, so that
+  // the sources of the in edges of a vertex can be read sequentially.
+  // Without the index, the in_edges(v) operation is unavailable.
+  //
+  // Offsets and handles are stored in the index type I, which limits the
+  // number of vertices and edges to the greatest value of I. Each edge costs
+  // one index for its target and its value; the in edge index adds two
+  // indexes per edge. Each vertex costs one index for its offset and its
+  // value, and one more index with the in edge index. With 32-bit indexes
+  // and empty values, a graph without the in edge index takes 4 bytes per
+  // edge, an eighth of a directed adjacency vector with 64-bit handles.
+  //
+  // A compressed graph is normally built from a mutable graph using freeze(),
+  // which uses the index type of the graph. The topology of the graph cannot
+  // be modified after construction, but vertex and edge values can.
+  template<typename V = empty_t, typename E = empty_t, typename I = std::size_t>
+    class compressed_graph
+    {
+    public:
+      using index_type = I;
+      using vertex = basic_vertex_handle<I>;
+      using edge = basic_edge_handle<I>;
+
+    private:
+      using vertex_iter =
+        adjacency_vector_impl::handle_counter<std::size_t, vertex>;
+      using edge_iter =
+        adjacency_vector_impl::handle_counter<std::size_t, edge>;
+
+      using offset_list = std::vector<I>;
+      using vertex_list = std::vector<vertex>;
+      using edge_list = std::vector<edge>;
+      using incidence_iter = typename edge_list::const_iterator;
+    public:
+      using vertex_range = bounded_range<vertex_iter>;
+      using edge_range = bounded_range<edge_iter>;
+
+      using incidence_range = bounded_range<incidence_iter>;
+
+
+      compressed_graph();
+
+      // Construct a compressed copy of the directed graph g. If in is true,
+      // the in edge index is also built.
+      template<typename G>
+        explicit compressed_graph(const G& g, bool in = false);
+
+      // Observers
+      bool        null() const  { return verts_.empty(); }
+      std::size_t order() const { return verts_.size(); }
+
+      bool        empty() const { return targets_.empty(); }
+      std::size_t size() const  { return targets_.size(); }
+
+      // Handle bounds
+      std::size_t vertex_bound() const { return order(); }
+      std::size_t edge_bound() const   { return size(); }
+
+      // Returns true if the in edge index is maintained.
+      bool has_in_edges() const { return !in_offsets_.empty(); }
+
+      // Vertex observers
+      std::size_t out_degree(vertex v) const;
+      std::size_t in_degree(vertex v) const;
+      std::size_t degree(vertex v) const { return out_degree(v) + in_degree(v); }
+
+      // Edge observers
+      vertex source(edge e) const;
+      vertex target(edge e) const { return targets_[e]; }
+
+      // Data access
+      V&       operator()(vertex v)       { return verts_[v]; }
+      const V& operator()(vertex v) const { return verts_[v]; }
+
+      E&       operator()(edge e)       { return values_[e]; }
+      const E& operator()(edge e) const { return values_[e]; }
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const;
+
+      // Iterators
+      vertex_range    vertices() const;
+      edge_range      edges() const;
+      edge_range      out_edges(vertex v) const;
+      incidence_range in_edges(vertex v) const;
+
+      // Compressed storage
+      // These operations expose the underlying arrays for algorithms that
+      // operate directly on the CSR representation. The out edges of v are
+      // the positions [offsets()[v], offsets()[v + 1]) of targets().
+      const offset_list& offsets() const { return offsets_; }
+      const vertex_list& targets() const { return targets_; }
+
+      // The in edge index. The sources of the in edges of v are the
+      // positions [in_offsets()[v], in_offsets()[v + 1]) of in_sources().
+      const offset_list& in_offsets() const { return in_offsets_; }
+      const vertex_list& in_sources() const { return in_sources_; }
+
+    private:
+      void build_in_edges();
+      vertex find_source(edge e) const;
+
+    private:
+      std::vector<V> verts_;    // Vertex values
+      offset_list    offsets_;  // Out edge offsets, indexed by vertex
+      vertex_list    targets_;  // Edge targets, indexed by edge
+      std::vector<E> values_;   // Edge values, indexed by edge
+
+      offset_list in_offsets_;  // In edge offsets, indexed by vertex
+      edge_list   in_edges_;    // In edge handles, grouped by target
+      vertex_list in_sources_;  // In edge sources, grouped by target
+    };
+
+  template<typename V, typename E, typename I>
+    inline
+    compressed_graph<V, E, I>::compressed_graph()
+      : offsets_(1, 0), in_offsets_(1, 0)
+    { }
+
+  // Copy the vertices and edges of g into compressed storage. The vertices
+  // of g are numbered densely in the order in which they are iterated, so
+  // the vertex handles of the compressed graph may differ from those of g
+  // when g has removed vertices.
+  template<typename V, typename E, typename I>
+    template<typename G>
+      compressed_graph<V, E, I>::compressed_graph(const G& g, bool in)
+      {
+        using Pair = std::pair<std::size_t, Edge<G>>;
+        assert(g.order() < std::size_t(I(-1)) && g.size() < std::size_t(I(-1)));
+
+        std::vector<std::size_t> index(g.vertex_bound(), -1);
+        verts_.reserve(g.order());
+        for (auto v : g.vertices()) {
+          index[v] = verts_.size();
+          verts_.push_back(g(v));
+        }
+
+        // Copy the out edges of each vertex, ordered by target.
+        offsets_.reserve(g.order() + 1);
+        targets_.reserve(g.size());
+        values_.reserve(g.size());
+        offsets_.push_back(0);
+        std::vector<Pair> row;
+        for (auto v : g.vertices()) {
+          row.clear();
+          for (auto e : g.out_edges(v))
+            row.emplace_back(index[g.target(e)], e);
+          std::stable_sort(row.begin(), row.end(),
+                           [](const Pair& a, const Pair& b) {
+                             return a.first < b.first;
+                           });
+          for (const Pair& x : row) {
+            targets_.push_back(x.first);
+            values_.push_back(g(x.second));
+          }
+          offsets_.push_back(targets_.size());
+        }
+
+        if (in)
+          build_in_edges();
+      }
+
+  // Build the in edge index by counting sort. Because edges are visited in
+  // order of their source, the in edges of each vertex are ordered by
+  // source.
+  template<typename V, typename E, typename I>
+    void
+    compressed_graph<V, E, I>::build_in_edges()
+    {
+      const std::size_t n = order();
+      in_offsets_.assign(n + 1, 0);
+      for (vertex v : targets_)
+        ++in_offsets_[v + 1];
+      for (std::size_t i = 0; i < n; ++i)
+        in_offsets_[i + 1] += in_offsets_[i];
+
+      in_edges_.resize(size());
+      in_sources_.resize(size());
+      offset_list pos(in_offsets_.begin(), in_offsets_.end() - 1);
+      for (std::size_t u = 0; u < n; ++u) {
+        for (std::size_t e = offsets_[u]; e < offsets_[u + 1]; ++e) {
+          std::size_t i = pos[targets_[e]]++;
+          in_edges_[i] = e;
+          in_sources_[i] = u;
+        }
+      }
+    }
+
+  template<typename V, typename E, typename I>
+    inline std::size_t
+    compressed_graph<V, E, I>::out_degree(vertex v) const
+    {
+      return offsets_[v + 1] - offsets_[v];
+    }
+
+  template<typename V, typename E, typename I>
+    inline std::size_t
+    compressed_graph<V, E, I>::in_degree(vertex v) const
+    {
+      assert(has_in_edges());
+      return in_offsets_[v + 1] - in_offsets_[v];
+    }
+
+  template<typename V, typename E, typename I>
+    inline auto
+    compressed_graph<V, E, I>::source(edge e) const -> vertex
+    {
+      return find_source(e);
+    }
+
+  // Find the vertex whose out edges contain e. This is the last vertex whose
+  // offset is not greater than e.
+  template<typename V, typename E, typename I>
+    inline auto
+    compressed_graph<V, E, I>::find_source(edge e) const -> vertex
+    {
+      auto i = std::upper_bound(offsets_.begin(), offsets_.end(), e.value);
+      return (i - offsets_.begin()) - 1;
+    }
+
+  // Returns the first edge connecting u to v, or an invalid handle if no
+  // such edge exists.
+  template<typename V, typename E, typename I>
+    inline auto
+    compressed_graph<V, E, I>::operator()(vertex u, vertex v) const -> edge
+    {
+      auto first = targets_.begin() + offsets_[u];
+      auto last = targets_.begin() + offsets_[u + 1];
+      auto i = std::lower_bound(first, last, v);
+      return (i != last && *i == v) ? edge(i - targets_.begin()) : edge();
+    }
+
+  // Return a range over the vertex set.
+  template<typename V, typename E, typename I>
+    inline auto
+    compressed_graph<V, E, I>::vertices() const -> vertex_range
+    {
+      return {vertex_iter(0), vertex_iter(order())};
+    }
+
+  // Return a range over the edge set.
+  template<typename V, typename E, typename I>
+    inline auto
+    compressed_graph<V, E, I>::edges() const -> edge_range
+    {
+      return {edge_iter(0), edge_iter(size())};
+    }
+
+  // Return a range over the out edges of the vertex v.
+  template<typename V, typename E, typename I>
+    inline auto
+    compressed_graph<V, E, I>::out_edges(vertex v) const -> edge_range
+    {
+      return {edge_iter(offsets_[v]), edge_iter(offsets_[v + 1])};
+    }
+
+  // Return a range over the in edges of the vertex v. The graph must
+  // maintain the in edge index.
+  template<typename V, typename E, typename I>
+    inline auto
+    compressed_graph<V, E, I>::in_edges(vertex v) const -> incidence_range
+    {
+      assert(has_in_edges());
+      auto first = in_edges_.begin();
+      return {first + in_offsets_[v], first + in_offsets_[v + 1]};
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                              [graph.freeze]
+  //                                Freeze
+  //
+  // The freeze operation produces a compressed snapshot of a mutable graph,
+  // with the index type of the graph. If in is true, the snapshot maintains
+  // an index of in edges.
+
+  template<typename V, typename E, typename T>
+    inline compressed_graph<V, E, typename T::index_type>
+    freeze(const directed_adjacency_vector<V, E, T>& g, bool in = false)
+    {
+      return compressed_graph<V, E, typename T::index_type>(g, in);
+    }
+
+  template<typename V, typename E, typename T>
+    inline compressed_graph<V, E, typename T::index_type>
+    freeze(const directed_adjacency_list<V, E, T>& g, bool in = false)
+    {
+      return compressed_graph<V, E, typename T::index_type>(g, in);
+    }
+
+} // namespace origin
+
+#endif
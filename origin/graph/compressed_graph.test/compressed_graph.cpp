@@ -0,0 +1,149 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/compressed_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the sorted (target, value) pairs of the out edges of v.
+template<typename G>
+  vector<pair<size_t, int>>
+  out_list(const G& g, Vertex<G> v)
+  {
+    vector<pair<size_t, int>> out;
+    for (auto e : g.out_edges(v))
+      out.emplace_back(g.target(e), g(e));
+    sort(out.begin(), out.end());
+    return out;
+  }
+
+// Check that the compressed graph C is a faithful copy of the directed
+// graph G, which is a bidirected reflexive clique over 3 vertices.
+template<typename G>
+  void
+  check_freeze()
+  {
+    cout << "*** freeze (" << typestr<G>() << ") ***\n";
+    G g = build_reflexive_bidi_clique<G>(3);
+    auto c = freeze(g, true);
+    assert(c.has_in_edges());
+    assert(c.order() == g.order());
+    assert(c.size() == g.size());
+
+    for (auto v : c.vertices()) {
+      assert(c(v) == g(v));
+      assert(c.out_degree(v) == g.out_degree(v));
+      assert(c.in_degree(v) == g.in_degree(v));
+
+      // Out edges are ordered by target, and each carries the value of its
+      // own edge, including the two loops.
+      Vertex<G> prev = 0;
+      for (auto e : c.out_edges(v)) {
+        assert(c.source(e) == v);
+        assert(prev <= c.target(e));
+        prev = c.target(e);
+      }
+      assert(out_list(c, v) == out_list(g, Vertex<G>(v)));
+
+      // In edges are listed with their sources.
+      size_t i = c.in_offsets()[v];
+      for (auto e : c.in_edges(v)) {
+        assert(c.target(e) == v);
+        assert(c.source(e) == c.in_sources()[i++]);
+      }
+      assert(i == c.in_offsets()[v + 1]);
+    }
+
+    // Every pair of vertices is connected.
+    for (auto u : c.vertices())
+      for (auto v : c.vertices())
+        assert(c(u, v));
+  }
+
+// Check that removed vertices are skipped and that the remaining vertices
+// are renumbered densely.
+void
+check_freeze_renumber()
+{
+  cout << "*** freeze renumber ***\n";
+  using G = directed_adjacency_list<char, int>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 1, 1);
+  g.add_edge(1, 3, 2);
+  g.add_edge(3, 0, 3);
+  g.add_edge(2, 3, 4);
+  g.remove_vertex(2);
+
+  auto c = freeze(g);
+  assert(c.order() == 3);
+  assert(c.size() == 3);
+  assert(c(vertex_handle(2)) == 'd');
+  assert(c(c(0, 1)) == 1);
+  assert(c(c(1, 2)) == 2);
+  assert(c(c(2, 0)) == 3);
+  assert(!c(0, 2));
+}
+
+// Check that source(e) is computed correctly without the in edge index.
+void
+check_freeze_out_only()
+{
+  cout << "*** freeze out only ***\n";
+  using G = directed_adjacency_vector<char, int>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 3, 0);
+  g.add_edge(3, 1, 1);
+  g.add_edge(3, 2, 2);
+
+  auto c = freeze(g);
+  assert(!c.has_in_edges());
+  for (auto u : c.vertices())
+    for (auto e : c.out_edges(u))
+      assert(c.source(e) == u);
+}
+
+// Check that a frozen narrow graph stores 32-bit indexes.
+void
+check_freeze_narrow()
+{
+  cout << "*** freeze narrow ***\n";
+  using G = directed_adjacency_vector<char, int, narrow_adjacency_vector_traits>;
+  G g = build_reflexive_bidi_clique<G>(4);
+  auto c = freeze(g, true);
+  using C = decltype(c);
+  static_assert(is_same<C::index_type, uint32_t>::value, "");
+  static_assert(sizeof(C::vertex) == 4 && sizeof(C::edge) == 4, "");
+  assert(c.size() == g.size());
+  for (auto v : c.vertices()) {
+    assert(c.in_degree(v) == g.in_degree(Vertex<G>(v)));
+    assert(out_list(c, v) == out_list(g, Vertex<G>(v)));
+  }
+}
+
+int main()
+{
+  using C = compressed_graph<char, int>;
+  check_default_init<C>();
+
+  check_freeze<directed_adjacency_vector<char, int>>();
+  check_freeze<directed_adjacency_list<char, int>>();
+  check_freeze_renumber();
+  check_freeze_out_only();
+  check_freeze_narrow();
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_CORES_HPP
+#define ORIGIN_GRAPH_CORES_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <vector>
+
+#include <origin/graph/graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                             [graph.cores]
+  //                           Core Decomposition
+  //
+  // The k-core of an undirected graph is its largest subgraph in which every
+  // vertex has degree at least k. The core number of a vertex is the
+  // greatest k for which it is in the k-core, and the degeneracy of the
+  // graph is the greatest core number.
+  //
+  // The core numbers are computed by peeling, in the bucket algorithm of
+  // Batagelj and Zaversnik. The vertices are kept sorted by their current
+  // degree in an array of buckets. A vertex of least degree is removed
+  // repeatedly, and the degree of each of its remaining neighbors of
+  // greater degree is decremented, moving the neighbor to the front of its
+  // bucket and then into the bucket below. Every step is constant time, so
+  // the decomposition takes O(V + E) time.
+  //
+  // Parallel edges are counted with their multiplicity, and loops are
+  // ignored.
+
+  namespace cores_impl
+  {
+    constexpr std::size_t npos = -1;
+
+    // Returns the degree of v, without its loops.
+    template<typename G>
+      inline std::size_t
+      loopless_degree(const G& g, Vertex<G> v)
+      {
+        std::size_t d = g.degree(v);
+        for (auto e : g.edges(v))
+          d -= opposite(g, e, v) == v;
+        return d;
+      }
+
+  } // namespace cores_impl
+
+
+  // Write the core number of every vertex of g to core, indexed by handle.
+  // The slots of removed vertices are set to npos. If order is not null,
+  // the vertices are written to it in the order they are peeled, which is
+  // a degeneracy ordering. Returns the degeneracy of g.
+  template<typename G>
+    std::size_t
+    core_numbers(const G& g, std::size_t* core, Vertex<G>* order = nullptr)
+    {
+      static_assert(Undirected_graph<G>(), "");
+      using namespace cores_impl;
+      std::size_t n = vertex_bound(g);
+      std::fill(core, core + n, npos);
+
+      // The current degrees are kept in core.
+      std::size_t max = 0;
+      std::size_t live = 0;
+      for (Vertex<G> v : g.vertices()) {
+        core[v] = loopless_degree(g, v);
+        max = std::max(max, core[v]);
+        ++live;
+      }
+
+      // Sort the vertices by degree. The bucket of degree d starts at
+      // bin[d] in vert, and pos[v] is the position of v in vert.
+      std::vector<std::size_t> bin(max + 2, 0);
+      for (Vertex<G> v : g.vertices())
+        ++bin[core[v] + 1];
+      for (std::size_t d = 1; d < bin.size(); ++d)
+        bin[d] += bin[d - 1];
+      std::vector<std::size_t> vert(live);
+      std::vector<std::size_t> pos(n, npos);
+      for (Vertex<G> v : g.vertices()) {
+        pos[v] = bin[core[v]]++;
+        vert[pos[v]] = v;
+      }
+      for (std::size_t d = max + 1; d > 0; --d)
+        bin[d] = bin[d - 1];
+      bin[0] = 0;
+
+      std::size_t degeneracy = 0;
+      for (std::size_t i = 0; i < live; ++i) {
+        Vertex<G> v = vert[i];
+        degeneracy = std::max(degeneracy, core[v]);
+        if (order)
+          order[i] = v;
+        for (auto e : g.edges(v)) {
+          Vertex<G> u = opposite(g, e, v);
+          if (core[u] <= core[v])
+            continue;
+
+          // Swap u with the first vertex of its bucket, and shrink the
+          // bucket past it.
+          std::size_t du = core[u];
+          std::size_t pu = pos[u];
+          std::size_t pw = bin[du];
+          std::size_t w = vert[pw];
+          if (std::size_t(u) != w) {
+            pos[u] = pw;
+            vert[pu] = w;
+            pos[w] = pu;
+            vert[pw] = u;
+          }
+          ++bin[du];
+          --core[u];
+        }
+      }
+      return degeneracy;
+    }
+
+} // namespace origin
+
+#endif
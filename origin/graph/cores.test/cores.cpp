@@ -0,0 +1,152 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/cores.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+constexpr size_t npos = -1;
+
+// Returns the core numbers of g, by removing the vertices of degree less
+// than k from the graph, for increasing k, until none is left.
+template<typename G>
+  vector<size_t>
+  peel(const G& g)
+  {
+    vector<size_t> core(g.vertex_bound(), npos);
+    vector<bool> alive(g.vertex_bound(), false);
+    size_t left = 0;
+    for (auto v : g.vertices()) {
+      alive[v] = true;
+      ++left;
+    }
+    auto degree = [&](Vertex<G> v) {
+      size_t d = 0;
+      for (auto e : g.edges(v)) {
+        auto u = opposite(g, e, v);
+        d += u != v && alive[u];
+      }
+      return d;
+    };
+    for (size_t k = 0; left != 0; ++k) {
+      bool removed = true;
+      while (removed) {
+        removed = false;
+        for (auto v : g.vertices()) {
+          if (alive[v] && degree(v) <= k) {
+            alive[v] = false;
+            core[v] = k;
+            removed = true;
+            --left;
+          }
+        }
+      }
+    }
+    return core;
+  }
+
+// Check the core numbers and peeling order of g.
+template<typename G>
+  void
+  check_cores(const G& g)
+  {
+    cout << "*** cores (" << typestr<G>() << ") ***\n";
+    vector<size_t> core(g.vertex_bound(), 7);
+    vector<Vertex<G>> order(g.order());
+    size_t k = core_numbers(g, core.data(), order.data());
+    assert(core == peel(g));
+    size_t max = 0;
+    for (auto v : g.vertices())
+      max = std::max(max, core[v]);
+    assert(k == max);
+
+    // Each vertex has at most its core number of neighbors peeled after
+    // it.
+    vector<size_t> rank(g.vertex_bound(), npos);
+    for (size_t i = 0; i < order.size(); ++i) {
+      assert(rank[order[i]] == npos);
+      rank[order[i]] = i;
+    }
+    for (auto v : g.vertices()) {
+      size_t later = 0;
+      for (auto e : g.edges(v)) {
+        auto u = opposite(g, e, v);
+        later += u != v && rank[u] > rank[v];
+      }
+      assert(later <= core[v]);
+    }
+  }
+
+void
+check_shapes()
+{
+  cout << "*** core shapes ***\n";
+  using G = undirected_adjacency_list<char>;
+  using V = Vertex<G>;
+
+  // A clique of 5 with a path hanging from it, an isolated vertex, and a
+  // vertex with only a loop.
+  G g = build_n_graph<G>(10);
+  for (size_t i = 0; i < 5; ++i)
+    for (size_t j = i + 1; j < 5; ++j)
+      g.add_edge(V(i), V(j));
+  g.add_edge(V(4), V(5));
+  g.add_edge(V(5), V(6));
+  g.add_edge(V(9), V(9));
+  vector<size_t> core(10);
+  assert(core_numbers(g, core.data()) == 4);
+  assert((core == vector<size_t> {4, 4, 4, 4, 4, 1, 1, 0, 0, 0}));
+
+  // Parallel edges count with their multiplicity.
+  g.add_edge(V(7), V(8));
+  g.add_edge(V(7), V(8));
+  g.remove_vertex(V(6));
+  assert(core_numbers(g, core.data()) == 4);
+  assert(core[6] == npos && core[5] == 1 && core[7] == 2 && core[8] == 2);
+
+  G empty;
+  assert(core_numbers(empty, core.data()) == 0);
+}
+
+int main()
+{
+  check_shapes();
+
+  using L = undirected_adjacency_list<char, int>;
+  minstd_rand gen;
+  for (size_t m : {50, 400, 2000}) {
+    L g = build_n_graph<L>(100);
+    for (size_t i = 0; i < m; ++i)
+      g.add_edge(Vertex<L>(gen() % 100), Vertex<L>(gen() % 100), int(i));
+    check_cores(g);
+  }
+
+  L h = build_n_graph<L>(80);
+  for (size_t i = 0; i < 600; ++i)
+    h.add_edge(Vertex<L>(gen() % 80), Vertex<L>(gen() % 80), int(i));
+  h.remove_vertex(Vertex<L>(11));
+  h.remove_vertex(Vertex<L>(12));
+  check_cores(h);
+
+  vector<tuple<size_t, size_t>> es;
+  for (size_t i = 0; i < 1000; ++i)
+    es.emplace_back(gen() % 150, gen() % 150);
+  check_cores(undirected_adjacency_vector<char>(150, es));
+}
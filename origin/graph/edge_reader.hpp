@@ -0,0 +1,711 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_EDGE_READER_HPP
+#define ORIGIN_GRAPH_EDGE_READER_HPP
+
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <origin/type/empty.hpp>
+#include <origin/type/traits.hpp>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/mapped_graph.hpp>
+#include <origin/graph/parallel.hpp>
+
+namespace origin
+{
+  namespace io
+  {
+    // ---------------------------------------------------------------------- //
+    //                                                        [graph.io.read]
+    //                             Edge List Readers
+    //
+    // An edge reader parses a text file listing the edges of a graph, one
+    // per line, into a vector of edge tuples that can be given to the bulk
+    // constructor of an adjacency vector. The supported formats are:
+    //
+    //    snap            "u v" lines with 0-based vertices. Lines starting
+    //                    with '#' are comments. The order of the graph is one
+    //                    more than the greatest vertex.
+    //    matrix_market   A coordinate Matrix Market file: the banner, '%'
+    //                    comments, a "rows cols entries" line, and "i j"
+    //                    lines with 1-based indices. The order of the graph
+    //                    is the greater of rows and cols.
+    //    dimacs          A DIMACS graph: 'c' comments, a "p type n m" line,
+    //                    and "a u v" or "e u v" lines with 1-based vertices.
+    //
+    // Every format allows a weight after the endpoints. If the reader has a
+    // weight type, the weight is stored as the third element of each tuple,
+    // and an absent weight is 1. Otherwise, weights are ignored. Further
+    // fields on a line are also ignored.
+    //
+    // The header is parsed first. The rest of the file is split into chunks
+    // of about chunk_size bytes that begin at the start of a line, and the
+    // chunks are parsed by a team of threads into separate edge vectors,
+    // which are then concatenated in file order. Integers and weights are
+    // parsed directly from the text, without streams or locales. Files are
+    // mapped into memory rather than read.
+    //
+    // Reading fails if the file cannot be mapped, or if it is malformed: a
+    // line that cannot be parsed, a vertex out of the declared range, or a
+    // number of edges different from the declared count. After a failure,
+    // error_line() is the line of the first error, or 0 if the file could
+    // not be mapped. An empty file is read as empty input, which is a SNAP
+    // graph with no edges.
+
+    enum class edge_format { snap, matrix_market, dimacs };
+
+    namespace edge_reader_impl
+    {
+      constexpr std::size_t npos = -1;
+
+      // Exactly representable powers of 10.
+      constexpr double powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+      };
+
+      inline bool
+      is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+      inline bool
+      is_digit(char c) { return unsigned(c - '0') < 10u; }
+
+      inline const char*
+      skip_blanks(const char* p, const char* last)
+      {
+        while (p != last && is_blank(*p))
+          ++p;
+        return p;
+      }
+
+      // Returns the end of the line starting at p.
+      inline const char*
+      line_end(const char* p, const char* last)
+      {
+        const void* q = std::memchr(p, '\n', last - p);
+        return q ? static_cast<const char*>(q) : last;
+      }
+
+      // Returns the start of the line following the line ending at eol.
+      inline const char*
+      next_line(const char* eol, const char* last)
+      {
+        return eol == last ? last : eol + 1;
+      }
+
+      // Returns true if a field ends at p.
+      inline bool
+      field_end(const char* p, const char* last)
+      {
+        return p == last || is_blank(*p);
+      }
+
+      // Returns the next field of [p, last) in lower case, advancing p past
+      // it.
+      inline std::string
+      next_token(const char*& p, const char* last)
+      {
+        p = skip_blanks(p, last);
+        const char* q = p;
+        while (p != last && !is_blank(*p))
+          ++p;
+        std::string s(q, p);
+        for (char& c : s)
+          c = std::tolower(c);
+        return s;
+      }
+
+      // Parse an unsigned decimal field of at most 19 digits at p into x.
+      // Returns the end of the field, or nullptr if p does not start such a
+      // field.
+      inline const char*
+      parse_unsigned(const char* p, const char* last, std::uint64_t& x)
+      {
+        const char* first = p;
+        std::uint64_t n = 0;
+        for (; p != last && is_digit(*p); ++p)
+          n = n * 10 + unsigned(*p - '0');
+        if (p == first || p - first > 19 || !field_end(p, last))
+          return nullptr;
+        x = n;
+        return p;
+      }
+
+      // Parse an optional sign at p, advancing p past it. Returns true if
+      // the sign is negative.
+      inline bool
+      parse_sign(const char*& p, const char* last)
+      {
+        if (p == last || (*p != '-' && *p != '+'))
+          return false;
+        return *p++ == '-';
+      }
+
+      // Parse a signed decimal integer.
+      template<typename T>
+        inline const char*
+        parse_number(const char* p, const char* last, T& x, std::true_type)
+        {
+          bool neg = parse_sign(p, last);
+          std::uint64_t n;
+          if (!(p = parse_unsigned(p, last, n)))
+            return nullptr;
+          x = neg ? T(-std::int64_t(n)) : T(n);
+          return p;
+        }
+
+      // Parse a decimal floating point number. The first 19 significant
+      // digits are accumulated in an integer, which is scaled by a power of
+      // 10. When the digits and the power are exactly representable, the
+      // result is correctly rounded.
+      template<typename T>
+        const char*
+        parse_number(const char* p, const char* last, T& x, std::false_type)
+        {
+          bool neg = parse_sign(p, last);
+          bool any = false;
+          std::uint64_t m = 0;
+          int digits = 0;
+          int exp = 0;
+          for (; p != last && is_digit(*p); ++p) {
+            any = true;
+            if (digits < 19) {
+              m = m * 10 + unsigned(*p - '0');
+              digits += m != 0;
+            } else {
+              ++exp;
+            }
+          }
+          if (p != last && *p == '.') {
+            for (++p; p != last && is_digit(*p); ++p) {
+              any = true;
+              if (digits < 19) {
+                m = m * 10 + unsigned(*p - '0');
+                digits += m != 0;
+                --exp;
+              }
+            }
+          }
+          if (!any)
+            return nullptr;
+          if (p != last && (*p == 'e' || *p == 'E')) {
+            ++p;
+            bool eneg = parse_sign(p, last);
+            const char* q = p;
+            int e = 0;
+            for (; p != last && is_digit(*p); ++p)
+              e = std::min(e * 10 + (*p - '0'), 100000);
+            if (p == q)
+              return nullptr;
+            exp += eneg ? -e : e;
+          }
+          if (!field_end(p, last))
+            return nullptr;
+
+          double v = double(m);
+          if (m < (std::uint64_t(1) << 53) && exp >= -22 && exp <= 22)
+            v = exp < 0 ? v / powers[-exp] : v * powers[exp];
+          else if (exp < 0)
+            v = exp < -300 ? v / 1e300 / std::pow(10.0, -exp - 300)
+                           : v / std::pow(10.0, -exp);
+          else
+            v *= std::pow(10.0, exp);
+          x = T(neg ? -v : v);
+          return p;
+        }
+
+      // Parse the weight of an edge. An absent weight is 1.
+      template<typename W>
+        inline const char*
+        parse_weight(const char* p, const char* last, W& w)
+        {
+          if (p == last) {
+            w = W(1);
+            return p;
+          }
+          return parse_number(p, last, w, std::is_integral<W>());
+        }
+
+      inline const char*
+      parse_weight(const char* p, const char*, empty_t&) { return p; }
+
+      inline std::tuple<std::size_t, std::size_t>
+      make_edge(std::size_t u, std::size_t v, empty_t)
+      {
+        return std::make_tuple(u, v);
+      }
+
+      template<typename W>
+        inline std::tuple<std::size_t, std::size_t, W>
+        make_edge(std::size_t u, std::size_t v, const W& w)
+        {
+          return std::make_tuple(u, v, w);
+        }
+
+      // A chunk of the body of a file and the edges parsed from it.
+      template<typename T>
+        struct chunk
+        {
+          chunk(const char* first, const char* last)
+            : first(first), last(last), lines(0), error(0), bound(0)
+          { }
+
+          const char* first;
+          const char* last;
+          std::vector<T> edges;
+          std::size_t lines;  // The number of lines parsed
+          std::size_t error;  // The line of the first error, or 0
+          std::size_t bound;  // One past the greatest vertex
+        };
+
+      // Parse the line [p, last) into the chunk c. Vertices are given from
+      // base, and must be less than limit. Returns false if the line is
+      // malformed.
+      template<typename W, typename T>
+        bool
+        parse_line(edge_format f, const char* p, const char* last,
+                   std::size_t base, std::size_t limit, chunk<T>& c)
+        {
+          p = skip_blanks(p, last);
+          if (p == last)
+            return true;
+          switch (f) {
+          case edge_format::snap:
+            if (*p == '#')
+              return true;
+            break;
+          case edge_format::matrix_market:
+            if (*p == '%')
+              return true;
+            break;
+          case edge_format::dimacs:
+            if (*p == 'c')
+              return true;
+            if ((*p != 'a' && *p != 'e') || !field_end(p + 1, last))
+              return false;
+            ++p;
+            break;
+          }
+
+          std::uint64_t u, v;
+          W w;
+          if (!(p = parse_unsigned(skip_blanks(p, last), last, u)))
+            return false;
+          if (!(p = parse_unsigned(skip_blanks(p, last), last, v)))
+            return false;
+          if (!(p = parse_weight(skip_blanks(p, last), last, w)))
+            return false;
+          if (u < base || v < base || u - base >= limit || v - base >= limit)
+            return false;
+          u -= base;
+          v -= base;
+          c.bound = std::max<std::size_t>(c.bound, std::max(u, v) + 1);
+          c.edges.push_back(make_edge(u, v, w));
+          return true;
+        }
+
+      // Parse the lines of a chunk, stopping at the first error.
+      template<typename W, typename T>
+        void
+        parse_chunk(edge_format f, std::size_t base, std::size_t limit, chunk<T>& c)
+        {
+          const char* p = c.first;
+          while (p != c.last) {
+            const char* eol = line_end(p, c.last);
+            ++c.lines;
+            if (!parse_line<W>(f, p, eol, base, limit, c)) {
+              c.error = c.lines;
+              return;
+            }
+            p = next_line(eol, c.last);
+          }
+        }
+
+    } // namespace edge_reader_impl
+
+
+    // The edge reader. W is the weight type, or empty_t if weights are
+    // ignored.
+    template<typename W = empty_t>
+      class edge_reader
+      {
+      public:
+        using weight_type = W;
+        using edge_tuple =
+          If<std::is_same<W, empty_t>::value,
+             std::tuple<std::size_t, std::size_t>,
+             std::tuple<std::size_t, std::size_t, W>>;
+
+        // Create a reader for the format f that runs on the given number of
+        // threads. If threads is 0, the hardware concurrency is used.
+        explicit edge_reader(edge_format f, std::size_t threads = 0)
+          : format_(f), threads_(parallel_impl::team_size(threads))
+        {
+          reset();
+        }
+
+        edge_format format() const { return format_; }
+        std::size_t threads() const { return threads_; }
+
+        // Read the edges of the file at path. Returns false if the file
+        // cannot be mapped or is malformed.
+        bool read(const std::string& path);
+
+        // Parse the edges of the text [first, last). Returns false if the
+        // text is malformed.
+        bool parse(const char* first, const char* last);
+
+        // The order of the graph and the edges read.
+        std::size_t order() const { return order_; }
+        std::size_t size() const  { return edges_.size(); }
+
+        const std::vector<edge_tuple>& edges() const { return edges_; }
+        std::vector<edge_tuple>&       edges()       { return edges_; }
+
+        // Returns true if a Matrix Market file declares a symmetric or
+        // skew-symmetric matrix, in which case only one of each pair of edges
+        // is listed. The weight of the unlisted edge of a skew-symmetric
+        // matrix is the negated weight of the listed one.
+        bool symmetric() const { return symmetric_; }
+        bool skew_symmetric() const { return skew_; }
+
+        // Returns the line of the first error of the last read, or 0.
+        std::size_t error_line() const { return error_; }
+
+        // The number of bytes in each chunk parsed by a thread.
+        std::size_t chunk_size = std::size_t(1) << 22;
+
+      private:
+        void reset();
+        bool fail(std::size_t line);
+        const char* parse_header(const char* p, const char* last);
+        const char* matrix_market_header(const char* p, const char* last);
+        const char* dimacs_header(const char* p, const char* last);
+
+      private:
+        edge_format format_;
+        std::size_t threads_;
+        std::size_t order_;
+        std::size_t count_;       // The declared number of edges, or npos
+        std::size_t count_line_;  // The line declaring the count
+        std::size_t lines_;       // The number of header lines
+        std::size_t error_;
+        bool symmetric_;
+        bool skew_;
+        std::vector<edge_tuple> edges_;
+      };
+
+    template<typename W>
+      void
+      edge_reader<W>::reset()
+      {
+        order_ = 0;
+        count_ = edge_reader_impl::npos;
+        count_line_ = 0;
+        lines_ = 0;
+        error_ = 0;
+        symmetric_ = false;
+        skew_ = false;
+        edges_.clear();
+      }
+
+    template<typename W>
+      inline bool
+      edge_reader<W>::fail(std::size_t line)
+      {
+        reset();
+        error_ = line;
+        return false;
+      }
+
+    template<typename W>
+      bool
+      edge_reader<W>::read(const std::string& path)
+      {
+        mapped_graph_impl::mapped_file file;
+        if (!file.open(path))
+          return fail(0);
+
+        // An empty file is not mapped. It is parsed as the empty string,
+        // since a null body would be taken for a header error.
+        if (!file.data())
+          return parse("", "");
+        return parse(file.data(), file.data() + file.size());
+      }
+
+    template<typename W>
+      bool
+      edge_reader<W>::parse(const char* first, const char* last)
+      {
+        using namespace edge_reader_impl;
+        reset();
+        const char* body = parse_header(first, last);
+        if (!body)
+          return false;
+
+        // Split the body into chunks that start at the start of a line.
+        std::vector<chunk<edge_tuple>> chunks;
+        std::size_t step = std::max<std::size_t>(chunk_size, 1);
+        for (const char* p = body; p != last; ) {
+          const char* q = last;
+          if (std::size_t(last - p) > step)
+            q = next_line(line_end(p + step - 1, last), last);
+          chunks.emplace_back(p, q);
+          p = q;
+        }
+
+        std::size_t base = format_ == edge_format::snap ? 0 : 1;
+        std::size_t limit = format_ == edge_format::snap ? npos : order_;
+        parallel_impl::parallel_for(threads_, chunks.size(), 1,
+          [&](std::size_t, std::size_t i, std::size_t j) {
+            for (; i < j; ++i)
+              parse_chunk<W>(format_, base, limit, chunks[i]);
+          });
+
+        // Find the first error, and the position of each chunk's edges.
+        std::vector<std::size_t> offsets(chunks.size() + 1, 0);
+        std::size_t line = lines_;
+        std::size_t bound = 0;
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+          if (chunks[i].error)
+            return fail(line + chunks[i].error);
+          line += chunks[i].lines;
+          bound = std::max(bound, chunks[i].bound);
+          offsets[i + 1] = offsets[i] + chunks[i].edges.size();
+        }
+        if (count_ != npos && offsets.back() != count_)
+          return fail(count_line_);
+        if (format_ == edge_format::snap)
+          order_ = bound;
+
+        edges_.resize(offsets.back());
+        parallel_impl::parallel_for(threads_, chunks.size(), 1,
+          [&](std::size_t, std::size_t i, std::size_t j) {
+            for (; i < j; ++i) {
+              std::vector<edge_tuple>& es = chunks[i].edges;
+              std::move(es.begin(), es.end(), edges_.begin() + offsets[i]);
+              std::vector<edge_tuple>().swap(es);
+            }
+          });
+        return true;
+      }
+
+    // Parse the header of the file, if any. Returns the start of the body,
+    // or nullptr if the header is malformed.
+    template<typename W>
+      inline const char*
+      edge_reader<W>::parse_header(const char* p, const char* last)
+      {
+        switch (format_) {
+        case edge_format::matrix_market:
+          return matrix_market_header(p, last);
+        case edge_format::dimacs:
+          return dimacs_header(p, last);
+        default:
+          return p;
+        }
+      }
+
+    template<typename W>
+      const char*
+      edge_reader<W>::matrix_market_header(const char* p, const char* last)
+      {
+        using namespace edge_reader_impl;
+        const char* eol = line_end(p, last);
+        const char* q = p;
+        ++lines_;
+        if (next_token(q, eol) != "%%matrixmarket" ||
+            next_token(q, eol) != "matrix" ||
+            next_token(q, eol) != "coordinate") {
+          fail(lines_);
+          return nullptr;
+        }
+        std::string field = next_token(q, eol);
+        std::string symmetry = next_token(q, eol);
+        if ((field != "real" && field != "integer" && field != "pattern") ||
+            (symmetry != "general" && symmetry != "symmetric" &&
+             symmetry != "skew-symmetric")) {
+          fail(lines_);
+          return nullptr;
+        }
+        bool symmetric = symmetry != "general";
+        bool skew = symmetry == "skew-symmetric";
+
+        // Skip comments up to the size line.
+        for (p = next_line(eol, last); p != last; ) {
+          eol = line_end(p, last);
+          q = skip_blanks(p, eol);
+          p = next_line(eol, last);
+          ++lines_;
+          if (q == eol || *q == '%')
+            continue;
+          std::uint64_t rows, cols, count;
+          if (!(q = parse_unsigned(q, eol, rows)) ||
+              !(q = parse_unsigned(skip_blanks(q, eol), eol, cols)) ||
+              !(q = parse_unsigned(skip_blanks(q, eol), eol, count)) ||
+              skip_blanks(q, eol) != eol) {
+            fail(lines_);
+            return nullptr;
+          }
+          order_ = std::max(rows, cols);
+          count_ = count;
+          count_line_ = lines_;
+          symmetric_ = symmetric;
+          skew_ = skew;
+          return p;
+        }
+        fail(lines_ + 1);
+        return nullptr;
+      }
+
+    template<typename W>
+      const char*
+      edge_reader<W>::dimacs_header(const char* p, const char* last)
+      {
+        using namespace edge_reader_impl;
+        bool problem = false;
+        while (p != last) {
+          const char* eol = line_end(p, last);
+          const char* q = skip_blanks(p, eol);
+          if (q != eol && *q != 'c' && *q != 'p')
+            break;
+          p = next_line(eol, last);
+          ++lines_;
+          if (q == eol || *q == 'c')
+            continue;
+
+          // The problem line: p type n m.
+          ++q;
+          std::uint64_t n, m;
+          if (problem || !field_end(q, eol) || next_token(q, eol).empty() ||
+              !(q = parse_unsigned(skip_blanks(q, eol), eol, n)) ||
+              !(q = parse_unsigned(skip_blanks(q, eol), eol, m)) ||
+              skip_blanks(q, eol) != eol) {
+            fail(lines_);
+            return nullptr;
+          }
+          order_ = n;
+          count_ = m;
+          count_line_ = lines_;
+          problem = true;
+        }
+        if (!problem) {
+          fail(lines_ + 1);
+          return nullptr;
+        }
+        return p;
+      }
+
+
+    namespace edge_reader_impl
+    {
+      // Build g from the edges es over n vertices. Graphs with a bulk
+      // constructor are built by it. Otherwise, the vertices and edges are
+      // added one at a time.
+      template<typename G, typename R>
+        inline auto
+        load_graph(G& g, std::size_t n, const R& es, int)
+          -> decltype(g.assign_edges(es), void())
+        {
+          g = G(n, es);
+        }
+
+      template<typename G>
+        inline void
+        add_tuple(G& g, const std::tuple<std::size_t, std::size_t>& x)
+        {
+          g.add_edge(Vertex<G>(std::get<0>(x)), Vertex<G>(std::get<1>(x)));
+        }
+
+      template<typename G, typename W>
+        inline void
+        add_tuple(G& g, const std::tuple<std::size_t, std::size_t, W>& x)
+        {
+          g.add_edge(Vertex<G>(std::get<0>(x)), Vertex<G>(std::get<1>(x)),
+                     std::get<2>(x));
+        }
+
+      template<typename G, typename R>
+        void
+        load_graph(G& g, std::size_t n, const R& es, long)
+        {
+          g = G();
+          for (std::size_t i = 0; i < n; ++i)
+            g.add_vertex();
+          for (const auto& x : es)
+            add_tuple(g, x);
+        }
+
+      // Append the reverse of x to es, negating its weight if skew is true.
+      inline void
+      add_mirror(std::vector<std::tuple<std::size_t, std::size_t>>& es,
+                 std::tuple<std::size_t, std::size_t> x, bool)
+      {
+        es.emplace_back(std::get<1>(x), std::get<0>(x));
+      }
+
+      template<typename W>
+        inline void
+        add_mirror(std::vector<std::tuple<std::size_t, std::size_t, W>>& es,
+                   std::tuple<std::size_t, std::size_t, W> x, bool skew)
+        {
+          es.emplace_back(std::get<1>(x), std::get<0>(x),
+                          skew ? W(-std::get<2>(x)) : std::get<2>(x));
+        }
+
+      // Add the unlisted edges of a symmetric matrix: the reverse of every
+      // edge that is not a loop.
+      template<typename T>
+        void
+        mirror_edges(std::vector<T>& es, bool skew)
+        {
+          std::size_t n = es.size();
+          es.reserve(2 * n);
+          for (std::size_t i = 0; i < n; ++i)
+            if (std::get<0>(es[i]) != std::get<1>(es[i]))
+              add_mirror(es, es[i], skew);
+        }
+
+    } // namespace edge_reader_impl
+
+
+    // Read the graph g from the edge list file at path in the format f,
+    // using the given number of threads to parse it. Edge values are
+    // initialized by the weights, if W is not empty_t. If the file holds a
+    // symmetric matrix and g is directed, both edges of each listed pair are
+    // added. Returns false, and leaves g unchanged, if the file cannot be
+    // read.
+    template<typename W = empty_t, typename G>
+      bool
+      read_graph(const std::string& path, edge_format f, G& g,
+                 std::size_t threads = 0)
+      {
+        edge_reader<W> r(f, threads);
+        if (!r.read(path))
+          return false;
+        if (r.symmetric() && Directed_graph<G>())
+          edge_reader_impl::mirror_edges(r.edges(), r.skew_symmetric());
+        edge_reader_impl::load_graph(g, r.order(), r.edges(), 0);
+        return true;
+      }
+
+  } // namespace io
+
+} // namespace origin
+
+#endif
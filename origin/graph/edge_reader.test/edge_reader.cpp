@@ -0,0 +1,293 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/edge_reader.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::io;
+using namespace testing;
+
+const string path = "edge_reader.test.txt";
+
+using edge_pair = tuple<size_t, size_t>;
+using edge_triple = tuple<size_t, size_t, double>;
+
+// Parse text with each number of threads and a range of chunk sizes, and
+// check that every parse gives the same result. Returns the result of the
+// serial parse.
+template<typename W>
+  edge_reader<W>
+  parse_all(edge_format f, const string& text)
+  {
+    edge_reader<W> serial(f, 1);
+    bool ok = serial.parse(text.data(), text.data() + text.size());
+    for (size_t t : {1, 4}) {
+      for (size_t c : {1, 7, 64, 4096}) {
+        edge_reader<W> r(f, t);
+        r.chunk_size = c;
+        assert(r.parse(text.data(), text.data() + text.size()) == ok);
+        assert(r.error_line() == serial.error_line());
+        assert(r.order() == serial.order());
+        assert(r.edges() == serial.edges());
+      }
+    }
+    return serial;
+  }
+
+void
+check_snap()
+{
+  cout << "*** snap ***\n";
+  string text =
+    "# Directed graph\n"
+    "# FromNodeId\tToNodeId\n"
+    "0\t1\n"
+    "1 2\r\n"
+    "\n"
+    "  3   0  \n"
+    "# trailing comment\n"
+    "2 7 1359000000";
+  auto r = parse_all<empty_t>(edge_format::snap, text);
+  assert(r.order() == 8 && r.size() == 4);
+  assert((r.edges() == vector<edge_pair> {edge_pair(0, 1), edge_pair(1, 2), edge_pair(3, 0), edge_pair(2, 7)}));
+
+  // Weights follow the endpoints.
+  auto w = parse_all<double>(edge_format::snap, "0 1 2.5\n1 0\n1 1 -3e2\n");
+  assert((w.edges() == vector<edge_triple> {
+    edge_triple(0, 1, 2.5), edge_triple(1, 0, 1), edge_triple(1, 1, -300)
+  }));
+
+  // An empty edge list.
+  assert(parse_all<empty_t>(edge_format::snap, "# nothing\n").order() == 0);
+
+  // Malformed lines.
+  assert(parse_all<empty_t>(edge_format::snap, "0 1\n1\n").error_line() == 2);
+  assert(parse_all<empty_t>(edge_format::snap, "0 1\n1 2x\n").error_line() == 2);
+  assert(parse_all<empty_t>(edge_format::snap, "0 1\n-1 2\n").error_line() == 2);
+  assert(parse_all<int>(edge_format::snap, "0 1\n\n0 2 1.5\n").error_line() == 3);
+  assert(parse_all<double>(edge_format::snap, "0 1 e5\n").error_line() == 1);
+  assert(parse_all<empty_t>(edge_format::snap, "0 123456789012345678901\n").error_line() == 1);
+}
+
+void
+check_matrix_market()
+{
+  cout << "*** matrix market ***\n";
+  string text =
+    "%%MatrixMarket matrix coordinate real general\n"
+    "% A comment\n"
+    "%\n"
+    "3 4 3\n"
+    "1 1 0.5\n"
+    "3 4 1e-3\n"
+    "% Another comment\n"
+    "2 1 -7\n";
+  auto r = parse_all<double>(edge_format::matrix_market, text);
+  assert(r.order() == 4 && !r.symmetric() && !r.skew_symmetric());
+  assert((r.edges() == vector<edge_triple> {
+    edge_triple(0, 0, 0.5), edge_triple(2, 3, 0.001), edge_triple(1, 0, -7)
+  }));
+
+  string pattern =
+    "%%MatrixMarket Matrix Coordinate Pattern Symmetric\n"
+    "5 5 2\n"
+    "2 1\n"
+    "5 3\n";
+  auto p = parse_all<int>(edge_format::matrix_market, pattern);
+  assert(p.order() == 5 && p.symmetric() && !p.skew_symmetric());
+  assert((p.edges() == vector<tuple<size_t, size_t, int>> {
+    make_tuple(1, 0, 1), make_tuple(4, 2, 1)
+  }));
+
+  // Malformed files: a bad banner, a dense matrix, a missing size line,
+  // indices out of range, and a wrong number of entries.
+  auto error = [](const string& s) {
+    return parse_all<empty_t>(edge_format::matrix_market, s).error_line();
+  };
+  assert(error("3 3 1\n1 1\n") == 1);
+  assert(error("%%MatrixMarket matrix array real general\n3 3\n") == 1);
+  assert(error("%%MatrixMarket matrix coordinate real general\n% only\n") == 3);
+  assert(error("%%MatrixMarket matrix coordinate real general\n2 2 1\n0 1\n") == 3);
+  assert(error("%%MatrixMarket matrix coordinate real general\n2 2 1\n1 3\n") == 3);
+  assert(error("%%MatrixMarket matrix coordinate real general\n%\n2 2 2\n1 2\n") == 3);
+}
+
+void
+check_dimacs()
+{
+  cout << "*** dimacs ***\n";
+  string text =
+    "c 9th DIMACS Implementation Challenge\n"
+    "p sp 4 3\n"
+    "c arcs\n"
+    "a 1 2 7\n"
+    "a 2 4 3\n"
+    "a 4 1 11\n";
+  auto r = parse_all<int>(edge_format::dimacs, text);
+  assert(r.order() == 4);
+  assert((r.edges() == vector<tuple<size_t, size_t, int>> {
+    make_tuple(0, 1, 7), make_tuple(1, 3, 3), make_tuple(3, 0, 11)
+  }));
+  assert(parse_all<empty_t>(edge_format::dimacs, "p edge 3 1\ne 1 3\n").size() == 1);
+
+  auto error = [](const string& s) {
+    return parse_all<empty_t>(edge_format::dimacs, s).error_line();
+  };
+  assert(error("c no problem line\na 1 2\n") == 2);
+  assert(error("p sp 2\na 1 2\n") == 1);
+  assert(error("p sp 2 1\na 1 3\n") == 2);
+  assert(error("p sp 2 2\na 1 2\np sp 2 2\na 2 1\n") == 3);
+  assert(error("p sp 2 2\na 1 2\nx 2 1\n") == 3);
+  assert(error("p sp 2 2\na 1 2\n") == 1);
+}
+
+// Parse a large file, with an error near the end.
+void
+check_large()
+{
+  cout << "*** large edge list ***\n";
+  minstd_rand gen;
+  vector<edge_triple> es;
+  ostringstream ss;
+  ss << "%%MatrixMarket matrix coordinate integer general\n";
+  size_t n = 5000, m = 100000;
+  ss << n << ' ' << n << ' ' << m << '\n';
+  for (size_t i = 0; i < m; ++i) {
+    size_t u = gen() % n, v = gen() % n, w = gen() % 1000;
+    es.emplace_back(u, v, w);
+    ss << u + 1 << ' ' << v + 1 << ' ' << w << '\n';
+  }
+  string text = ss.str();
+  for (size_t t : {1, 4}) {
+    edge_reader<double> r(edge_format::matrix_market, t);
+    r.chunk_size = 1000;
+    assert(r.parse(text.data(), text.data() + text.size()));
+    assert(r.order() == n && r.edges() == es);
+  }
+
+  size_t pos = text.size() - 10;
+  text[pos] = 'x';
+  size_t line = 1;
+  for (size_t i = 0; i < pos; ++i)
+    line += text[i] == '\n';
+  edge_reader<double> r(edge_format::matrix_market, 4);
+  r.chunk_size = 1000;
+  assert(!r.parse(text.data(), text.data() + text.size()));
+  assert(r.error_line() == line && r.size() == 0);
+}
+
+// Weights are parsed like strtod.
+void
+check_numbers()
+{
+  cout << "*** numbers ***\n";
+  for (string s : {"0", "1.5", "-2e3", "0.1", ".5", "5.", "+3.25E-2", "123456.789",
+                   "0.000001", "1e22", "9007199254740993", "2.2250738585072014e-308"}) {
+    string line = "0 0 " + s;
+    edge_reader<double> r(edge_format::snap, 1);
+    assert(r.parse(line.data(), line.data() + line.size()));
+    double x = get<2>(r.edges()[0]);
+    double y = strtod(s.c_str(), nullptr);
+    assert(abs(x - y) <= abs(y) * 1e-15);
+  }
+}
+
+// Files are read and loaded into graphs.
+void
+check_files()
+{
+  cout << "*** edge list files ***\n";
+  {
+    ofstream out(path);
+    out << "c road network\np sp 4 4\na 1 2 5\na 2 3 6\na 3 4 7\na 4 2 8\n";
+  }
+
+  using DV = directed_adjacency_vector<char, int>;
+  DV g;
+  assert(read_graph<int>(path, edge_format::dimacs, g, 2));
+  assert(g.order() == 4 && g.size() == 4);
+  for (auto e : g.edges())
+    assert(g(e) == int(size_t(g.source(e)) + 5));
+
+  using UL = undirected_adjacency_list<char, int>;
+  UL h;
+  assert(read_graph<int>(path, edge_format::dimacs, h, 2));
+  assert(h.order() == 4 && h.size() == 4);
+  assert(h.degree(Vertex<UL>(1)) == 3);
+  for (auto e : h.edges())
+    assert(h(e) == int(size_t(h.source(e)) + 5));
+
+  // Weights may be ignored.
+  directed_adjacency_vector<char> u;
+  assert(read_graph(path, edge_format::dimacs, u));
+  assert(u.size() == 4);
+
+  // A failed read leaves the graph unchanged.
+  assert(!read_graph<int>(path, edge_format::snap, g));
+  assert(!read_graph<int>("no such file", edge_format::snap, g));
+  assert(g.order() == 4 && g.size() == 4);
+
+  edge_reader<> r(edge_format::snap);
+  assert(!r.read("no such file") && r.error_line() == 0);
+
+  // Symmetric matrices give both edges of each listed pair to directed
+  // graphs, and one edge to undirected graphs. Loops are not doubled, and
+  // the weights of a skew-symmetric matrix are negated.
+  {
+    ofstream out(path);
+    out << "%%MatrixMarket matrix coordinate integer symmetric\n"
+        << "3 3 3\n2 1 4\n3 2 5\n3 3 6\n";
+  }
+  assert(read_graph<int>(path, edge_format::matrix_market, g));
+  assert(g.order() == 3 && g.size() == 5);
+  assert(g(g(Vertex<DV>(1), Vertex<DV>(0))) == 4 && g(g(Vertex<DV>(0), Vertex<DV>(1))) == 4);
+  assert(g(g(Vertex<DV>(1), Vertex<DV>(2))) == 5);
+  assert(read_graph<int>(path, edge_format::matrix_market, h));
+  assert(h.order() == 3 && h.size() == 3);
+  {
+    ofstream out(path);
+    out << "%%MatrixMarket matrix coordinate real skew-symmetric\n"
+        << "2 2 1\n2 1 1.5\n";
+  }
+  directed_adjacency_vector<char, double> d;
+  assert(read_graph<double>(path, edge_format::matrix_market, d));
+  assert(d.size() == 2);
+  assert(d(d(Vertex<DV>(1), Vertex<DV>(0))) == 1.5 && d(d(Vertex<DV>(0), Vertex<DV>(1))) == -1.5);
+
+  // An empty file is a graph with no edges.
+  ofstream(path).close();
+  assert(r.read(path) && r.order() == 0 && r.edges().empty());
+  assert(read_graph(path, edge_format::snap, u));
+  assert(u.order() == 0 && u.size() == 0);
+  remove(path.c_str());
+}
+
+int main()
+{
+  check_snap();
+  check_matrix_market();
+  check_dimacs();
+  check_large();
+  check_numbers();
+  check_files();
+}
@@ -30,6 +30,19 @@ namespace origin
     inline auto
     edges(const G& g) -> decltype(g.edges()) { return g.edges(); }
 
+  // Returns one past the greatest vertex handle in g. Every vertex handle v
+  // in g satisfies v < vertex_bound(g), so the bound can be used to size
+  // arrays indexed by vertex handles. For graphs that reuse the handles of
+  // removed vertices, the bound may be greater than the order of g.
+  template<typename G>
+    inline std::size_t
+    vertex_bound(const G& g) { return g.vertex_bound(); }
+
+  // Returns one past the greatest edge handle in g.
+  template<typename G>
+    inline std::size_t
+    edge_bound(const G& g) { return g.edge_bound(); }
+
   // Returns the source vertex of an edge in g.
   template<typename G>
     inline Vertex<G>
@@ -11,6 +11,8 @@
 #include <cassert>
 #include <array>
 #include <iostream>
+#include <random>
+#include <tuple>
 #include <vector>
 
 #include <origin/graph/graph.hpp>
@@ -55,6 +57,42 @@ namespace testing
       return g;
     }
 
+  // Add the edge described by a (source, target) or (source, target, value)
+  // tuple to g.
+  template<typename G, typename U, typename V>
+    void add_tuple_edge(G& g, const tuple<U, V>& e)
+    {
+      g.add_edge(Vertex<G>(get<0>(e)), Vertex<G>(get<1>(e)));
+    }
+
+  template<typename G, typename U, typename V, typename W>
+    void add_tuple_edge(G& g, const tuple<U, V, W>& e)
+    {
+      g.add_edge(Vertex<G>(get<0>(e)), Vertex<G>(get<1>(e)), get<2>(e));
+    }
+
+  // Construct an n-vertex graph incrementally from a list of edge tuples.
+  template<typename G, typename T>
+    G build_graph(int n, const vector<T>& es)
+    {
+      G g = build_n_graph<G>(n);
+      for (auto& e : es)
+        add_tuple_edge(g, e);
+      return g;
+    }
+
+  // Construct an n-vertex graph with m random edges, whose values are their
+  // insertion order. The edges are the same for every graph type.
+  template<typename G>
+    G build_random_graph(int n, int m)
+    {
+      minstd_rand gen;
+      G g = build_n_graph<G>(n);
+      for (int i = 0; i < m; ++i)
+        g.add_edge(Vertex<G>(gen() % n), Vertex<G>(gen() % n), i);
+      return g;
+    }
+
   // Construct an n-vertex reflexive clique. Note that the resulting edges are
   // numbered 0..(n * (n + 1))/2.
   template<typename G>
@@ -22,60 +22,89 @@ namespace origin
   // (size_t) values, and have the special property that unsigned -1 indicates
   // an invalid object.
   //
+  // The index type I determines how handles are stored. A narrower index
+  // type, such as std::uint32_t, halves the size of the handles stored in
+  // graph data structures, but limits the number of objects to the greatest
+  // value of I. The invalid index is I(-1), which converts to npos, so the
+  // interface is the same for every index type.
+  //
+  // The comparison operators are friends of the class so that they are
+  // found for any handle type, and so that an integer operand is implicitly
+  // converted to a handle.
+  //
   // TODO: Disable arithmetic operations?
-  class handle
-  {
-  public:
-    static constexpr std::size_t npos = -1;
-
-    handle(std::size_t n = npos);
-
-    // Boolean
-    explicit operator bool() const;
-
-    // Integral
-    operator std::size_t() const { return value; }
-    
-    // Hashable
-    std::size_t hash() const;
-    
-    std::size_t value;
-  };
-  
-  inline
-  handle::handle(std::size_t n) : value(n) { }
-
-  inline 
-  handle::operator bool() const { return value != npos; }
-  
-  inline std::size_t 
-  handle::hash() const { return std::hash<std::size_t>{}(value); }
+  template<typename I = std::size_t>
+    class basic_handle
+    {
+    public:
+      using index_type = I;
 
-  // Equality
-  inline bool 
-  operator==(handle a, handle b) { return a.value == b.value; }
-  
-  inline bool 
-  operator!=(handle a, handle b) { return !(a == b); }
+      static constexpr std::size_t npos = -1;
 
-  // Ordering
-  inline bool 
-  operator<(handle a, handle b)
-  { 
-    if (!a)
-      return bool(b);
-    else 
-      return b ? a.value < b.value : false; 
-  }
-    
-  inline bool 
-  operator>(handle a, handle b) { return b < a; }
-  
-  inline bool 
-  operator<=(handle a, handle b) { return !(b < a); }
-  
-  inline bool 
-  operator>=(handle a, handle b) { return !(a < b); }
+      basic_handle(std::size_t n = npos);
+
+      // Boolean
+      explicit operator bool() const;
+
+      // Integral
+      operator std::size_t() const;
+
+      // Hashable
+      std::size_t hash() const;
+
+      // Equality
+      friend bool
+      operator==(basic_handle a, basic_handle b) { return a.value == b.value; }
+
+      friend bool
+      operator!=(basic_handle a, basic_handle b) { return !(a == b); }
+
+      // Ordering
+      friend bool
+      operator<(basic_handle a, basic_handle b)
+      {
+        if (!a)
+          return bool(b);
+        else
+          return b ? a.value < b.value : false;
+      }
+
+      friend bool
+      operator>(basic_handle a, basic_handle b) { return b < a; }
+
+      friend bool
+      operator<=(basic_handle a, basic_handle b) { return !(b < a); }
+
+      friend bool
+      operator>=(basic_handle a, basic_handle b) { return !(a < b); }
+
+      I value;
+    };
+
+  template<typename I>
+    constexpr std::size_t basic_handle<I>::npos;
+
+  template<typename I>
+    inline
+    basic_handle<I>::basic_handle(std::size_t n) : value(n) { }
+
+  template<typename I>
+    inline
+    basic_handle<I>::operator bool() const { return value != I(-1); }
+
+  template<typename I>
+    inline
+    basic_handle<I>::operator std::size_t() const
+    {
+      return value == I(-1) ? npos : std::size_t(value);
+    }
+
+  template<typename I>
+    inline std::size_t
+    basic_handle<I>::hash() const { return std::hash<I>{}(value); }
+
+  // The default handle type.
+  using handle = basic_handle<>;
 
 
   // ------------------------------------------------------------------------ //
@@ -83,10 +112,13 @@ namespace origin
   //
   // A vertex handle is a handle specifically for graph vertices. It is
   // the same as a normal handle in every way except its type.
-  struct vertex_handle : handle
-  {
-    using handle::handle;
-  };
+  template<typename I = std::size_t>
+    struct basic_vertex_handle : basic_handle<I>
+    {
+      using basic_handle<I>::basic_handle;
+    };
+
+  using vertex_handle = basic_vertex_handle<>;
 
 
   // ------------------------------------------------------------------------ //
@@ -97,10 +129,13 @@ namespace origin
   // data structures. More frequently, edge handles are source/target pairs
   // or source/target/edge triples. See simple_edge_handle and multi_edge_handle
   // for details.
-  struct edge_handle : handle
-  {
-    using handle::handle;
-  };
+  template<typename I = std::size_t>
+    struct basic_edge_handle : basic_handle<I>
+    {
+      using basic_handle<I>::basic_handle;
+    };
+
+  using edge_handle = basic_edge_handle<>;
 
 
   // ------------------------------------------------------------------------ //
@@ -118,34 +153,35 @@ namespace origin
   // A multi-edge handle is a triple, describing source and target handles,
   // along with an edge descriptor. The source and target handles are usual
   // vertex handles (i.e., indexes), but the edge component may vary based on
-  // the graph implementation. It is most often a pointer or index.
-  //
-  template<typename E>
+  // the graph implementation. It is most often a pointer or index. The type
+  // of the vertex handles is V.
+  template<typename E, typename V = vertex_handle>
     struct multi_edge_handle
     {
       using handle_type = E;
+      using vertex_type = V;
 
       multi_edge_handle()
-        : value(vertex_handle::npos, vertex_handle::npos, E{})
+        : value(V::npos, V::npos, E{})
       { }
 
-      multi_edge_handle(vertex_handle s, vertex_handle t, E e)
+      multi_edge_handle(V s, V t, E e)
         : value(s, t, e)
       { }
 
-      vertex_handle source() const { return std::get<0>(value); }
-      vertex_handle target() const { return std::get<1>(value); }
+      V source() const { return std::get<0>(value); }
+      V target() const { return std::get<1>(value); }
       handle_type edge() const { return std::get<2>(value); }
 
       // Hashable
       std::size_t hash() const;
 
-      std::tuple<vertex_handle, vertex_handle, E> value;
+      std::tuple<V, V, E> value;
     };
 
-  template<typename E>
+  template<typename E, typename V>
     inline std::size_t
-    multi_edge_handle<E>::hash() const
+    multi_edge_handle<E, V>::hash() const
     {
       std::size_t seed = std::get<0>(value).hash();
       seed ^= std::get<1>(value).hash() + 0x9e3779b9 + (seed << 6) + (seed >> 2);
@@ -154,45 +190,45 @@ namespace origin
     }
 
   // Equality
-  template<typename E>
+  template<typename E, typename V>
     inline bool
-    operator==(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator==(const multi_edge_handle<E, V>& a, const multi_edge_handle<E, V>& b)
     {
       return a.value == b.value;
     }
 
-  template<typename E>
+  template<typename E, typename V>
     inline bool
-    operator!=(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator!=(const multi_edge_handle<E, V>& a, const multi_edge_handle<E, V>& b)
     {
       return !(a == b);
     }
 
   // Ordering
-  template<typename E>
+  template<typename E, typename V>
     inline bool
-    operator<(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator<(const multi_edge_handle<E, V>& a, const multi_edge_handle<E, V>& b)
     {
       return a.value < b.value;
     }
 
-  template<typename E>
+  template<typename E, typename V>
     inline bool
-    operator>(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator>(const multi_edge_handle<E, V>& a, const multi_edge_handle<E, V>& b)
     {
       return b < a;
     }
 
-  template<typename E>
+  template<typename E, typename V>
     inline bool
-    operator<=(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator<=(const multi_edge_handle<E, V>& a, const multi_edge_handle<E, V>& b)
     {
       return !(b < a);
     }
 
-  template<typename E>
+  template<typename E, typename V>
     inline bool
-    operator>=(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator>=(const multi_edge_handle<E, V>& a, const multi_edge_handle<E, V>& b)
     {
       return !(a < b);
     }
@@ -204,18 +240,18 @@ namespace origin
 // Natively support the standard hashing protocol for vertex handles.
 namespace std 
 {
-  template<>
-    struct hash<origin::vertex_handle>
+  template<typename I>
+    struct hash<origin::basic_vertex_handle<I>>
     {
       std::size_t 
-      operator()(origin::vertex_handle x) const { return x.hash(); }
+      operator()(origin::basic_vertex_handle<I> x) const { return x.hash(); }
     };
 
-  template<typename E>
-    struct hash<origin::multi_edge_handle<E>>
+  template<typename E, typename V>
+    struct hash<origin::multi_edge_handle<E, V>>
     {
       std::size_t 
-      operator()(const origin::multi_edge_handle<E>& h) { return h.hash(); }
+      operator()(const origin::multi_edge_handle<E, V>& h) { return h.hash(); }
     };
 
 } // namespace std
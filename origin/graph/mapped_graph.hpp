@@ -0,0 +1,593 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_MAPPED_GRAPH_HPP
+#define ORIGIN_GRAPH_MAPPED_GRAPH_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <origin/type/empty.hpp>
+#include <origin/sequence/range.hpp>
+
+#include <origin/graph/handle.hpp>
+#include <origin/graph/graph.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.mapped]
+  //                              Mapped Graphs
+  //
+  // A graph file stores an adjacency vector in a binary format that can be
+  // mapped into memory and used in place, without parsing or copying. A
+  // mapped graph is a read-only view of such a file. Its vertex and edge
+  // handles, incidence lists, and values are those of the saved graph, so
+  // arrays indexed by the handles of the saved graph remain valid.
+  //
+  // The file begins with a header recording the format version, whether the
+  // graph is directed, the sizes of the index, vertex value, and edge value
+  // types, the byte order, the order and size of the graph, and the offset
+  // of each section. The sections are arrays, each aligned to 64 bytes:
+  //
+  //    vertex values     order x V
+  //    edge values       size x E
+  //    edge sources      size x I
+  //    edge targets      size x I
+  //    offsets           (order + 1) x uint64, delimiting the incidence lists
+  //    incidence lists   edge handles, as I
+  //    in offsets        (order + 1) x uint64, directed graphs only
+  //    in lists          edge handles, as I, directed graphs only
+  //
+  // The incidence lists hold the out edges of each vertex in a directed
+  // graph, and the incident edges in an undirected graph, in the order of
+  // the saved graph. Values are copied bytewise, so V and E must be
+  // trivially copyable, and a file can only be mapped on a machine with the
+  // same byte order. A file is opened only if its header matches the
+  // parameters of the mapped graph type.
+
+  namespace mapped_graph_impl
+  {
+    constexpr char magic[8] = {'O', 'R', 'I', 'G', 'I', 'N', 'G', 'R'};
+    constexpr std::uint32_t version = 1;
+    constexpr std::uint32_t byte_order = 0x01020304;
+    constexpr std::size_t alignment = 64;
+
+    enum section_id
+    {
+      vertex_values, edge_values, edge_sources, edge_targets,
+      offsets, lists, in_offsets, in_lists, sections
+    };
+
+    // The file header.
+    struct header
+    {
+      char          magic[8];
+      std::uint32_t version;
+      std::uint32_t directed;
+      std::uint32_t index_size;
+      std::uint32_t vertex_size;
+      std::uint32_t edge_size;
+      std::uint32_t byte_order;
+      std::uint64_t order;
+      std::uint64_t size;
+      std::uint64_t file_size;
+      std::uint64_t section[sections];
+    };
+
+    // Returns n rounded up to the alignment of a section.
+    inline std::size_t
+    align(std::size_t n) { return (n + alignment - 1) & ~(alignment - 1); }
+
+    // ---------------------------------------------------------------------- //
+    //                               File Writer
+    //
+    // A buffered binary writer that records its position in the file.
+    class file_writer
+    {
+    public:
+      explicit file_writer(const std::string& path)
+        : out_(path, std::ios::binary | std::ios::trunc), pos_(0)
+      { }
+
+      std::size_t position() const { return pos_; }
+
+      // Write the bytes of x.
+      template<typename T>
+        void put(const T& x)
+        {
+          const char* p = reinterpret_cast<const char*>(&x);
+          buf_.insert(buf_.end(), p, p + sizeof(T));
+          pos_ += sizeof(T);
+          if (buf_.size() >= (1 << 20))
+            flush();
+        }
+
+      // Pad the file to the alignment of a section, and return the new
+      // position.
+      std::size_t pad()
+      {
+        while (pos_ != align(pos_))
+          put('\0');
+        return pos_;
+      }
+
+      void flush()
+      {
+        out_.write(buf_.data(), buf_.size());
+        buf_.clear();
+      }
+
+      // Rewrite the header at the start of the file.
+      bool finish(const header& h)
+      {
+        flush();
+        out_.seekp(0);
+        out_.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out_.close();
+        return !out_.fail();
+      }
+
+      explicit operator bool() const { return bool(out_); }
+
+    private:
+      std::ofstream out_;
+      std::vector<char> buf_;
+      std::size_t pos_;
+    };
+
+    // Write the offsets of the incidence lists given by the function f to
+    // the section s, and the lists to the following section.
+    template<typename I, typename G, typename F>
+      void
+      put_lists(file_writer& w, const G& g, header& h, section_id s, F f)
+      {
+        h.section[s] = w.pad();
+        std::uint64_t n = 0;
+        w.put(n);
+        for (auto v : g.vertices()) {
+          for (auto e : f(v)) {
+            (void)e;
+            ++n;
+          }
+          w.put(n);
+        }
+        h.section[s + 1] = w.pad();
+        for (auto v : g.vertices())
+          for (auto e : f(v))
+            w.put(I(e));
+      }
+
+    template<typename G>
+      inline std::uint32_t
+      is_directed(Requires<Directed_graph<G>()>* = nullptr) { return 1; }
+
+    template<typename G>
+      inline std::uint32_t
+      is_directed(Requires<Undirected_graph<G>()>* = nullptr) { return 0; }
+
+    template<typename I, typename G>
+      void
+      put_incidence(file_writer& w, const G& g, header& h,
+                    Requires<Directed_graph<G>()>* = nullptr)
+      {
+        put_lists<I>(w, g, h, offsets, [&g](Vertex<G> v) { return g.out_edges(v); });
+        put_lists<I>(w, g, h, in_offsets, [&g](Vertex<G> v) { return g.in_edges(v); });
+      }
+
+    template<typename I, typename G>
+      void
+      put_incidence(file_writer& w, const G& g, header& h,
+                    Requires<Undirected_graph<G>()>* = nullptr)
+      {
+        put_lists<I>(w, g, h, offsets, [&g](Vertex<G> v) { return g.edges(v); });
+      }
+
+    // ---------------------------------------------------------------------- //
+    //                               Mapped File
+    //
+    // A read-only memory mapping of a file. An empty file cannot be mapped,
+    // and is opened as the empty range, with a null data pointer.
+    class mapped_file
+    {
+    public:
+      mapped_file() : data_(nullptr), size_(0) { }
+      mapped_file(const mapped_file&) = delete;
+      mapped_file& operator=(const mapped_file&) = delete;
+      ~mapped_file() { close(); }
+
+      bool open(const std::string& path);
+      void close();
+
+      const char* data() const { return data_; }
+      std::size_t size() const { return size_; }
+
+    private:
+      const char* data_;
+      std::size_t size_;
+    };
+
+    inline bool
+    mapped_file::open(const std::string& path)
+    {
+      close();
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0)
+        return false;
+      struct stat st;
+      if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+      }
+      if (st.st_size == 0) {
+        ::close(fd);
+        return true;
+      }
+      void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (p == MAP_FAILED)
+        return false;
+      data_ = static_cast<const char*>(p);
+      size_ = st.st_size;
+      return true;
+    }
+
+    inline void
+    mapped_file::close()
+    {
+      if (data_)
+        ::munmap(const_cast<char*>(data_), size_);
+      data_ = nullptr;
+      size_ = 0;
+    }
+
+    // ---------------------------------------------------------------------- //
+    //                               Mapped Base
+    //
+    // The parts of a mapped graph common to directed and undirected graphs:
+    // the file, the edge arrays, and the first incidence index.
+    template<typename V, typename E, typename I, bool Directed>
+      class mapped_base
+      {
+        static_assert(std::is_trivially_copyable<V>::value, "");
+        static_assert(std::is_trivially_copyable<E>::value, "");
+
+        using vertex_iter =
+          adjacency_vector_impl::handle_counter<std::size_t, basic_vertex_handle<I>>;
+        using edge_iter =
+          adjacency_vector_impl::handle_counter<std::size_t, basic_edge_handle<I>>;
+      public:
+        using vertex = basic_vertex_handle<I>;
+        using vertex_range = bounded_range<vertex_iter>;
+
+        using edge = basic_edge_handle<I>;
+        using edge_range = bounded_range<edge_iter>;
+
+        using incidence_range = bounded_range<const edge*>;
+
+        mapped_base() { close(); }
+
+        // Map the graph file at path. Returns false if the file cannot be
+        // mapped, or if its header does not match the type of the graph.
+        bool open(const std::string& path);
+        void close();
+
+        bool is_open() const { return file_.data() != nullptr; }
+
+        // Observers
+        bool        null() const  { return order_ == 0; }
+        std::size_t order() const { return order_; }
+
+        bool        empty() const { return size_ == 0; }
+        std::size_t size() const  { return size_; }
+
+        // Handle bounds
+        std::size_t vertex_bound() const { return order_; }
+        std::size_t edge_bound() const   { return size_; }
+
+        // Edge observers
+        vertex source(edge e) const { return sources_[e]; }
+        vertex target(edge e) const { return targets_[e]; }
+
+        // Data access
+        const V& operator()(vertex v) const { return verts_[v]; }
+        const E& operator()(edge e) const   { return values_[e]; }
+
+        // Iterators
+        vertex_range vertices() const { return {vertex_iter(0), vertex_iter(order_)}; }
+        edge_range   edges() const    { return {edge_iter(0), edge_iter(size_)}; }
+
+      protected:
+        incidence_range incidence(const std::uint64_t* off, const edge* list,
+                                  vertex v) const
+        {
+          return {list + off[v], list + off[v + 1]};
+        }
+
+        template<typename T>
+          const T* section_data(std::size_t s) const
+          {
+            return reinterpret_cast<const T*>(file_.data() + file_header().section[s]);
+          }
+
+        const header& file_header() const
+        {
+          return *reinterpret_cast<const header*>(file_.data());
+        }
+
+        bool check() const;
+
+        mapped_file          file_;
+        std::size_t          order_;
+        std::size_t          size_;
+        const V*             verts_;
+        const E*             values_;
+        const I*             sources_;
+        const I*             targets_;
+        const std::uint64_t* offsets_;
+        const edge*          lists_;
+        const std::uint64_t* in_offsets_;
+        const edge*          in_lists_;
+      };
+
+    template<typename V, typename E, typename I, bool Directed>
+      bool
+      mapped_base<V, E, I, Directed>::open(const std::string& path)
+      {
+        close();
+        if (!file_.open(path))
+          return false;
+        if (!check()) {
+          close();
+          return false;
+        }
+        const header& h = file_header();
+        order_ = h.order;
+        size_ = h.size;
+        verts_ = section_data<V>(vertex_values);
+        values_ = section_data<E>(edge_values);
+        sources_ = section_data<I>(edge_sources);
+        targets_ = section_data<I>(edge_targets);
+        offsets_ = section_data<std::uint64_t>(offsets);
+        lists_ = section_data<edge>(lists);
+        if (Directed) {
+          in_offsets_ = section_data<std::uint64_t>(in_offsets);
+          in_lists_ = section_data<edge>(in_lists);
+        }
+        return true;
+      }
+
+    template<typename V, typename E, typename I, bool Directed>
+      void
+      mapped_base<V, E, I, Directed>::close()
+      {
+        file_.close();
+        order_ = size_ = 0;
+        verts_ = nullptr;
+        values_ = nullptr;
+        sources_ = targets_ = nullptr;
+        offsets_ = in_offsets_ = nullptr;
+        lists_ = in_lists_ = nullptr;
+      }
+
+    // Returns true if the header matches the graph type, and every section
+    // lies within the file.
+    template<typename V, typename E, typename I, bool Directed>
+      bool
+      mapped_base<V, E, I, Directed>::check() const
+      {
+        if (file_.size() < sizeof(header))
+          return false;
+        const header& h = file_header();
+        if (std::memcmp(h.magic, magic, sizeof(magic)) != 0
+            || h.version != version
+            || h.byte_order != byte_order
+            || h.directed != Directed
+            || h.index_size != sizeof(I)
+            || h.vertex_size != sizeof(V)
+            || h.edge_size != sizeof(E)
+            || h.file_size != file_.size())
+          return false;
+
+        auto fits = [&](section_id s, std::uint64_t n) {
+          return h.section[s] % alignment == 0 && h.section[s] <= h.file_size
+              && n <= (h.file_size - h.section[s]);
+        };
+        std::uint64_t n = h.order;
+        std::uint64_t m = h.size;
+        if (!fits(vertex_values, n * sizeof(V)) || !fits(edge_values, m * sizeof(E))
+            || !fits(edge_sources, m * sizeof(I)) || !fits(edge_targets, m * sizeof(I))
+            || !fits(offsets, (n + 1) * 8))
+          return false;
+        const std::uint64_t* off = section_data<std::uint64_t>(offsets);
+        if (!fits(lists, off[n] * sizeof(I)))
+          return false;
+        if (Directed) {
+          if (!fits(in_offsets, (n + 1) * 8))
+            return false;
+          const std::uint64_t* in = section_data<std::uint64_t>(in_offsets);
+          if (!fits(in_lists, in[n] * sizeof(I)))
+            return false;
+        }
+        return true;
+      }
+
+  } // namespace mapped_graph_impl
+
+
+  // Save the graph g to the file at path. The vertex and edge handles of g
+  // must be dense, as they are in adjacency vectors. Returns false if the
+  // file cannot be written.
+  template<typename G>
+    bool
+    save_graph(const G& g, const std::string& path)
+    {
+      using namespace mapped_graph_impl;
+      using I = typename Vertex<G>::index_type;
+      using V = Decay<decltype(g(Vertex<G>()))>;
+      using E = Decay<decltype(g(Edge<G>()))>;
+      static_assert(std::is_trivially_copyable<V>::value, "");
+      static_assert(std::is_trivially_copyable<E>::value, "");
+      assert(vertex_bound(g) == g.order() && edge_bound(g) == g.size());
+
+      file_writer w(path);
+      if (!w)
+        return false;
+
+      header h;
+      std::memset(&h, 0, sizeof(h));
+      std::memcpy(h.magic, magic, sizeof(magic));
+      h.version = version;
+      h.directed = is_directed<G>();
+      h.index_size = sizeof(I);
+      h.vertex_size = sizeof(V);
+      h.edge_size = sizeof(E);
+      h.byte_order = byte_order;
+      h.order = g.order();
+      h.size = g.size();
+      w.put(h);
+
+      h.section[vertex_values] = w.pad();
+      for (auto v : g.vertices())
+        w.put(g(v));
+      h.section[edge_values] = w.pad();
+      for (std::size_t e = 0; e < g.size(); ++e)
+        w.put(g(Edge<G>(e)));
+      h.section[edge_sources] = w.pad();
+      for (std::size_t e = 0; e < g.size(); ++e)
+        w.put(I(g.source(Edge<G>(e))));
+      h.section[edge_targets] = w.pad();
+      for (std::size_t e = 0; e < g.size(); ++e)
+        w.put(I(g.target(Edge<G>(e))));
+      put_incidence<I>(w, g, h);
+
+      h.file_size = w.pad();
+      return w.finish(h);
+    }
+
+
+  // A read-only directed graph mapped from a graph file.
+  template<typename V = empty_t, typename E = empty_t, typename I = std::size_t>
+    class mapped_directed_graph
+      : public mapped_graph_impl::mapped_base<V, E, I, true>
+    {
+      using base_type = mapped_graph_impl::mapped_base<V, E, I, true>;
+    public:
+      using typename base_type::vertex;
+      using typename base_type::edge;
+      using typename base_type::incidence_range;
+
+      mapped_directed_graph() = default;
+
+      explicit mapped_directed_graph(const std::string& path) { this->open(path); }
+
+      // Vertex observers
+      std::size_t out_degree(vertex v) const
+      {
+        return this->offsets_[v + 1] - this->offsets_[v];
+      }
+
+      std::size_t in_degree(vertex v) const
+      {
+        return this->in_offsets_[v + 1] - this->in_offsets_[v];
+      }
+
+      std::size_t degree(vertex v) const { return out_degree(v) + in_degree(v); }
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const;
+
+      using base_type::operator();
+
+      // Iterators
+      incidence_range out_edges(vertex v) const
+      {
+        return this->incidence(this->offsets_, this->lists_, v);
+      }
+
+      incidence_range in_edges(vertex v) const
+      {
+        return this->incidence(this->in_offsets_, this->in_lists_, v);
+      }
+    };
+
+  // Returns the first out edge of u whose target is v, or an invalid handle
+  // if there is no such edge.
+  template<typename V, typename E, typename I>
+    auto
+    mapped_directed_graph<V, E, I>::operator()(vertex u, vertex v) const -> edge
+    {
+      for (edge e : out_edges(u))
+        if (this->target(e) == v)
+          return e;
+      return edge();
+    }
+
+
+  // A read-only undirected graph mapped from a graph file.
+  template<typename V = empty_t, typename E = empty_t, typename I = std::size_t>
+    class mapped_undirected_graph
+      : public mapped_graph_impl::mapped_base<V, E, I, false>
+    {
+      using base_type = mapped_graph_impl::mapped_base<V, E, I, false>;
+    public:
+      using typename base_type::vertex;
+      using typename base_type::edge;
+      using typename base_type::incidence_range;
+
+      mapped_undirected_graph() = default;
+
+      explicit mapped_undirected_graph(const std::string& path) { this->open(path); }
+
+      // Vertex observers
+      std::size_t degree(vertex v) const
+      {
+        return this->offsets_[v + 1] - this->offsets_[v];
+      }
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const;
+
+      using base_type::operator();
+
+      // Iterators
+      incidence_range edges(vertex v) const
+      {
+        return this->incidence(this->offsets_, this->lists_, v);
+      }
+
+      using base_type::edges;
+    };
+
+  // Returns the first edge incident to u whose opposite endpoint is v, or an
+  // invalid handle if there is no such edge.
+  template<typename V, typename E, typename I>
+    auto
+    mapped_undirected_graph<V, E, I>::operator()(vertex u, vertex v) const -> edge
+    {
+      for (edge e : edges(u))
+        if (opposite(*this, e, u) == v)
+          return e;
+      return edge();
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,162 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/breadth_first.hpp>
+#include <origin/graph/mapped_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+const string path = "mapped_graph.test.graph";
+
+// A trivially copyable edge record.
+struct road
+{
+  road() = default;
+  road(int n) : length(n), lanes(n % 4) { }
+
+  int length;
+  char lanes;
+};
+
+// Returns the handles of an incidence range.
+template<typename R>
+  vector<size_t>
+  handles(const R& r)
+  {
+    vector<size_t> x;
+    for (auto e : r)
+      x.push_back(e);
+    return x;
+  }
+
+// Check that the mapped graph m has the same vertices, edges, values and
+// incidence lists as g.
+template<typename G, typename M>
+  void
+  check_same(const G& g, const M& m, Requires<Directed_graph<G>()>* = nullptr)
+  {
+    for (auto v : g.vertices()) {
+      assert(handles(g.out_edges(v)) == handles(m.out_edges(v)));
+      assert(handles(g.in_edges(v)) == handles(m.in_edges(v)));
+      assert(g.out_degree(v) == m.out_degree(v));
+      assert(g.in_degree(v) == m.in_degree(v));
+    }
+  }
+
+template<typename G, typename M>
+  void
+  check_same(const G& g, const M& m, Requires<Undirected_graph<G>()>* = nullptr)
+  {
+    for (auto v : g.vertices()) {
+      assert(handles(g.edges(v)) == handles(m.edges(v)));
+      assert(g.degree(v) == m.degree(v));
+    }
+  }
+
+template<typename G, typename M>
+  void
+  check_mapped(const G& g)
+  {
+    cout << "*** mapped graph (" << typestr<G>() << ") ***\n";
+    assert(save_graph(g, path));
+    M m(path);
+    assert(m.is_open());
+    assert(m.order() == g.order() && m.size() == g.size());
+    for (auto v : m.vertices())
+      assert(m(v) == g(Vertex<G>(v)));
+    for (auto e : m.edges()) {
+      Edge<G> x = e;
+      assert(m.source(e) == g.source(x) && m.target(e) == g.target(x));
+      assert(m(e).length == g(x).length && m(e).lanes == g(x).lanes);
+    }
+    check_same(g, m);
+    for (auto e : g.edges())
+      assert(bool(m(m.source(e), m.target(e))));
+
+    // Algorithms run on the mapped graph.
+    vector<size_t> d1(g.order()), d2(g.order());
+    breadth_first_search(g, Vertex<G>(0), d1.data(), nullptr, 2);
+    breadth_first_search(m, Vertex<M>(0), d2.data(), nullptr, 2);
+    assert(d1 == d2);
+
+    m.close();
+    assert(!m.is_open() && m.null());
+  }
+
+// Check that files are opened only by mapped graphs of the matching type.
+void
+check_mismatch()
+{
+  cout << "*** mapped graph mismatch ***\n";
+  using G = directed_adjacency_vector<int, road>;
+  G g(3, vector<tuple<size_t, size_t, int>> {make_tuple(0, 1, 5)});
+  assert(save_graph(g, path));
+
+  assert((mapped_directed_graph<int, road>(path).is_open()));
+  assert(!(mapped_directed_graph<long, road>(path).is_open()));
+  assert(!(mapped_directed_graph<int, int>(path).is_open()));
+  assert(!(mapped_directed_graph<int, road, uint32_t>(path).is_open()));
+  assert(!(mapped_undirected_graph<int, road>(path).is_open()));
+  assert(!(mapped_directed_graph<int, road>("no such file").is_open()));
+
+  // A truncated file is rejected.
+  {
+    ifstream in(path, ios::binary);
+    string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(bytes.data(), bytes.size() - 64);
+  }
+  assert(!(mapped_directed_graph<int, road>(path).is_open()));
+}
+
+template<typename G>
+  G
+  random_graph(size_t n, size_t m)
+  {
+    minstd_rand gen;
+    vector<tuple<size_t, size_t, int>> es;
+    for (size_t i = 0; i < m; ++i)
+      es.emplace_back(gen() % n, gen() % n, gen() % 100);
+    G g(n, es);
+    for (auto v : g.vertices())
+      g(v) = gen();
+    return g;
+  }
+
+int main()
+{
+  check_mapped<directed_adjacency_vector<int, road>, mapped_directed_graph<int, road>>(
+    random_graph<directed_adjacency_vector<int, road>>(200, 1000));
+  check_mapped<undirected_adjacency_vector<int, road>, mapped_undirected_graph<int, road>>(
+    random_graph<undirected_adjacency_vector<int, road>>(200, 1000));
+
+  using N = narrow_adjacency_vector_traits;
+  check_mapped<directed_adjacency_vector<int, road, N>, mapped_directed_graph<int, road, uint32_t>>(
+    random_graph<directed_adjacency_vector<int, road, N>>(200, 1000));
+
+  // Sorted graphs keep their incidence order.
+  using S = sorted_adjacency_vector_traits;
+  check_mapped<undirected_adjacency_vector<int, road, S>, mapped_undirected_graph<int, road>>(
+    random_graph<undirected_adjacency_vector<int, road, S>>(50, 400));
+
+  check_mismatch();
+  remove(path.c_str());
+}
@@ -0,0 +1,231 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_NEIGHBORS_HPP
+#define ORIGIN_GRAPH_NEIGHBORS_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <iterator>
+
+#include <origin/graph/graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                         [graph.neighbors]
+  //                          Neighbor Intersection
+  //
+  // The neighbors of a vertex v are the targets of its out edges in a
+  // directed graph, and the opposite endpoints of its incident edges in an
+  // undirected graph. The common neighbors of u and v are the vertices that
+  // are neighbors of both.
+  //
+  // These operations require a sorted graph (see sort_adjacency()), whose
+  // incidence lists are ordered by neighbor, and whose incidence ranges are
+  // random access. The neighbor lists are intersected by merging them, or,
+  // when one list is much longer than the other, by galloping through the
+  // longer list. Each common neighbor is reported once, even when several
+  // edges lead to it.
+
+  namespace neighbors_impl
+  {
+    // The intersection gallops when one list is longer than the other by at
+    // least this factor.
+    constexpr std::size_t gallop_ratio = 16;
+
+    // Returns the range of edges leading to the neighbors of v.
+    template<typename G>
+      inline auto
+      neighbor_edges(const G& g, Vertex<G> v,
+                     Requires<Directed_graph<G>()>* = nullptr)
+        -> decltype(g.out_edges(v))
+      {
+        return g.out_edges(v);
+      }
+
+    template<typename G>
+      inline auto
+      neighbor_edges(const G& g, Vertex<G> v,
+                     Requires<Undirected_graph<G>()>* = nullptr)
+        -> decltype(g.edges(v))
+      {
+        return g.edges(v);
+      }
+
+    // Returns the neighbor of v reached through the edge e.
+    template<typename G>
+      inline Vertex<G>
+      neighbor(const G& g, Edge<G> e, Vertex<G>,
+               Requires<Directed_graph<G>()>* = nullptr)
+      {
+        return g.target(e);
+      }
+
+    template<typename G>
+      inline Vertex<G>
+      neighbor(const G& g, Edge<G> e, Vertex<G> v,
+               Requires<Undirected_graph<G>()>* = nullptr)
+      {
+        return opposite(g, e, v);
+      }
+
+    // Returns the range of edges leading to v from its predecessors.
+    template<typename G>
+      inline auto
+      reverse_edges(const G& g, Vertex<G> v,
+                    Requires<Directed_graph<G>()>* = nullptr)
+        -> decltype(g.in_edges(v))
+      {
+        return g.in_edges(v);
+      }
+
+    template<typename G>
+      inline auto
+      reverse_edges(const G& g, Vertex<G> v,
+                    Requires<Undirected_graph<G>()>* = nullptr)
+        -> decltype(g.edges(v))
+      {
+        return g.edges(v);
+      }
+
+    // Returns the predecessor of v from which the edge e leads.
+    template<typename G>
+      inline Vertex<G>
+      reverse_neighbor(const G& g, Edge<G> e, Vertex<G>,
+                       Requires<Directed_graph<G>()>* = nullptr)
+      {
+        return g.source(e);
+      }
+
+    template<typename G>
+      inline Vertex<G>
+      reverse_neighbor(const G& g, Edge<G> e, Vertex<G> v,
+                       Requires<Undirected_graph<G>()>* = nullptr)
+      {
+        return opposite(g, e, v);
+      }
+
+    // Returns the first iterator in [first, last) whose neighbor is not less
+    // than x. The search probes positions at doubling distances from first
+    // before finishing with a binary search, so it takes time logarithmic in
+    // the distance to the result rather than the length of the range.
+    template<typename G, typename I>
+      I
+      gallop(const G& g, Vertex<G> v, I first, I last, Vertex<G> x)
+      {
+        auto less = [&g, v](Edge<G> e, Vertex<G> y) {
+          return neighbor(g, e, v) < y;
+        };
+        if (first == last || !less(*first, x))
+          return first;
+        std::ptrdiff_t step = 1;
+        while (step < last - first && less(first[step], x)) {
+          first += step;
+          step *= 2;
+        }
+        I limit = step < last - first ? first + step : last;
+        return std::lower_bound(first + 1, limit, x, less);
+      }
+
+    // Advance i past the edges in [i, last) that lead to x.
+    template<typename G, typename I>
+      inline I
+      skip(const G& g, Vertex<G> v, I i, I last, Vertex<G> x)
+      {
+        while (i != last && neighbor(g, *i, v) == x)
+          ++i;
+        return i;
+      }
+
+    // Write the common neighbors of u and v to out, given that u has no more
+    // neighbor edges than v.
+    template<typename G, typename Out>
+      Out
+      intersect(const G& g, Vertex<G> u, Vertex<G> v, Out out)
+      {
+        auto r1 = neighbor_edges(g, u);
+        auto r2 = neighbor_edges(g, v);
+        auto i = r1.begin();
+        auto j = r2.begin();
+        auto n1 = r1.end() - i;
+        auto n2 = r2.end() - j;
+
+        if (std::size_t(n2) >= gallop_ratio * std::size_t(n1)) {
+          while (i != r1.end()) {
+            Vertex<G> x = neighbor(g, *i, u);
+            j = gallop(g, v, j, r2.end(), x);
+            if (j == r2.end())
+              break;
+            if (neighbor(g, *j, v) == x)
+              *out++ = x;
+            i = skip(g, u, i, r1.end(), x);
+          }
+          return out;
+        }
+
+        while (i != r1.end() && j != r2.end()) {
+          Vertex<G> x = neighbor(g, *i, u);
+          Vertex<G> y = neighbor(g, *j, v);
+          if (x < y) {
+            ++i;
+          } else if (y < x) {
+            ++j;
+          } else {
+            *out++ = x;
+            i = skip(g, u, i, r1.end(), x);
+            j = skip(g, v, j, r2.end(), x);
+          }
+        }
+        return out;
+      }
+
+    // An output iterator that counts the values assigned through it.
+    struct counter
+    {
+      template<typename T>
+        counter& operator=(const T&) { ++count; return *this; }
+
+      counter& operator*()     { return *this; }
+      counter& operator++()    { return *this; }
+      counter& operator++(int) { return *this; }
+
+      std::size_t count;
+    };
+
+  } // namespace neighbors_impl
+
+
+  // Write the common neighbors of u and v to out in increasing order, and
+  // return the final output iterator. The graph must be sorted.
+  template<typename G, typename Out>
+    Out
+    common_neighbors(const G& g, Vertex<G> u, Vertex<G> v, Out out)
+    {
+      using namespace neighbors_impl;
+      assert(g.sorted());
+      auto r1 = neighbor_edges(g, u);
+      auto r2 = neighbor_edges(g, v);
+      if (r1.end() - r1.begin() <= r2.end() - r2.begin())
+        return intersect(g, u, v, out);
+      else
+        return intersect(g, v, u, out);
+    }
+
+  // Returns the number of common neighbors of u and v. The graph must be
+  // sorted.
+  template<typename G>
+    std::size_t
+    count_common_neighbors(const G& g, Vertex<G> u, Vertex<G> v)
+    {
+      return common_neighbors(g, u, v, neighbors_impl::counter{0}).count;
+    }
+
+} // namespace origin
+
+#endif
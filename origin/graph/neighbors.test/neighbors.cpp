@@ -0,0 +1,197 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/neighbors.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the neighbors of v, computed from its incidence list.
+template<typename G>
+  set<size_t>
+  neighbor_set(const G& g, Vertex<G> v, Requires<Directed_graph<G>()>* = nullptr)
+  {
+    set<size_t> r;
+    for (auto e : g.out_edges(v))
+      r.insert(g.target(e));
+    return r;
+  }
+
+template<typename G>
+  set<size_t>
+  neighbor_set(const G& g, Vertex<G> v, Requires<Undirected_graph<G>()>* = nullptr)
+  {
+    set<size_t> r;
+    for (auto e : g.edges(v))
+      r.insert(opposite(g, e, v));
+    return r;
+  }
+
+// Returns true if the neighbors of v appear in order in its incidence list.
+template<typename G>
+  bool
+  is_sorted_at(const G& g, Vertex<G> v, Requires<Directed_graph<G>()>* = nullptr)
+  {
+    vector<size_t> out, in;
+    for (auto e : g.out_edges(v))
+      out.push_back(g.target(e));
+    for (auto e : g.in_edges(v))
+      in.push_back(g.source(e));
+    return is_sorted(out.begin(), out.end()) && is_sorted(in.begin(), in.end());
+  }
+
+template<typename G>
+  bool
+  is_sorted_at(const G& g, Vertex<G> v, Requires<Undirected_graph<G>()>* = nullptr)
+  {
+    vector<size_t> r;
+    for (auto e : g.edges(v))
+      r.push_back(opposite(g, e, v));
+    return is_sorted(r.begin(), r.end());
+  }
+
+// Check the edge relation and neighbor intersection of a sorted graph
+// against the incidence lists.
+template<typename G>
+  void
+  check_sorted_graph(const G& g)
+  {
+    assert(g.sorted());
+    for (auto u : g.vertices()) {
+      assert(is_sorted_at(g, u));
+      set<size_t> nu = neighbor_set(g, u);
+      for (auto v : g.vertices()) {
+        Edge<G> e = g(u, v);
+        assert(bool(e) == (nu.count(v) != 0));
+        if (e)
+          assert(are_endpoints(g, e, u, v));
+
+        set<size_t> nv = neighbor_set(g, v);
+        vector<size_t> expect;
+        set_intersection(nu.begin(), nu.end(), nv.begin(), nv.end(),
+                         back_inserter(expect));
+        vector<size_t> common;
+        common_neighbors(g, u, v, back_inserter(common));
+        assert(common == expect);
+        assert(count_common_neighbors(g, u, v) == expect.size());
+      }
+    }
+  }
+
+// Add random edges to g. Vertex 0 is a hub whose degree is far greater
+// than that of the other vertices, so that intersections with it gallop.
+template<typename G, typename R>
+  void
+  add_random_edges(G& g, R& gen, int m)
+  {
+    for (int i = 0; i < m; ++i) {
+      Vertex<G> u = gen() % 3 == 0 ? 0 : gen() % 40;
+      Vertex<G> v = gen() % 40;
+      g.add_edge(u, v);
+    }
+  }
+
+// Check that sorted traits keep the incidence lists sorted as edges are
+// added and removed.
+template<typename G>
+  void
+  check_sorted_traits()
+  {
+    cout << "*** sorted traits (" << typestr<G>() << ") ***\n";
+    minstd_rand gen;
+    G g = build_n_graph<G>(40);
+    add_random_edges(g, gen, 600);
+    check_sorted_graph(g);
+
+    for (int i = 0; i < 200; ++i) {
+      g.remove_edge(Vertex<G>(gen() % 40), Vertex<G>(gen() % 40));
+      g.remove_edges(Vertex<G>(gen() % 40), Vertex<G>(gen() % 40));
+    }
+    g.remove_vertex(Vertex<G>(7));
+    g.add_vertex();
+    g.remove_edges(Vertex<G>(0));
+    add_random_edges(g, gen, 200);
+    check_sorted_graph(g);
+  }
+
+// Check that sort_adjacency() sorts a graph built in arbitrary order, and
+// that the graph tracks whether it remains sorted.
+template<typename G>
+  void
+  check_sort_adjacency()
+  {
+    cout << "*** sort adjacency (" << typestr<G>() << ") ***\n";
+    G g = build_n_graph<G>(40);
+    assert(g.sorted());
+    g.add_edge(Vertex<G>(1), Vertex<G>(2));
+    g.add_edge(Vertex<G>(1), Vertex<G>(3));
+    assert(g.sorted());
+    g.add_edge(Vertex<G>(1), Vertex<G>(1));
+    assert(!g.sorted());
+
+    minstd_rand gen;
+    add_random_edges(g, gen, 600);
+    g.sort_adjacency();
+    check_sorted_graph(g);
+  }
+
+// Check that bulk loading sorts the incidence lists of adjacency vectors.
+template<typename G>
+  void
+  check_sorted_assign()
+  {
+    cout << "*** sorted assign (" << typestr<G>() << ") ***\n";
+    minstd_rand gen;
+    vector<tuple<size_t, size_t>> es;
+    for (int i = 0; i < 600; ++i)
+      es.emplace_back(gen() % 3 == 0 ? 0 : gen() % 40, gen() % 40);
+    G g(40, es);
+    check_sorted_graph(g);
+  }
+
+int main()
+{
+  check_sorted_traits<directed_adjacency_list<char, int, sorted_adjacency_list_traits>>();
+  check_sorted_traits<undirected_adjacency_list<char, int, sorted_adjacency_list_traits>>();
+
+  check_sort_adjacency<directed_adjacency_list<char, int>>();
+  check_sort_adjacency<undirected_adjacency_list<char, int>>();
+  check_sort_adjacency<directed_adjacency_list<char, int, indexed_adjacency_list_traits>>();
+  check_sort_adjacency<undirected_adjacency_list<char, int, indexed_adjacency_list_traits>>();
+  check_sort_adjacency<directed_adjacency_vector<char>>();
+  check_sort_adjacency<undirected_adjacency_vector<char>>();
+
+  check_sorted_assign<directed_adjacency_vector<char, empty_t, sorted_adjacency_vector_traits>>();
+  check_sorted_assign<undirected_adjacency_vector<char, empty_t, sorted_adjacency_vector_traits>>();
+
+  // Positions remain valid after sorting.
+  using G = undirected_adjacency_list<char, int, indexed_adjacency_list_traits>;
+  G g = build_n_graph<G>(4);
+  for (int i = 0; i < 4; ++i)
+    for (int j = 3; j >= 0; --j)
+      g.add_edge(Vertex<G>(i), Vertex<G>(j));
+  g.sort_adjacency();
+  assert(g.sorted());
+  g.remove_edge(Vertex<G>(0), Vertex<G>(0));
+  assert(!g.sorted());
+  while (!g.empty())
+    g.remove_edge(*g.edges().begin());
+}
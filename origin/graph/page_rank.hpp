@@ -0,0 +1,390 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_PAGE_RANK_HPP
+#define ORIGIN_GRAPH_PAGE_RANK_HPP
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/neighbors.hpp>
+#include <origin/graph/parallel.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                         [graph.page_rank]
+  //                               PageRank
+  //
+  // The rank engine computes PageRank by power iteration. Each iteration
+  // pulls rank into every vertex from its predecessors: the new rank of v is
+  // the damped sum of rank[u] / out_degree(u) over the edges (u, v), plus
+  // the teleport mass. The rank of vertices without out edges is returned
+  // through teleportation. Iteration stops when the L1 norm of the change in
+  // rank falls below the tolerance, or after the maximum number of
+  // iterations.
+  //
+  // When the engine is created, it copies the sources of the in edges of
+  // each vertex into a single array, delimited by offsets, so that pulling
+  // rank reads the array sequentially rather than following incidence
+  // lists. Sources are stored as the graph's vertex handles. A compressed
+  // graph with an in edge index already stores such an array, which the
+  // engine reads in place. The graph may be any graph whose neighbors can
+  // be enumerated; for undirected graphs, each edge carries rank both ways.
+  //
+  // Personalized PageRank teleports to a seed vertex instead of to every
+  // vertex. The engine computes a batch of k personalized ranks at once,
+  // stored as rows of k values per vertex, so that each source read during
+  // a pull contributes to all k ranks with a contiguous, vectorizable loop.
+  //
+  // The vertices are processed by a team of threads, which claim chunks of
+  // vertices dynamically and synchronize at the end of each pass.
+
+  namespace page_rank_impl
+  {
+    // The number of vertices claimed by a thread at a time.
+    constexpr std::size_t chunk = 256;
+
+    // Returns the sum of x[s[i]] for i in [first, last). Independent partial
+    // sums let successive loads overlap. The sources are valid handles, so
+    // their indexes are read directly.
+    template<typename V>
+      inline double
+      gather_sum(const double* x, const V* s, std::size_t first, std::size_t last)
+      {
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        std::size_t i = first;
+        for (; i + 4 <= last; i += 4) {
+          s0 += x[s[i].value];
+          s1 += x[s[i + 1].value];
+          s2 += x[s[i + 2].value];
+          s3 += x[s[i + 3].value];
+        }
+        for (; i < last; ++i)
+          s0 += x[s[i].value];
+        return (s0 + s1) + (s2 + s3);
+      }
+
+    // Add the rows x[s[i]] of width k, for i in [first, last), to acc.
+    template<typename V>
+      inline void
+      gather_rows(const double* x, const V* s, std::size_t first,
+                  std::size_t last, std::size_t k, double* acc)
+      {
+        std::fill(acc, acc + k, 0.0);
+        for (std::size_t i = first; i < last; ++i) {
+          const double* row = x + std::size_t(s[i].value) * k;
+          for (std::size_t j = 0; j < k; ++j)
+            acc[j] += row[j];
+        }
+      }
+
+    // Use the in edge index of a compressed graph as the pull index, and
+    // its offsets for the out degrees. Returns false if g has no in edge
+    // index.
+    template<typename G>
+      inline auto
+      borrow_index(const G& g, std::vector<std::size_t>& offsets,
+                   std::vector<std::size_t>& degree, const Vertex<G>*& sources,
+                   int)
+        -> decltype(g.in_sources().data(), bool())
+      {
+        if (!g.has_in_edges())
+          return false;
+        offsets.assign(g.in_offsets().begin(), g.in_offsets().end());
+        for (std::size_t v = 0; v < degree.size(); ++v)
+          degree[v] = g.offsets()[v + 1] - g.offsets()[v];
+        sources = g.in_sources().data();
+        return true;
+      }
+
+    // Other graphs have no pull index.
+    template<typename G>
+      inline bool
+      borrow_index(const G&, std::vector<std::size_t>&, std::vector<std::size_t>&,
+                   const Vertex<G>*&, long)
+      {
+        return false;
+      }
+
+  } // namespace page_rank_impl
+
+
+  // The rank engine for the graph G. The graph must not be modified while
+  // the engine is in use.
+  //
+  // Ranks are written to caller-provided arrays indexed by vertex handle.
+  // Handles of removed vertices have rank 0.
+  template<typename G>
+    class rank_engine
+    {
+    public:
+      using vertex = Vertex<G>;
+
+      // Create an engine for g that runs on the given number of threads. If
+      // threads is 0, the hardware concurrency is used.
+      explicit rank_engine(const G& g, std::size_t threads = 0);
+
+      std::size_t threads() const { return threads_; }
+
+      // Compute the PageRank of every vertex, writing it to rank. Returns
+      // the number of iterations.
+      std::size_t page_rank(double* rank);
+
+      // Compute the personalized PageRank of every vertex for each of the k
+      // seeds, writing the rank of v for seeds[j] to rank[v * k + j].
+      // Returns the number of iterations.
+      std::size_t personalized(const vertex* seeds, std::size_t k, double* rank);
+
+      // Iteration parameters.
+      double damping = 0.85;
+      double tolerance = 1e-9;
+      std::size_t max_iterations = 100;
+
+    private:
+      void build_index(const G& g);
+      std::size_t run(double* rank, const vertex* seeds, std::size_t k);
+      void scatter(std::size_t t, const double* rank, std::size_t k);
+      void pull(std::size_t t, double* rank, const vertex* seeds, std::size_t k);
+
+    private:
+      std::size_t threads_;
+      std::size_t bound_;                 // The vertex bound of g
+      std::size_t order_;                 // The number of vertices of g
+      std::vector<std::size_t> offsets_;  // In edge offsets, by vertex
+      std::vector<vertex> own_sources_;   // In edge sources, if copied
+      const vertex* sources_;             // In edge sources
+      std::vector<std::size_t> degree_;   // Out degrees, by vertex
+      std::vector<char> live_;            // The vertices of g
+      std::vector<char> seed_;            // The seeds of the current batch
+      std::vector<double> contrib_;       // Rank per out edge, by vertex
+
+      // Per-thread sums: the rank of vertices without out edges, the change
+      // in rank, and pull accumulators, k values each.
+      std::vector<std::vector<double>> dangling_;
+      std::vector<std::vector<double>> change_;
+      std::vector<std::vector<double>> acc_;
+      std::vector<double> base_;          // Teleport mass, per seed
+      std::atomic<std::size_t> cursor_;
+    };
+
+  template<typename G>
+    rank_engine<G>::rank_engine(const G& g, std::size_t threads)
+      : threads_(parallel_impl::team_size(threads)),
+        bound_(vertex_bound(g)),
+        order_(0),
+        degree_(bound_, 0),
+        live_(bound_, 0),
+        seed_(bound_, 0),
+        dangling_(threads_),
+        change_(threads_),
+        acc_(threads_)
+    {
+      for (vertex u : g.vertices()) {
+        live_[u] = 1;
+        ++order_;
+      }
+      if (!page_rank_impl::borrow_index(g, offsets_, degree_, sources_, 0))
+        build_index(g);
+    }
+
+  // Build the pull index by counting sort over the out edges.
+  template<typename G>
+    void
+    rank_engine<G>::build_index(const G& g)
+    {
+      using namespace neighbors_impl;
+      offsets_.assign(bound_ + 1, 0);
+      for (vertex u : g.vertices()) {
+        for (auto e : neighbor_edges(g, u)) {
+          ++degree_[u];
+          ++offsets_[neighbor(g, e, u) + 1];
+        }
+      }
+      for (std::size_t v = 0; v < bound_; ++v)
+        offsets_[v + 1] += offsets_[v];
+
+      own_sources_.resize(offsets_[bound_]);
+      std::vector<std::size_t> pos(offsets_.begin(), offsets_.end() - 1);
+      for (vertex u : g.vertices())
+        for (auto e : neighbor_edges(g, u))
+          own_sources_[pos[neighbor(g, e, u)]++] = u;
+      sources_ = own_sources_.data();
+    }
+
+  template<typename G>
+    inline std::size_t
+    rank_engine<G>::page_rank(double* rank)
+    {
+      for (std::size_t v = 0; v < bound_; ++v)
+        rank[v] = live_[v] ? 1.0 / order_ : 0.0;
+      return run(rank, nullptr, 1);
+    }
+
+  template<typename G>
+    std::size_t
+    rank_engine<G>::personalized(const vertex* seeds, std::size_t k, double* rank)
+    {
+      std::fill(rank, rank + bound_ * k, 0.0);
+      for (std::size_t j = 0; j < k; ++j) {
+        assert(std::size_t(seeds[j]) < bound_ && live_[seeds[j]]);
+        rank[std::size_t(seeds[j]) * k + j] = 1.0;
+        seed_[seeds[j]] = 1;
+      }
+      std::size_t n = run(rank, seeds, k);
+      for (std::size_t j = 0; j < k; ++j)
+        seed_[seeds[j]] = 0;
+      return n;
+    }
+
+  // Each iteration has two passes separated by barriers. The first computes
+  // the contribution of each vertex to its neighbors, and the second pulls
+  // the contributions into each vertex. The second pass reads only the
+  // contributions, so it updates the ranks in place. The first thread
+  // combines the per-thread sums between passes.
+  template<typename G>
+    std::size_t
+    rank_engine<G>::run(double* rank, const vertex* seeds, std::size_t k)
+    {
+      if (order_ == 0)
+        return 0;
+      contrib_.resize(bound_ * k);
+      base_.resize(k);
+      for (std::size_t t = 0; t < threads_; ++t) {
+        dangling_[t].assign(k, 0.0);
+        change_[t].assign(k, 0.0);
+        acc_[t].resize(k);
+      }
+
+      parallel_impl::barrier sync(threads_);
+      std::size_t iterations = 0;
+      bool done = false;
+      cursor_ = 0;
+      parallel_impl::run_team(threads_, [&](std::size_t t) {
+        while (!done) {
+          scatter(t, rank, k);
+          sync.wait();
+          if (t == 0) {
+            for (std::size_t j = 0; j < k; ++j) {
+              double d = 0;
+              for (std::size_t x = 0; x < threads_; ++x) {
+                d += dangling_[x][j];
+                dangling_[x][j] = 0;
+              }
+              double mass = (1 - damping) + damping * d;
+              base_[j] = seeds ? mass : mass / order_;
+            }
+            cursor_ = 0;
+          }
+          sync.wait();
+          pull(t, rank, seeds, k);
+          sync.wait();
+          if (t == 0) {
+            double worst = 0;
+            for (std::size_t j = 0; j < k; ++j) {
+              double c = 0;
+              for (std::size_t x = 0; x < threads_; ++x) {
+                c += change_[x][j];
+                change_[x][j] = 0;
+              }
+              worst = std::max(worst, c);
+            }
+            ++iterations;
+            done = worst < tolerance || iterations >= max_iterations;
+            cursor_ = 0;
+          }
+          sync.wait();
+        }
+      });
+      return iterations;
+    }
+
+  // Compute the contributions of a chunk of vertices, and sum the ranks of
+  // those without out edges.
+  template<typename G>
+    void
+    rank_engine<G>::scatter(std::size_t t, const double* rank, std::size_t k)
+    {
+      double* dangling = dangling_[t].data();
+      while (true) {
+        std::size_t v = cursor_.fetch_add(page_rank_impl::chunk);
+        if (v >= bound_)
+          break;
+        std::size_t last = std::min(bound_, v + page_rank_impl::chunk);
+        for (; v < last; ++v) {
+          const double* x = rank + v * k;
+          double* c = contrib_.data() + v * k;
+          if (degree_[v] != 0) {
+            double r = 1.0 / degree_[v];
+            for (std::size_t j = 0; j < k; ++j)
+              c[j] = x[j] * r;
+          } else {
+            for (std::size_t j = 0; j < k; ++j) {
+              c[j] = 0;
+              dangling[j] += x[j];
+            }
+          }
+        }
+      }
+    }
+
+  // Pull the contributions into a chunk of vertices, recording the change
+  // in rank.
+  template<typename G>
+    void
+    rank_engine<G>::pull(std::size_t t, double* rank, const vertex* seeds, std::size_t k)
+    {
+      using namespace page_rank_impl;
+      double* change = change_[t].data();
+      double* acc = acc_[t].data();
+      const double* contrib = contrib_.data();
+      const vertex* src = sources_;
+      while (true) {
+        std::size_t v = cursor_.fetch_add(chunk);
+        if (v >= bound_)
+          break;
+        std::size_t last = std::min(bound_, v + chunk);
+        for (; v < last; ++v) {
+          if (!live_[v])
+            continue;
+          if (!seeds) {
+            double r = base_[0] + damping * gather_sum(contrib, src, offsets_[v], offsets_[v + 1]);
+            change[0] += std::abs(r - rank[v]);
+            rank[v] = r;
+            continue;
+          }
+          gather_rows(contrib, src, offsets_[v], offsets_[v + 1], k, acc);
+          double* x = rank + v * k;
+          for (std::size_t j = 0; j < k; ++j) {
+            double r = damping * acc[j];
+            if (seed_[v] && std::size_t(seeds[j]) == v)
+              r += base_[j];
+            change[j] += std::abs(r - x[j]);
+            x[j] = r;
+          }
+        }
+      }
+    }
+
+
+  // Compute the PageRank of every vertex of g. See rank_engine.
+  template<typename G>
+    inline std::size_t
+    page_rank(const G& g, double* rank, std::size_t threads = 0)
+    {
+      rank_engine<G> pr(g, threads);
+      return pr.page_rank(rank);
+    }
+
+} // namespace origin
+
+#endif
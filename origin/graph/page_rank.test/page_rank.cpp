@@ -0,0 +1,148 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+#include <origin/graph/page_rank.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+constexpr size_t npos = -1;
+
+// Returns the PageRank of g computed by following the incidence lists of
+// each vertex. If seed is valid, the rank is personalized to the seed.
+template<typename G>
+  vector<double>
+  serial_rank(const G& g, size_t seed, double d)
+  {
+    using namespace neighbors_impl;
+    size_t n = vertex_bound(g);
+    vector<double> rank(n, 0.0);
+    for (auto v : g.vertices())
+      rank[v] = seed == npos ? 1.0 / g.order() : (size_t(v) == seed);
+    for (int i = 0; i < 200; ++i) {
+      vector<double> next(n, 0.0);
+      double dangling = 0;
+      for (auto u : g.vertices()) {
+        size_t k = 0;
+        for (auto e : neighbor_edges(g, u)) {
+          (void)e;
+          ++k;
+        }
+        if (k == 0)
+          dangling += rank[u];
+        for (auto e : neighbor_edges(g, u))
+          next[neighbor(g, e, u)] += d * rank[u] / k;
+      }
+      double mass = (1 - d) + d * dangling;
+      for (auto v : g.vertices()) {
+        if (seed == npos)
+          next[v] += mass / g.order();
+        else if (size_t(v) == seed)
+          next[v] += mass;
+      }
+      rank.swap(next);
+    }
+    return rank;
+  }
+
+bool
+close(double a, double b) { return abs(a - b) < 1e-8; }
+
+template<typename G>
+  void
+  check_page_rank(const G& g)
+  {
+    cout << "*** page rank (" << typestr<G>() << ") ***\n";
+    size_t n = vertex_bound(g);
+    vector<double> expect = serial_rank(g, npos, 0.85);
+    double total = 0;
+    for (double x : expect)
+      total += x;
+    assert(close(total, 1.0));
+
+    vector<Vertex<G>> seeds;
+    for (auto v : g.vertices())
+      if (size_t(v) % 29 == 3)
+        seeds.push_back(v);
+    vector<vector<double>> personal;
+    for (auto s : seeds)
+      personal.push_back(serial_rank(g, s, 0.85));
+
+    for (size_t t : {1, 4}) {
+      rank_engine<G> pr(g, t);
+      pr.tolerance = 1e-12;
+      pr.max_iterations = 500;
+      vector<double> rank(n);
+      size_t iters = pr.page_rank(rank.data());
+      assert(iters > 1 && iters < 500);
+      for (size_t v = 0; v < n; ++v)
+        assert(close(rank[v], expect[v]));
+
+      size_t k = seeds.size();
+      vector<double> batch(n * k);
+      pr.personalized(seeds.data(), k, batch.data());
+      for (size_t j = 0; j < k; ++j)
+        for (size_t v = 0; v < n; ++v)
+          assert(close(batch[v * k + j], personal[j][v]));
+
+      // The iteration limit is respected.
+      pr.max_iterations = 3;
+      assert(pr.page_rank(rank.data()) == 3);
+    }
+  }
+
+// Returns m random edges over n vertices. The last vertex has no out edges.
+template<typename R>
+  vector<tuple<size_t, size_t>>
+  random_edges(R& gen, size_t n, size_t m)
+  {
+    vector<tuple<size_t, size_t>> es;
+    for (size_t i = 0; i < m; ++i)
+      es.emplace_back(gen() % (n - 1), gen() % 3 == 0 ? n - 1 : gen() % n);
+    return es;
+  }
+
+int main()
+{
+  minstd_rand gen;
+  size_t n = 300;
+  auto es = random_edges(gen, n, 1500);
+
+  using DV = directed_adjacency_vector<char>;
+  DV g(n, es);
+  check_page_rank(g);
+  check_page_rank(freeze(g, true));
+  check_page_rank(freeze(g));
+  check_page_rank(directed_adjacency_vector<char, empty_t, narrow_adjacency_vector_traits>(n, es));
+  check_page_rank(undirected_adjacency_vector<char>(n, es));
+
+  // Removed vertices have rank 0.
+  using D = directed_adjacency_list<char, int>;
+  D h = build_graph<D>(n, es);
+  h.remove_vertex(Vertex<D>(10));
+  check_page_rank(h);
+  vector<double> rank(vertex_bound(h));
+  page_rank(h, rank.data());
+  assert(rank[10] == 0);
+
+  // A graph without vertices.
+  DV e;
+  assert(page_rank(e, nullptr) == 0);
+}
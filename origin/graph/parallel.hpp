@@ -0,0 +1,177 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_PARALLEL_HPP
+#define ORIGIN_GRAPH_PARALLEL_HPP
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.parallel]
+  //                           Parallel Execution
+  //
+  // The parallel graph algorithms run on teams of std::threads. The calling
+  // thread is always a member of the team, so a team of one thread runs
+  // serially without creating threads. Work is distributed dynamically:
+  // threads claim chunks of an index range from an atomic cursor, which
+  // balances the load when the cost of each index varies with its degree.
+
+  namespace parallel_impl
+  {
+    // Returns the number of threads in a team of the requested size. If
+    // threads is 0, the hardware concurrency is used.
+    inline std::size_t
+    team_size(std::size_t threads)
+    {
+      if (threads != 0)
+        return threads;
+      return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Run f(t) on each thread t of a team of the given size, returning when
+    // all have finished.
+    template<typename F>
+      void
+      run_team(std::size_t threads, F f)
+      {
+        std::vector<std::thread> team;
+        for (std::size_t t = 1; t < threads; ++t)
+          team.emplace_back(f, t);
+        f(0);
+        for (std::thread& x : team)
+          x.join();
+      }
+
+    // Call f(t, first, last) for chunks [first, last) of [0, n), where t is
+    // the thread claiming the chunk.
+    template<typename F>
+      void
+      parallel_for(std::size_t threads, std::size_t n, std::size_t chunk, F f)
+      {
+        std::atomic<std::size_t> cursor(0);
+        run_team(threads, [&](std::size_t t) {
+          while (true) {
+            std::size_t i = cursor.fetch_add(chunk);
+            if (i >= n)
+              break;
+            f(t, i, std::min(n, i + chunk));
+          }
+        });
+      }
+
+    // Call f(t, b[i], b[i + 1]) for each block of the increasing bounds b,
+    // where t is the thread claiming the block.
+    template<typename F>
+      void
+      parallel_for_blocks(std::size_t threads, const std::vector<std::size_t>& b,
+                          F f)
+      {
+        std::atomic<std::size_t> cursor(0);
+        std::size_t n = b.empty() ? 0 : b.size() - 1;
+        run_team(threads, [&](std::size_t t) {
+          while (true) {
+            std::size_t i = cursor.fetch_add(1);
+            if (i >= n)
+              break;
+            if (b[i] != b[i + 1])
+              f(t, b[i], b[i + 1]);
+          }
+        });
+      }
+
+    // ---------------------------------------------------------------------- //
+    //                          Cache Line Alignment
+    //
+    // Objects written by different threads of a team are declared
+    // alignas(cache_line), so that no two of them share a cache line. The
+    // default allocator only guarantees the alignment of fundamental types,
+    // so arrays of such objects are allocated by a cache_aligned_allocator.
+    constexpr std::size_t cache_line = 64;
+
+    template<typename T>
+      struct cache_aligned_allocator
+      {
+        using value_type = T;
+
+        cache_aligned_allocator() = default;
+
+        template<typename U>
+          cache_aligned_allocator(const cache_aligned_allocator<U>&) { }
+
+        T* allocate(std::size_t n)
+        {
+          void* p;
+          if (posix_memalign(&p, cache_line, n * sizeof(T)) != 0)
+            throw std::bad_alloc();
+          return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, std::size_t) { free(p); }
+      };
+
+    template<typename T, typename U>
+      inline bool
+      operator==(const cache_aligned_allocator<T>&, const cache_aligned_allocator<U>&)
+      {
+        return true;
+      }
+
+    template<typename T, typename U>
+      inline bool
+      operator!=(const cache_aligned_allocator<T>&, const cache_aligned_allocator<U>&)
+      {
+        return false;
+      }
+
+    // ---------------------------------------------------------------------- //
+    //                                Barrier
+    //
+    // A barrier blocks the threads of a team until all of them have reached
+    // it. It can be reused immediately.
+    class barrier
+    {
+    public:
+      explicit barrier(std::size_t n) : size_(n), count_(n), phase_(0) { }
+
+      void wait();
+
+    private:
+      std::mutex mutex_;
+      std::condition_variable cv_;
+      std::size_t size_;
+      std::size_t count_;
+      std::size_t phase_;
+    };
+
+    inline void
+    barrier::wait()
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      std::size_t p = phase_;
+      if (--count_ == 0) {
+        count_ = size_;
+        ++phase_;
+        cv_.notify_all();
+      } else {
+        cv_.wait(lock, [this, p]() { return phase_ != p; });
+      }
+    }
+
+  } // namespace parallel_impl
+} // namespace origin
+
+#endif
@@ -0,0 +1,323 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_PARTITION_HPP
+#define ORIGIN_GRAPH_PARTITION_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/parallel.hpp>
+#include <origin/graph/reorder.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                         [graph.partition]
+  //                           Graph Partitioning
+  //
+  // The work of a vertex is the number of its forward edges (the out edges
+  // of a directed graph, or the incident edges of an undirected graph) plus
+  // one for the vertex itself.
+  //
+  // A balanced split divides the vertex handles of a graph into k contiguous
+  // ranges of about the same work. Splitting by vertex count balances badly
+  // on graphs with skewed degrees, where a few hubs own most of the edges.
+  // The split is a binary search of the prefix sums of the work. For graphs
+  // that expose CSR offsets, such as the compressed graph, the offsets give
+  // the prefix sums directly, and the split takes O(k log V) time instead of
+  // O(V). A vertex is never divided, so a hub with more than its share of
+  // the work makes its range larger than the others.
+  //
+  // parallel_for_balanced runs a loop over the vertices of a graph on a team
+  // of threads, which claim the ranges of a balanced split dynamically. The
+  // split has several ranges per thread, so that a thread delayed by a hub
+  // does not hold up the team.
+  //
+  // An edge-cut partition assigns each vertex to one of k parts, so that
+  // the parts have about the same work and few edges join vertices in
+  // different parts, e.g., to distribute a graph over worker processes. The
+  // vertices are streamed in breadth-first order, and each is placed by the
+  // linear deterministic greedy rule of Stanton and Kliot: in the part
+  // holding the most of its placed neighbors, discounted by the fullness of
+  // the part. Rounds of refinement then move each vertex to the part holding
+  // the most of its neighbors, when that reduces the cut and keeps the part
+  // within its capacity. The capacity of a part is (1 + imbalance) times the
+  // average work of a part. Edges of a directed graph are counted in both
+  // directions.
+
+  namespace partition_impl
+  {
+    constexpr std::size_t npos = -1;
+
+    // The number of ranges claimed by each thread of a balanced loop, on
+    // average.
+    constexpr std::size_t blocks_per_thread = 8;
+
+    // Returns the work of v.
+    template<typename G>
+      inline std::size_t
+      work(const G& g, Vertex<G> v, Requires<Directed_graph<G>()>* = nullptr)
+      {
+        return g.out_degree(v) + 1;
+      }
+
+    template<typename G>
+      inline std::size_t
+      work(const G& g, Vertex<G> v, Requires<Undirected_graph<G>()>* = nullptr)
+      {
+        return g.degree(v) + 1;
+      }
+
+    // Returns the bounds of k ranges of [0, n) with about the same work,
+    // where prefix(i) is the work of the handles less than i.
+    template<typename P>
+      std::vector<std::size_t>
+      split_prefix(P prefix, std::size_t n, std::size_t k)
+      {
+        assert(k > 0);
+        std::vector<std::size_t> b(k + 1, n);
+        b[0] = 0;
+        std::size_t total = prefix(n);
+        for (std::size_t i = 1; i < k; ++i) {
+          std::size_t goal = total / k * i + total % k * i / k;
+
+          // Find the first bound whose prefix reaches the goal, and step
+          // back if the previous bound is closer.
+          std::size_t lo = b[i - 1], hi = n;
+          while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            if (prefix(mid) < goal)
+              lo = mid + 1;
+            else
+              hi = mid;
+          }
+          if (lo > b[i - 1] && goal - prefix(lo - 1) < prefix(lo) - goal)
+            --lo;
+          b[i] = lo;
+        }
+        return b;
+      }
+
+    // Split a graph with CSR offsets.
+    template<typename G>
+      inline auto
+      balanced_split(const G& g, std::size_t k, int)
+        -> decltype(g.offsets()[0], std::vector<std::size_t>())
+      {
+        const auto& off = g.offsets();
+        auto prefix = [&off](std::size_t i) -> std::size_t { return off[i] + i; };
+        return split_prefix(prefix, g.vertex_bound(), k);
+      }
+
+    // Split other graphs, whose prefix sums are computed first. The slots
+    // of removed vertices have no work.
+    template<typename G>
+      std::vector<std::size_t>
+      balanced_split(const G& g, std::size_t k, long)
+      {
+        std::vector<std::size_t> p(g.vertex_bound() + 1, 0);
+        for (auto v : g.vertices())
+          p[std::size_t(v) + 1] = work(g, v);
+        for (std::size_t i = 1; i < p.size(); ++i)
+          p[i] += p[i - 1];
+        auto prefix = [&p](std::size_t i) { return p[i]; };
+        return split_prefix(prefix, g.vertex_bound(), k);
+      }
+
+    // The parts of an edge-cut partition, with their loads. The lightest
+    // part is found through an ordered set of (load, part) pairs.
+    template<typename G>
+      class partitioner
+      {
+      public:
+        partitioner(const G& g, std::size_t k, std::size_t* part, double imbalance);
+
+        void place(Vertex<G> v);
+        bool refine(Vertex<G> v);
+
+      private:
+        void tally(Vertex<G> v);
+        void assign(Vertex<G> v, std::size_t p);
+
+        const G& g_;
+        std::size_t k_;
+        std::size_t* part_;
+        double capacity_;
+        std::vector<std::size_t> load_;
+        std::set<std::pair<std::size_t, std::size_t>> light_;
+
+        // The number of neighbors of a vertex in each part, and the parts
+        // with a nonzero count.
+        std::vector<std::size_t> count_;
+        std::vector<std::size_t> touched_;
+      };
+
+    template<typename G>
+      partitioner<G>::partitioner(const G& g, std::size_t k, std::size_t* part,
+                                  double imbalance)
+        : g_(g), k_(k), part_(part), load_(k, 0), count_(k, 0)
+      {
+        std::size_t total = 0;
+        for (auto v : g.vertices())
+          total += work(g, v);
+        capacity_ = (1 + imbalance) * double(total) / k;
+        for (std::size_t p = 0; p < k; ++p)
+          light_.emplace(0, p);
+      }
+
+    // Count the neighbors of v in each part.
+    template<typename G>
+      void
+      partitioner<G>::tally(Vertex<G> v)
+      {
+        for (std::size_t p : touched_)
+          count_[p] = 0;
+        touched_.clear();
+        reorder_impl::for_adjacent(g_, v, [&](Vertex<G> w) {
+          std::size_t p = part_[w];
+          if (w == v || p == npos)
+            return;
+          if (count_[p]++ == 0)
+            touched_.push_back(p);
+        });
+      }
+
+    // Move v to the part p.
+    template<typename G>
+      void
+      partitioner<G>::assign(Vertex<G> v, std::size_t p)
+      {
+        std::size_t w = work(g_, v);
+        std::size_t q = part_[v];
+        if (q != npos) {
+          light_.erase({load_[q], q});
+          load_[q] -= w;
+          light_.emplace(load_[q], q);
+        }
+        light_.erase({load_[p], p});
+        load_[p] += w;
+        light_.emplace(load_[p], p);
+        part_[v] = p;
+      }
+
+    // Place v in the part with the most of its neighbors, discounted by
+    // the load of the part, or in the lightest part.
+    template<typename G>
+      void
+      partitioner<G>::place(Vertex<G> v)
+      {
+        tally(v);
+        std::size_t w = work(g_, v);
+        std::size_t best = light_.begin()->second;
+        double score = 0;
+        for (std::size_t p : touched_) {
+          if (load_[p] + w > capacity_)
+            continue;
+          double s = count_[p] * (1 - load_[p] / capacity_);
+          if (s > score || (s == score && load_[p] < load_[best])) {
+            best = p;
+            score = s;
+          }
+        }
+        assign(v, best);
+      }
+
+    // Move v to the part with the most of its neighbors, if that has more
+    // than its own part and room for v. Returns true if v was moved.
+    template<typename G>
+      bool
+      partitioner<G>::refine(Vertex<G> v)
+      {
+        tally(v);
+        std::size_t w = work(g_, v);
+        std::size_t q = part_[v];
+        std::size_t best = q;
+        for (std::size_t p : touched_) {
+          if (p == q || load_[p] + w > capacity_)
+            continue;
+          if (count_[p] > count_[best] ||
+              (count_[p] == count_[best] && best != q && load_[p] < load_[best]))
+            best = p;
+        }
+        if (best == q)
+          return false;
+        assign(v, best);
+        return true;
+      }
+
+  } // namespace partition_impl
+
+
+  // Returns the bounds of k contiguous ranges of the vertex handles of g with
+  // about the same work. The ranges are [b[i], b[i + 1]) for i < k, and some
+  // may be empty.
+  template<typename G>
+    inline std::vector<std::size_t>
+    balanced_split(const G& g, std::size_t k)
+    {
+      return partition_impl::balanced_split(g, k, 0);
+    }
+
+  // Call f(t, first, last) for ranges [first, last) of the vertex handles of
+  // g with about the same work, where t is the thread claiming the range.
+  // The handles of g must be dense.
+  template<typename G, typename F>
+    void
+    parallel_for_balanced(const G& g, std::size_t threads, F f)
+    {
+      assert(g.vertex_bound() == g.order());
+      threads = parallel_impl::team_size(threads);
+      std::size_t k = threads == 1 ? 1 : threads * partition_impl::blocks_per_thread;
+      parallel_impl::parallel_for_blocks(threads, balanced_split(g, k), f);
+    }
+
+  // Returns the number of edges of g whose endpoints are in different parts.
+  template<typename G>
+    std::size_t
+    edge_cut(const G& g, const std::size_t* part)
+    {
+      std::size_t n = 0;
+      for (auto e : g.edges())
+        n += part[g.source(e)] != part[g.target(e)];
+      return n;
+    }
+
+  // Assign each vertex v of g to a part, part[v] < k, with at most
+  // (1 + imbalance) times the average work per part, unless a vertex alone
+  // exceeds it. The array part is indexed by handle; the slots of removed
+  // vertices are set to -1. At most the given number of refinement rounds
+  // are run. Returns the number of cut edges.
+  template<typename G>
+    std::size_t
+    partition_graph(const G& g, std::size_t k, std::size_t* part,
+                    double imbalance = 0.05, std::size_t rounds = 4)
+    {
+      assert(k > 0);
+      std::fill(part, part + g.vertex_bound(), partition_impl::npos);
+      partition_impl::partitioner<G> p(g, k, part, imbalance);
+      std::vector<Vertex<G>> order = breadth_first_order(g);
+      for (Vertex<G> v : order)
+        p.place(v);
+      for (std::size_t r = 0; r < rounds; ++r) {
+        std::size_t moves = 0;
+        for (Vertex<G> v : order)
+          moves += p.refine(v);
+        if (moves == 0)
+          break;
+      }
+      return edge_cut(g, part);
+    }
+
+} // namespace origin
+
+#endif
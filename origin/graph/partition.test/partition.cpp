@@ -0,0 +1,226 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+#include <origin/graph/partition.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+using edge_pair = tuple<size_t, size_t>;
+
+constexpr size_t npos = -1;
+
+// Returns the edges of a graph in which a few hubs own most of the edges.
+vector<edge_pair>
+skewed_edges(size_t n, size_t m)
+{
+  minstd_rand gen;
+  vector<edge_pair> es;
+  for (size_t i = 0; i < m; ++i) {
+    size_t u = i % 2 == 0 ? gen() % 4 : gen() % n;
+    es.emplace_back(u, gen() % n);
+  }
+  return es;
+}
+
+// Returns the work of the vertices in [first, last) of the directed graph g.
+template<typename G>
+  size_t
+  range_work(const G& g, size_t first, size_t last)
+  {
+    size_t w = 0;
+    for (size_t v = first; v < last; ++v)
+      w += g.out_degree(Vertex<G>(v)) + 1;
+    return w;
+  }
+
+// Ranges of a split have about the same work.
+template<typename G>
+  void
+  check_split(const G& g, size_t k)
+  {
+    auto b = balanced_split(g, k);
+    size_t n = g.vertex_bound();
+    assert(b.size() == k + 1 && b[0] == 0 && b[k] == n);
+    assert(is_sorted(b.begin(), b.end()));
+    size_t total = range_work(g, 0, n);
+    size_t hub = 0;
+    for (size_t v = 0; v < n; ++v)
+      hub = max(hub, g.out_degree(Vertex<G>(v)) + 1);
+    for (size_t i = 0; i < k; ++i)
+      assert(range_work(g, b[i], b[i + 1]) <= total / k + 2 * hub);
+  }
+
+void
+check_balanced_split()
+{
+  cout << "*** balanced split ***\n";
+  using G = directed_adjacency_vector<char>;
+  size_t n = 5000;
+  G g(n, skewed_edges(n, 40000));
+  for (size_t k : {1, 2, 7, 64})
+    check_split(g, k);
+
+  // An even split of the vertices would give the first range most of the
+  // edges.
+  auto b = balanced_split(g, 8);
+  assert(b[1] < n / 8);
+
+  // Compressed graphs are split through their offsets, with the same
+  // result.
+  compressed_graph<char> c(g, false);
+  for (size_t k : {1, 3, 8, 64})
+    assert(balanced_split(c, k) == balanced_split(g, k));
+  check_split(c, 8);
+
+  // More ranges than vertices, and an empty graph.
+  G small(3, vector<edge_pair> {edge_pair(0, 1)});
+  b = balanced_split(small, 8);
+  assert(b.size() == 9 && b[8] == 3);
+  assert(balanced_split(G(), 4) == vector<size_t>(5, 0));
+}
+
+// A balanced loop visits every vertex once.
+void
+check_parallel_for()
+{
+  cout << "*** balanced parallel loop ***\n";
+  using G = directed_adjacency_vector<char>;
+  size_t n = 3000;
+  G g(n, skewed_edges(n, 30000));
+  for (size_t threads : {1, 4}) {
+    vector<atomic<int>> seen(n);
+    for (auto& x : seen)
+      x = 0;
+    atomic<size_t> edges(0);
+    parallel_for_balanced(g, threads, [&](size_t t, size_t first, size_t last) {
+      assert(t < threads && first < last);
+      for (size_t v = first; v < last; ++v) {
+        ++seen[v];
+        edges += g.out_degree(Vertex<G>(v));
+      }
+    });
+    assert(edges == g.size());
+    for (auto& x : seen)
+      assert(x == 1);
+  }
+}
+
+// Check that a partition is complete and within its capacity.
+template<typename G>
+  void
+  check_parts(const G& g, size_t k, const vector<size_t>& part, double imbalance)
+  {
+    vector<size_t> load(k, 0);
+    size_t total = 0;
+    for (auto v : g.vertices()) {
+      assert(part[v] < k);
+      size_t w = g.degree(v) + 1;
+      load[part[v]] += w;
+      total += w;
+    }
+    for (size_t p = 0; p < k; ++p)
+      assert(load[p] <= (1 + imbalance) * total / k);
+  }
+
+// Clusters joined by a few edges are recovered, with their vertices
+// shuffled.
+void
+check_clusters()
+{
+  cout << "*** edge-cut partition clusters ***\n";
+  using G = undirected_adjacency_vector<char>;
+  minstd_rand gen;
+  size_t k = 4, c = 100, n = k * c;
+  vector<size_t> p(n);
+  for (size_t i = 0; i < n; ++i)
+    p[i] = i;
+  shuffle(p.begin(), p.end(), gen);
+  vector<edge_pair> es;
+  for (size_t i = 0; i < k; ++i)
+    for (size_t j = 0; j < 8 * c; ++j)
+      es.emplace_back(p[i * c + gen() % c], p[i * c + gen() % c]);
+  for (size_t j = 0; j < 20; ++j)
+    es.emplace_back(p[gen() % n], p[gen() % n]);
+  G g(n, es);
+
+  vector<size_t> part(n);
+  size_t cut = partition_graph(g, k, part.data(), 0.1);
+  assert(cut == edge_cut(g, part.data()));
+  check_parts(g, k, part, 0.1);
+  assert(cut <= 100);
+
+  // A random assignment cuts about three quarters of the edges.
+  vector<size_t> random(n);
+  for (size_t& x : random)
+    x = gen() % k;
+  assert(edge_cut(g, random.data()) > 10 * cut);
+
+  // One part cuts nothing.
+  assert(partition_graph(g, 1, part.data()) == 0);
+}
+
+// Grids, directed graphs, and graphs with removed vertices.
+void
+check_partition()
+{
+  cout << "*** edge-cut partition ***\n";
+  size_t w = 40, h = 40, n = w * h;
+  vector<edge_pair> es;
+  for (size_t i = 0; i < h; ++i) {
+    for (size_t j = 0; j < w; ++j) {
+      if (j + 1 < w)
+        es.emplace_back(i * w + j, i * w + j + 1);
+      if (i + 1 < h)
+        es.emplace_back(i * w + j, (i + 1) * w + j);
+    }
+  }
+  using U = undirected_adjacency_vector<char>;
+  U grid(n, es);
+  vector<size_t> part(n);
+  size_t cut = partition_graph(grid, 8, part.data());
+  check_parts(grid, 8, part, 0.05);
+  assert(cut < es.size() / 6);
+
+  using D = directed_adjacency_vector<char>;
+  D dgrid(n, es);
+  assert(partition_graph(dgrid, 8, part.data()) < es.size() / 6);
+
+  using L = undirected_adjacency_list<char>;
+  L g = build_n_graph<L>(50);
+  for (size_t i = 0; i + 1 < 50; ++i)
+    g.add_edge(Vertex<L>(i), Vertex<L>(i + 1));
+  g.remove_vertex(Vertex<L>(10));
+  g.remove_vertex(Vertex<L>(30));
+  part.assign(50, 0);
+  cut = partition_graph(g, 3, part.data(), 0.2);
+  assert(part[10] == npos && part[30] == npos);
+  check_parts(g, 3, part, 0.2);
+  assert(cut <= 4);
+}
+
+int main()
+{
+  check_balanced_split();
+  check_parallel_for();
+  check_clusters();
+  check_partition();
+}
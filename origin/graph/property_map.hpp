@@ -0,0 +1,275 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_PROPERTY_MAP_HPP
+#define ORIGIN_GRAPH_PROPERTY_MAP_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <origin/graph/graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                        [graph.property]
+  //                            Property Maps
+  //
+  // A property map associates a value with each vertex or edge of a graph
+  // without storing it in the graph. The map is a dense array indexed by
+  // handle, sized by the vertex or edge bound of the graph, so for graphs
+  // that reuse handles it includes the slots of removed vertices and edges.
+  // Algorithms that take arrays indexed by handle can be given the data()
+  // of a map. Since std::vector<bool> has no such array, maps of bool are
+  // not allowed; flags are mapped to char, as in the graph algorithms.
+  //
+  // Every key that has not been written maps to the default value of the
+  // map. Writing through a key beyond the end of the map grows it, so a map
+  // keeps up with vertices and edges added to the graph after it was
+  // created. Reading through such a key returns the default value.
+  //
+  // An atomic map stores each value in a std::atomic<T>, so that threads
+  // can update the values of different or the same keys concurrently. Its
+  // size is fixed during a concurrent phase: a map must be resized to the
+  // bounds of the graph, by a single thread, before handles added since it
+  // was created are used.
+
+  // A dense map from the handles of type K to values of type T.
+  template<typename K, typename T>
+    class dense_map
+    {
+      static_assert(!std::is_same<T, bool>::value,
+                    "dense_map<K, bool> has no data(); map to char instead");
+
+      using storage = std::vector<T>;
+    public:
+      using key_type = K;
+      using value_type = T;
+      using reference = typename storage::reference;
+      using const_reference = typename storage::const_reference;
+
+      // Create a map of n keys, each mapped to x.
+      explicit dense_map(std::size_t n = 0, const T& x = T())
+        : data_(n, x), default_(x)
+      { }
+
+      std::size_t size() const { return data_.size(); }
+      const T& default_value() const { return default_; }
+
+      // Element access
+      reference       operator[](K k);
+      const_reference operator[](K k) const;
+
+      T*       data()       { return data_.data(); }
+      const T* data() const { return data_.data(); }
+
+      // Resize the map to n keys. New keys are mapped to the default value.
+      void resize(std::size_t n) { data_.resize(n, default_); }
+
+      // Map every key to x.
+      void fill(const T& x) { std::fill(data_.begin(), data_.end(), x); }
+
+    private:
+      storage data_;
+      T default_;
+    };
+
+  template<typename K, typename T>
+    inline auto
+    dense_map<K, T>::operator[](K k) -> reference
+    {
+      assert(k);
+      if (std::size_t(k) >= data_.size())
+        data_.resize(std::size_t(k) + 1, default_);
+      return data_[k];
+    }
+
+  template<typename K, typename T>
+    inline auto
+    dense_map<K, T>::operator[](K k) const -> const_reference
+    {
+      assert(k);
+      return std::size_t(k) < data_.size() ? data_[k] : default_;
+    }
+
+
+  // A dense map from the handles of type K to atomic values of type T. T
+  // must be trivially copyable.
+  template<typename K, typename T>
+    class atomic_dense_map
+    {
+    public:
+      using key_type = K;
+      using value_type = T;
+
+      // Create a map of n keys, each mapped to x.
+      explicit atomic_dense_map(std::size_t n = 0, T x = T())
+        : data_(new std::atomic<T>[n]), size_(n), default_(x)
+      {
+        fill(x);
+      }
+
+      atomic_dense_map(atomic_dense_map&&) = default;
+      atomic_dense_map& operator=(atomic_dense_map&&) = default;
+
+      std::size_t size() const { return size_; }
+      T default_value() const { return default_; }
+
+      // Element access
+      std::atomic<T>& operator[](K k)
+      {
+        assert(std::size_t(k) < size_);
+        return data_[k];
+      }
+
+      const std::atomic<T>& operator[](K k) const
+      {
+        assert(std::size_t(k) < size_);
+        return data_[k];
+      }
+
+      std::atomic<T>*       data()       { return data_.get(); }
+      const std::atomic<T>* data() const { return data_.get(); }
+
+      // Atomic operations. Loads and stores are relaxed by default, since
+      // threads usually synchronize at the end of a phase.
+      T load(K k, std::memory_order m = std::memory_order_relaxed) const
+      {
+        return (*this)[k].load(m);
+      }
+
+      void store(K k, T x, std::memory_order m = std::memory_order_relaxed)
+      {
+        (*this)[k].store(x, m);
+      }
+
+      T fetch_add(K k, T x) { return (*this)[k].fetch_add(x); }
+
+      bool compare_exchange(K k, T& expected, T desired)
+      {
+        return (*this)[k].compare_exchange_strong(expected, desired);
+      }
+
+      // Replace the value of k with x if x is less or greater. Returns the
+      // previous value.
+      T fetch_min(K k, T x);
+      T fetch_max(K k, T x);
+
+      // Resize the map to n keys, keeping the values of existing keys. New
+      // keys are mapped to the default value. This must not be called
+      // concurrently with any other operation.
+      void resize(std::size_t n);
+
+      // Map every key to x. This must not be called concurrently with any
+      // other operation.
+      void fill(T x);
+
+    private:
+      std::unique_ptr<std::atomic<T>[]> data_;
+      std::size_t size_;
+      T default_;
+    };
+
+  template<typename K, typename T>
+    T
+    atomic_dense_map<K, T>::fetch_min(K k, T x)
+    {
+      std::atomic<T>& a = (*this)[k];
+      T y = a.load(std::memory_order_relaxed);
+      while (x < y && !a.compare_exchange_weak(y, x))
+        ;
+      return y;
+    }
+
+  template<typename K, typename T>
+    T
+    atomic_dense_map<K, T>::fetch_max(K k, T x)
+    {
+      std::atomic<T>& a = (*this)[k];
+      T y = a.load(std::memory_order_relaxed);
+      while (y < x && !a.compare_exchange_weak(y, x))
+        ;
+      return y;
+    }
+
+  template<typename K, typename T>
+    void
+    atomic_dense_map<K, T>::resize(std::size_t n)
+    {
+      if (n == size_)
+        return;
+      std::unique_ptr<std::atomic<T>[]> p(new std::atomic<T>[n]);
+      std::size_t m = std::min(n, size_);
+      for (std::size_t i = 0; i < m; ++i)
+        p[i].store(data_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      for (std::size_t i = m; i < n; ++i)
+        p[i].store(default_, std::memory_order_relaxed);
+      data_ = std::move(p);
+      size_ = n;
+    }
+
+  template<typename K, typename T>
+    void
+    atomic_dense_map<K, T>::fill(T x)
+    {
+      for (std::size_t i = 0; i < size_; ++i)
+        data_[i].store(x, std::memory_order_relaxed);
+    }
+
+
+  // Maps from the vertices and edges of the graph G to values of type T.
+  template<typename G, typename T>
+    using vertex_map = dense_map<Vertex<G>, T>;
+
+  template<typename G, typename T>
+    using edge_map = dense_map<Edge<G>, T>;
+
+  template<typename G, typename T>
+    using atomic_vertex_map = atomic_dense_map<Vertex<G>, T>;
+
+  template<typename G, typename T>
+    using atomic_edge_map = atomic_dense_map<Edge<G>, T>;
+
+  // Returns a map from the vertices of g to values of type T, each mapped to
+  // x.
+  template<typename T, typename G>
+    inline vertex_map<G, T>
+    make_vertex_map(const G& g, const T& x = T())
+    {
+      return vertex_map<G, T>(vertex_bound(g), x);
+    }
+
+  // Returns a map from the edges of g to values of type T, each mapped to x.
+  template<typename T, typename G>
+    inline edge_map<G, T>
+    make_edge_map(const G& g, const T& x = T())
+    {
+      return edge_map<G, T>(edge_bound(g), x);
+    }
+
+  template<typename T, typename G>
+    inline atomic_vertex_map<G, T>
+    make_atomic_vertex_map(const G& g, T x = T())
+    {
+      return atomic_vertex_map<G, T>(vertex_bound(g), x);
+    }
+
+  template<typename T, typename G>
+    inline atomic_edge_map<G, T>
+    make_atomic_edge_map(const G& g, T x = T())
+    {
+      return atomic_edge_map<G, T>(edge_bound(g), x);
+    }
+
+} // namespace origin
+
+#endif
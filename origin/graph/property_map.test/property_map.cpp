@@ -0,0 +1,157 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/breadth_first.hpp>
+#include <origin/graph/parallel.hpp>
+#include <origin/graph/property_map.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+constexpr size_t npos = -1;
+
+// Maps cover removed vertices and grow with the graph.
+template<typename G>
+  void
+  check_vertex_map()
+  {
+    cout << "*** vertex map (" << typestr<G>() << ") ***\n";
+    using V = Vertex<G>;
+    G g = build_n_graph<G>(5);
+    g.remove_vertex(V(2));
+    auto color = make_vertex_map<int>(g, -1);
+    assert(color.size() == vertex_bound(g) && color.size() == 5);
+    for (auto v : g.vertices())
+      color[v] = v;
+    assert(color[V(2)] == -1 && color[V(4)] == 4);
+
+    // Vertices added later read the default value, and are written by
+    // growing the map.
+    const auto& c = color;
+    V u = g.add_vertex('x');
+    V w = g.add_vertex('y');
+    assert(c[w] == -1 && c.size() == 5);
+    color[w] = 9;
+    assert(color.size() == size_t(w) + 1 && color[w] == 9 && color[u] == -1);
+
+    color.fill(0);
+    assert(color[V(0)] == 0 && color.default_value() == -1);
+    color.resize(2);
+    color.resize(4);
+    assert(color[V(1)] == 0 && color[V(3)] == -1);
+  }
+
+template<typename G>
+  void
+  check_edge_map()
+  {
+    cout << "*** edge map (" << typestr<G>() << ") ***\n";
+    G g = build_n_graph<G>(4);
+    for (int i = 0; i < 4; ++i)
+      g.add_edge(Vertex<G>(i), Vertex<G>((i + 1) % 4));
+    auto weight = make_edge_map<double>(g);
+    assert(weight.size() == edge_bound(g));
+    for (auto e : g.edges())
+      weight[e] = 0.5 * size_t(g.source(e));
+    double sum = 0;
+    for (auto e : g.edges())
+      sum += weight[e];
+    assert(sum == 3.0);
+    auto e = g.add_edge(Vertex<G>(0), Vertex<G>(2));
+    weight[e] = 10;
+    assert(weight.size() == edge_bound(g) && weight[e] == 10);
+  }
+
+// Atomic maps are updated by a team of threads.
+void
+check_atomic_map()
+{
+  cout << "*** atomic vertex map ***\n";
+  using G = directed_adjacency_vector<char>;
+  minstd_rand gen;
+  vector<tuple<size_t, size_t>> es;
+  size_t n = 1000;
+  for (size_t i = 0; i < 20000; ++i)
+    es.emplace_back(gen() % n, gen() % n);
+  G g(n, es);
+
+  // Count in degrees and the least source of each vertex concurrently.
+  auto degree = make_atomic_vertex_map<size_t>(g);
+  auto least = make_atomic_vertex_map<size_t>(g, npos);
+  auto most = make_atomic_vertex_map<size_t>(g, 0);
+  parallel_impl::parallel_for(4, n, 16, [&](size_t, size_t i, size_t j) {
+    for (; i < j; ++i) {
+      for (auto e : g.out_edges(Vertex<G>(i))) {
+        degree.fetch_add(g.target(e), 1);
+        least.fetch_min(g.target(e), i);
+        most.fetch_max(g.target(e), i);
+      }
+    }
+  });
+  vector<size_t> d(n, 0), l(n, npos), m(n, 0);
+  for (auto& x : es) {
+    size_t u = get<0>(x), v = get<1>(x);
+    ++d[v];
+    l[v] = min(l[v], u);
+    m[v] = max(m[v], u);
+  }
+  for (size_t v = 0; v < n; ++v) {
+    Vertex<G> x(v);
+    assert(degree.load(x) == d[v] && least.load(x) == l[v] && most.load(x) == m[v]);
+  }
+
+  // Compare and exchange.
+  size_t expect = d[0];
+  assert(degree.compare_exchange(Vertex<G>(0), expect, 7));
+  assert(!degree.compare_exchange(Vertex<G>(0), expect, 8) && expect == 7);
+
+  // Growing keeps existing values.
+  degree.resize(n + 10);
+  assert(degree.size() == n + 10 && degree.load(Vertex<G>(0)) == 7);
+  assert(degree[Vertex<G>(n + 9)] == 0);
+  degree.fill(3);
+  degree.store(Vertex<G>(1), 4);
+  assert(degree.load(Vertex<G>(1)) == 4 && degree.load(Vertex<G>(2)) == 3);
+}
+
+// Maps can be given to algorithms that take arrays indexed by handle.
+void
+check_algorithm()
+{
+  cout << "*** property map algorithms ***\n";
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_n_graph<G>(6);
+  for (int i = 0; i + 1 < 6; ++i)
+    g.add_edge(Vertex<G>(i), Vertex<G>(i + 1));
+  auto dist = make_vertex_map<size_t>(g);
+  auto parent = make_vertex_map<Vertex<G>>(g);
+  assert(breadth_first_search(g, Vertex<G>(0), dist.data(), parent.data(), 2) == 6);
+  for (auto v : g.vertices())
+    assert(dist[v] == size_t(v));
+  assert(parent[Vertex<G>(5)] == Vertex<G>(4));
+}
+
+int main()
+{
+  check_vertex_map<directed_adjacency_list<char, int>>();
+  check_vertex_map<undirected_adjacency_list<char, int>>();
+  check_edge_map<directed_adjacency_list<char, int>>();
+  check_edge_map<directed_adjacency_vector<char, int>>();
+  check_atomic_map();
+  check_algorithm();
+}
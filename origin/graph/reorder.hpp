@@ -0,0 +1,378 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_REORDER_HPP
+#define ORIGIN_GRAPH_REORDER_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/neighbors.hpp>
+#include <origin/graph/adjacency_list.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                           [graph.reorder]
+  //                            Vertex Reordering
+  //
+  // The handles of a graph are the order in which its vertices were added,
+  // which for crawled or generated graphs scatters the neighbors of each
+  // vertex across memory. Reordering renumbers the vertices so that
+  // neighbors have nearby handles, and rebuilds the graph in that order, so
+  // that traversals touch fewer cache lines.
+  //
+  // An ordering is a sequence of the vertices of a graph, in which the
+  // vertex at position i is given the handle i. The orderings are:
+  //
+  //    degree_order                  by decreasing degree
+  //    breadth_first_order           in order of a breadth-first search
+  //    cuthill_mckee_order           in Cuthill-McKee order
+  //    reverse_cuthill_mckee_order   in reverse Cuthill-McKee order
+  //
+  // Ties are broken by handle. The searches follow the edges of a directed
+  // graph in both directions, and start a new search in each component.
+  // The breadth-first order starts each component at its vertex of greatest
+  // degree, which groups hubs with their neighborhoods. The Cuthill-McKee
+  // order starts each component at a pseudo-peripheral vertex, found by the
+  // method of George and Liu, and visits the neighbors of each vertex by
+  // increasing degree. Reversing it gives an order with the same bandwidth
+  // and usually less fill, and is the usual choice.
+  //
+  // reorder(g, order) rebuilds g with the given vertex order. The edges are
+  // renumbered in the order of their sources, or for an undirected graph of
+  // their first endpoint in the new order, so the edges of each vertex are
+  // also adjacent. Graphs with a bulk constructor are rebuilt by it. The
+  // result maps the old handles to the new, as compact() does, so that
+  // external property arrays can be moved to the new handles by permute().
+
+  namespace reorder_impl
+  {
+    constexpr std::size_t npos = -1;
+
+    // Call f with each neighbor of v, following the edges of a directed
+    // graph in both directions.
+    template<typename G, typename F>
+      inline void
+      for_adjacent(const G& g, Vertex<G> v, F f)
+      {
+        using namespace neighbors_impl;
+        for (auto e : neighbor_edges(g, v))
+          f(neighbor(g, e, v));
+        if (Directed_graph<G>())
+          for (auto e : reverse_edges(g, v))
+            f(reverse_neighbor(g, e, v));
+      }
+
+    // Returns the vertices of g sorted by degree, increasing or decreasing,
+    // and then by handle. This is a counting sort.
+    template<typename G>
+      std::vector<Vertex<G>>
+      sort_by_degree(const G& g, bool decreasing)
+      {
+        std::size_t max = 0;
+        for (auto v : g.vertices())
+          max = std::max(max, g.degree(v));
+        auto key = [&](Vertex<G> v) {
+          return decreasing ? max - g.degree(v) : g.degree(v);
+        };
+        std::vector<std::size_t> first(max + 2, 0);
+        for (auto v : g.vertices())
+          ++first[key(v) + 1];
+        for (std::size_t i = 1; i < first.size(); ++i)
+          first[i] += first[i - 1];
+        std::vector<Vertex<G>> order(g.order());
+        for (auto v : g.vertices())
+          order[first[key(v)]++] = v;
+        return order;
+      }
+
+    // The level structure of a breadth-first search, used to find a
+    // pseudo-peripheral vertex. Marks are compared with a stamp, so that
+    // the mark array is not cleared between searches.
+    template<typename G>
+      struct level_search
+      {
+        level_search(const G& g)
+          : graph(g), mark(g.vertex_bound(), 0), stamp(0)
+        { }
+
+        // Search the vertices reachable from s that are not yet placed.
+        // Returns the eccentricity of s, and leaves the last level in
+        // [last, queue.end()).
+        std::size_t search(Vertex<G> s, const std::vector<bool>& placed)
+        {
+          ++stamp;
+          queue.clear();
+          queue.push_back(s);
+          mark[s] = stamp;
+          std::size_t depth = 0;
+          std::size_t head = 0;
+          last = 0;
+          while (head < queue.size()) {
+            last = head;
+            std::size_t end = queue.size();
+            for (; head < end; ++head) {
+              Vertex<G> v = queue[head];
+              for_adjacent(graph, v, [&](Vertex<G> w) {
+                if (mark[w] != stamp && !placed[w]) {
+                  mark[w] = stamp;
+                  queue.push_back(w);
+                }
+              });
+            }
+            if (queue.size() > end)
+              ++depth;
+          }
+          return depth;
+        }
+
+        const G& graph;
+        std::vector<std::size_t> mark;
+        std::size_t stamp;
+        std::vector<Vertex<G>> queue;
+        std::size_t last;
+      };
+
+    // Returns a pseudo-peripheral vertex of the component of s: a vertex
+    // of least degree in the last level of a search is searched from in
+    // turn, while that increases the eccentricity.
+    template<typename G>
+      Vertex<G>
+      pseudo_peripheral(const G& g, Vertex<G> s, level_search<G>& ls,
+                        const std::vector<bool>& placed)
+      {
+        std::size_t ecc = ls.search(s, placed);
+        while (true) {
+          Vertex<G> c = ls.queue[ls.last];
+          for (std::size_t i = ls.last + 1; i < ls.queue.size(); ++i)
+            if (g.degree(ls.queue[i]) < g.degree(c))
+              c = ls.queue[i];
+          std::size_t e = ls.search(c, placed);
+          if (e <= ecc)
+            return s;
+          s = c;
+          ecc = e;
+        }
+      }
+
+    // Return the graph h with the vertices of g in the given order and its
+    // edges es, in order, writing the new handle of each edge to em. Graphs
+    // with a bulk constructor are built by it.
+    template<typename G, typename M>
+      auto
+      rebuild(const G& g, const std::vector<Vertex<G>>& order, const M& vm,
+              const std::vector<Edge<G>>& es,
+              std::vector<basic_edge_handle<typename Edge<G>::index_type>>& em,
+              int)
+        -> decltype(std::declval<G&>().assign_edges(
+                      std::vector<std::tuple<std::size_t, std::size_t,
+                                             Decay<decltype(g(es[0]))>>>()), G())
+      {
+        using T = std::tuple<std::size_t, std::size_t, Decay<decltype(g(es[0]))>>;
+        std::vector<T> ts;
+        ts.reserve(es.size());
+        for (std::size_t i = 0; i < es.size(); ++i) {
+          Edge<G> e = es[i];
+          ts.emplace_back(vm[g.source(e)], vm[g.target(e)], g(e));
+          em[e] = i;
+        }
+        G h(order.size(), ts);
+        for (std::size_t i = 0; i < order.size(); ++i)
+          h(Vertex<G>(i)) = g(order[i]);
+        return h;
+      }
+
+    template<typename G, typename M>
+      G
+      rebuild(const G& g, const std::vector<Vertex<G>>& order, const M& vm,
+              const std::vector<Edge<G>>& es,
+              std::vector<basic_edge_handle<typename Edge<G>::index_type>>& em,
+              long)
+      {
+        G h;
+        for (Vertex<G> v : order)
+          h.add_vertex(g(v));
+        for (Edge<G> e : es)
+          em[e] = h.add_edge(vm[g.source(e)], vm[g.target(e)], g(e));
+        return h;
+      }
+
+    // Sort the incidence lists of h if those of g were sorted.
+    template<typename G>
+      inline auto
+      restore_sorted(const G& g, G& h, int) -> decltype(h.sort_adjacency())
+      {
+        if (g.sorted() && !h.sorted())
+          h.sort_adjacency();
+      }
+
+    template<typename G>
+      inline void
+      restore_sorted(const G&, G&, long) { }
+
+  } // namespace reorder_impl
+
+
+  // Returns the vertices of g by decreasing degree.
+  template<typename G>
+    inline std::vector<Vertex<G>>
+    degree_order(const G& g)
+    {
+      return reorder_impl::sort_by_degree(g, true);
+    }
+
+  // Returns the vertices of g in the order they are reached by breadth-first
+  // searches, each started at the unreached vertex of greatest degree.
+  template<typename G>
+    std::vector<Vertex<G>>
+    breadth_first_order(const G& g)
+    {
+      std::vector<Vertex<G>> order;
+      order.reserve(g.order());
+      std::vector<bool> reached(g.vertex_bound(), false);
+      for (Vertex<G> s : reorder_impl::sort_by_degree(g, true)) {
+        if (reached[s])
+          continue;
+        std::size_t head = order.size();
+        order.push_back(s);
+        reached[s] = true;
+        for (; head < order.size(); ++head) {
+          reorder_impl::for_adjacent(g, order[head], [&](Vertex<G> w) {
+            if (!reached[w]) {
+              reached[w] = true;
+              order.push_back(w);
+            }
+          });
+        }
+      }
+      return order;
+    }
+
+  // Returns the vertices of g in Cuthill-McKee order.
+  template<typename G>
+    std::vector<Vertex<G>>
+    cuthill_mckee_order(const G& g)
+    {
+      using namespace reorder_impl;
+      std::vector<Vertex<G>> order;
+      order.reserve(g.order());
+      std::vector<bool> placed(g.vertex_bound(), false);
+      std::vector<Vertex<G>> next;
+      level_search<G> ls(g);
+      auto by_degree = [&g](Vertex<G> a, Vertex<G> b) {
+        return g.degree(a) < g.degree(b) || (g.degree(a) == g.degree(b) && a < b);
+      };
+      for (Vertex<G> v : sort_by_degree(g, false)) {
+        if (placed[v])
+          continue;
+        Vertex<G> s = pseudo_peripheral(g, v, ls, placed);
+        std::size_t head = order.size();
+        order.push_back(s);
+        placed[s] = true;
+        for (; head < order.size(); ++head) {
+          next.clear();
+          for_adjacent(g, order[head], [&](Vertex<G> w) {
+            if (!placed[w]) {
+              placed[w] = true;
+              next.push_back(w);
+            }
+          });
+          std::sort(next.begin(), next.end(), by_degree);
+          order.insert(order.end(), next.begin(), next.end());
+        }
+      }
+      return order;
+    }
+
+  // Returns the vertices of g in reverse Cuthill-McKee order.
+  template<typename G>
+    inline std::vector<Vertex<G>>
+    reverse_cuthill_mckee_order(const G& g)
+    {
+      std::vector<Vertex<G>> order = cuthill_mckee_order(g);
+      std::reverse(order.begin(), order.end());
+      return order;
+    }
+
+  // Returns the bandwidth of g: the greatest difference between the handles
+  // of the endpoints of an edge.
+  template<typename G>
+    std::size_t
+    bandwidth(const G& g)
+    {
+      std::size_t b = 0;
+      for (auto e : g.edges()) {
+        std::size_t u = g.source(e);
+        std::size_t v = g.target(e);
+        b = std::max(b, u < v ? v - u : u - v);
+      }
+      return b;
+    }
+
+  // Rebuild g so that the vertex order[i] has the handle i. The ordering
+  // must contain every vertex of g once. Returns the map from the old
+  // handles to the new.
+  template<typename G>
+    basic_handle_map<typename Vertex<G>::index_type>
+    reorder(G& g, const std::vector<Vertex<G>>& order)
+    {
+      using I = typename Vertex<G>::index_type;
+      assert(order.size() == g.order());
+      std::vector<basic_vertex_handle<I>> vm(g.vertex_bound());
+      for (std::size_t i = 0; i < order.size(); ++i) {
+        assert(!vm[order[i]]);
+        vm[order[i]] = i;
+      }
+
+      std::vector<Edge<G>> es;
+      es.reserve(g.size());
+      std::vector<bool> taken(g.edge_bound(), false);
+      for (Vertex<G> v : order) {
+        for (auto e : neighbors_impl::neighbor_edges(g, v)) {
+          if (!taken[e]) {
+            taken[e] = true;
+            es.push_back(e);
+          }
+        }
+      }
+      assert(es.size() == g.size());
+
+      std::vector<basic_edge_handle<I>> em(g.edge_bound());
+      G h = reorder_impl::rebuild(g, order, vm, es, em, 0);
+      reorder_impl::restore_sorted(g, h, 0);
+      g = std::move(h);
+      return {std::move(vm), std::move(em)};
+    }
+
+  // Returns the values x, indexed by old handles, moved to the new handles
+  // given by the map m. Values of handles mapped to invalid handles are
+  // dropped.
+  template<typename H, typename T>
+    std::vector<T>
+    permute(const std::vector<H>& m, const std::vector<T>& x)
+    {
+      assert(m.size() <= x.size());
+      std::size_t n = 0;
+      for (H h : m)
+        if (h)
+          n = std::max(n, std::size_t(h) + 1);
+      std::vector<T> y(n);
+      for (std::size_t i = 0; i < m.size(); ++i)
+        if (m[i])
+          y[m[i]] = x[i];
+      return y;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,205 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/breadth_first.hpp>
+#include <origin/graph/reorder.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+using edge_tuple = tuple<size_t, size_t, int>;
+
+// Returns the edges of a w by h grid, over vertices numbered by p.
+vector<edge_tuple>
+grid_edges(size_t w, size_t h, const vector<size_t>& p)
+{
+  vector<edge_tuple> es;
+  for (size_t i = 0; i < h; ++i) {
+    for (size_t j = 0; j < w; ++j) {
+      size_t v = i * w + j;
+      if (j + 1 < w)
+        es.emplace_back(p[v], p[v + 1], v);
+      if (i + 1 < h)
+        es.emplace_back(p[v], p[v + w], v);
+    }
+  }
+  return es;
+}
+
+// Returns true if order holds every vertex of g once.
+template<typename G>
+  bool
+  is_ordering(const G& g, const vector<Vertex<G>>& order)
+  {
+    vector<bool> seen(g.vertex_bound(), false);
+    for (auto v : order) {
+      if (seen[v])
+        return false;
+      seen[v] = true;
+    }
+    return order.size() == g.order();
+  }
+
+// Check the orderings of a graph.
+template<typename G>
+  void
+  check_orderings(const G& g)
+  {
+    auto d = degree_order(g);
+    assert(is_ordering(g, d));
+    for (size_t i = 1; i < d.size(); ++i)
+      assert(g.degree(d[i - 1]) > g.degree(d[i]) ||
+             (g.degree(d[i - 1]) == g.degree(d[i]) && d[i - 1] < d[i]));
+    assert(is_ordering(g, breadth_first_order(g)));
+    auto cm = cuthill_mckee_order(g);
+    auto rcm = reverse_cuthill_mckee_order(g);
+    assert(is_ordering(g, cm));
+    reverse(cm.begin(), cm.end());
+    assert(cm == rcm);
+  }
+
+// Reorder a copy of g in each order, and check that the result is g with
+// its vertices and edges renumbered by the handle map.
+template<typename G>
+  void
+  check_reorder(const G& g)
+  {
+    cout << "*** reorder (" << typestr<G>() << ") ***\n";
+    check_orderings(g);
+    for (int k = 0; k < 4; ++k) {
+      vector<Vertex<G>> order;
+      switch (k) {
+      case 0: order = degree_order(g); break;
+      case 1: order = breadth_first_order(g); break;
+      case 2: order = cuthill_mckee_order(g); break;
+      default: order = reverse_cuthill_mckee_order(g); break;
+      }
+      G h = g;
+      auto m = reorder(h, order);
+      assert(h.order() == g.order() && h.size() == g.size());
+      assert(h.vertex_bound() == g.order() && h.edge_bound() == g.size());
+      assert(m.vertices.size() == g.vertex_bound() && m.edges.size() == g.edge_bound());
+      for (size_t i = 0; i < order.size(); ++i)
+        assert(m.vertices[order[i]] == Vertex<G>(i));
+      for (auto v : g.vertices())
+        assert(h(m.vertices[v]) == g(v));
+      for (auto e : g.edges()) {
+        Edge<G> x = m.edges[e];
+        assert(h.source(x) == m.vertices[g.source(e)]);
+        assert(h.target(x) == m.vertices[g.target(e)]);
+        assert(h(x) == g(e));
+      }
+      assert(h.sorted() || !g.sorted());
+
+      // Searches reach the same vertices at the same distances.
+      vector<size_t> d1(g.vertex_bound()), d2(h.vertex_bound());
+      vector<Vertex<G>> p1(g.vertex_bound()), p2(h.vertex_bound());
+      Vertex<G> s = *g.vertices().begin();
+      breadth_first_search(g, s, d1.data(), p1.data(), 1);
+      breadth_first_search(h, m.vertices[s], d2.data(), p2.data(), 1);
+      for (auto v : g.vertices())
+        assert(d1[v] == d2[m.vertices[v]]);
+    }
+  }
+
+template<typename G>
+  G
+  random_vector(size_t n, size_t m)
+  {
+    minstd_rand gen;
+    vector<edge_tuple> es;
+    for (size_t i = 0; i < m; ++i)
+      es.emplace_back(gen() % n, gen() % n, int(i));
+    G g(n, es);
+    for (auto v : g.vertices())
+      g(v) = 'a' + v % 26;
+    return g;
+  }
+
+// Reverse Cuthill-McKee recovers a narrow band from shuffled paths and
+// grids.
+void
+check_bandwidth()
+{
+  cout << "*** reverse cuthill-mckee bandwidth ***\n";
+  using G = undirected_adjacency_vector<char, int>;
+  minstd_rand gen;
+  size_t w = 20, h = 30, n = w * h;
+  vector<size_t> p(n);
+  for (size_t i = 0; i < n; ++i)
+    p[i] = i;
+  shuffle(p.begin(), p.end(), gen);
+
+  G grid(n, grid_edges(w, h, p));
+  assert(bandwidth(grid) > n / 2);
+  reorder(grid, reverse_cuthill_mckee_order(grid));
+  assert(bandwidth(grid) <= w + 1);
+
+  G path(n, grid_edges(n, 1, p));
+  reorder(path, reverse_cuthill_mckee_order(path));
+  assert(bandwidth(path) == 1);
+
+  // A directed path is searched in both directions.
+  using D = directed_adjacency_vector<char, int>;
+  D dpath(n, grid_edges(n, 1, p));
+  reorder(dpath, cuthill_mckee_order(dpath));
+  assert(bandwidth(dpath) == 1);
+}
+
+// Graphs with removed vertices and several components.
+void
+check_removed()
+{
+  cout << "*** reorder removed vertices ***\n";
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_random_graph<G>(50, 40);
+  g.remove_vertex(Vertex<G>(7));
+  g.remove_vertex(Vertex<G>(31));
+  g.remove_edge(*g.edges().begin());
+  check_reorder(g);
+
+  G h = g;
+  auto m = reorder(h, degree_order(h));
+  assert(!m.vertices[7] && !m.vertices[31]);
+  vector<int> x(g.vertex_bound());
+  for (auto v : g.vertices())
+    x[v] = g(v);
+  vector<int> y = permute(m.vertices, x);
+  assert(y.size() == h.order());
+  for (auto v : h.vertices())
+    assert(y[v] == h(v));
+}
+
+int main()
+{
+  check_bandwidth();
+  check_removed();
+
+  check_reorder(build_random_graph<directed_adjacency_list<char, int>>(300, 1200));
+  check_reorder(build_random_graph<undirected_adjacency_list<char, int>>(300, 1200));
+  check_reorder(build_random_graph<directed_adjacency_list<char, int, hashed_adjacency_list_traits>>(100, 2000));
+
+  auto s = build_random_graph<undirected_adjacency_list<char, int>>(200, 800);
+  s.sort_adjacency();
+  check_reorder(s);
+
+  check_reorder(random_vector<directed_adjacency_vector<char, int>>(300, 1200));
+  check_reorder(random_vector<undirected_adjacency_vector<char, int>>(300, 1200));
+  check_reorder(random_vector<directed_adjacency_vector<char, int, sorted_adjacency_vector_traits>>(200, 900));
+}
@@ -0,0 +1,525 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_SHORTEST_PATHS_HPP
+#define ORIGIN_GRAPH_SHORTEST_PATHS_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/neighbors.hpp>
+#include <origin/graph/parallel.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                    [graph.shortest_paths]
+  //                      Single-Source Shortest Paths
+  //
+  // The shortest path algorithms compute the distance of every vertex from a
+  // source vertex, and a predecessor of each reached vertex on a shortest
+  // path from the source. The length of an edge e is given by a weight
+  // function applied to its value, w(g(e)), so that graphs whose edge values
+  // are weights need no weight function, and graphs whose edge values are
+  // records project their weights. Weights must be nonnegative.
+  //
+  // The distances and predecessors are written to caller-provided arrays
+  // indexed by vertex handle. The distance of an unreached vertex is
+  // infinite_distance<D>(), and its predecessor is invalid. The predecessor
+  // of the source is the source itself.
+  //
+  // Dijkstra's algorithm settles the vertices in order of distance, using a
+  // 4-ary indexed heap with decrease-key. The Dijkstra engine keeps its heap,
+  // distances, and predecessors between searches, and records the vertices
+  // each search touches. A search resets only the vertices touched by the
+  // previous one, and can stop when a target vertex is settled, so a
+  // point-to-point query costs time in the part of the graph it explores
+  // rather than in the order of the graph. Engines share nothing but the
+  // graph, so a batch of queries can be run by one engine per thread.
+  //
+  // Delta-stepping relaxes vertices in buckets of distance width delta,
+  // using a team of threads to relax the edges of each bucket. Distances
+  // are updated by compare and swap. Predecessors are found after the
+  // distances are final, by searching the edges entering each vertex for
+  // one whose source is nearer, at the right distance. Vertices reached
+  // only through edges of weight 0 have no such edge; they are attached
+  // afterward by following those edges forward, so that the predecessors
+  // form a tree.
+
+  // Returns the distance of an unreached vertex.
+  template<typename D>
+    constexpr D
+    infinite_distance()
+    {
+      return std::numeric_limits<D>::has_infinity
+        ? std::numeric_limits<D>::infinity()
+        : std::numeric_limits<D>::max();
+    }
+
+  namespace shortest_paths_impl
+  {
+    constexpr std::size_t npos = -1;
+
+    // The number of vertices claimed by a thread at a time.
+    constexpr std::size_t chunk = 64;
+
+    // The default weight function returns the edge value.
+    struct value_weight
+    {
+      template<typename T>
+        const T& operator()(const T& x) const { return x; }
+    };
+
+    // ---------------------------------------------------------------------- //
+    //                              Indexed Heap
+    //
+    // A 4-ary min-heap of indexes ordered by their keys in an external array.
+    // The position of each index in the heap is recorded, so that the key of
+    // an index in the heap can be decreased. The positions are reset as
+    // indexes leave the heap, so an empty heap can be reused without
+    // clearing its position table.
+    template<typename K>
+      class indexed_heap
+      {
+        static constexpr std::size_t arity = 4;
+
+      public:
+        indexed_heap() : key_(nullptr) { }
+
+        // Order the heap by the keys in key, for indexes less than n.
+        void reset(const K* key, std::size_t n)
+        {
+          assert(heap_.empty());
+          key_ = key;
+          if (pos_.size() < n)
+            pos_.resize(n, npos);
+        }
+
+        bool empty() const { return heap_.empty(); }
+
+        std::size_t top() const { return heap_.front(); }
+
+        // Insert i, or restore the order of the heap after its key has been
+        // decreased.
+        void update(std::size_t i)
+        {
+          if (pos_[i] == npos) {
+            pos_[i] = heap_.size();
+            heap_.push_back(i);
+          }
+          up(pos_[i]);
+        }
+
+        void pop();
+        void clear();
+
+      private:
+        void up(std::size_t n);
+        void down(std::size_t n);
+
+        void place(std::size_t n, std::size_t i)
+        {
+          heap_[n] = i;
+          pos_[i] = n;
+        }
+
+        const K* key_;
+        std::vector<std::size_t> heap_; // The heap of indexes
+        std::vector<std::size_t> pos_;  // The position of each index
+      };
+
+    template<typename K>
+      void
+      indexed_heap<K>::pop()
+      {
+        pos_[heap_.front()] = npos;
+        std::size_t last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) {
+          place(0, last);
+          down(0);
+        }
+      }
+
+    template<typename K>
+      void
+      indexed_heap<K>::clear()
+      {
+        for (std::size_t i : heap_)
+          pos_[i] = npos;
+        heap_.clear();
+      }
+
+    template<typename K>
+      void
+      indexed_heap<K>::up(std::size_t n)
+      {
+        std::size_t i = heap_[n];
+        while (n > 0) {
+          std::size_t p = (n - 1) / arity;
+          if (!(key_[i] < key_[heap_[p]]))
+            break;
+          place(n, heap_[p]);
+          n = p;
+        }
+        place(n, i);
+      }
+
+    template<typename K>
+      void
+      indexed_heap<K>::down(std::size_t n)
+      {
+        std::size_t i = heap_[n];
+        std::size_t size = heap_.size();
+        while (true) {
+          std::size_t first = n * arity + 1;
+          if (first >= size)
+            break;
+          std::size_t last = std::min(size, first + arity);
+          std::size_t c = first;
+          for (std::size_t j = first + 1; j < last; ++j)
+            if (key_[heap_[j]] < key_[heap_[c]])
+              c = j;
+          if (!(key_[heap_[c]] < key_[i]))
+            break;
+          place(n, heap_[c]);
+          n = c;
+        }
+        place(n, i);
+      }
+
+    // The distances of delta-stepping are shared by the threads of a team,
+    // so they are accessed through the atomic builtins.
+    template<typename D>
+      inline D
+      load(const D* p)
+      {
+        D x;
+        __atomic_load(p, &x, __ATOMIC_RELAXED);
+        return x;
+      }
+
+    // Lower the value of *p to x, returning true if it was greater.
+    template<typename D>
+      inline bool
+      lower(D* p, D x)
+      {
+        D y = load(p);
+        while (x < y)
+          if (__atomic_compare_exchange(p, &y, &x, false,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return true;
+        return false;
+      }
+
+  } // namespace shortest_paths_impl
+
+
+  // The distance type of the graph G with weight function W, which is the
+  // type of the weight of an edge.
+  template<typename G, typename W = shortest_paths_impl::value_weight>
+    using Distance_type =
+      Decay<decltype(std::declval<W>()(std::declval<const G&>()(std::declval<Edge<G>>())))>;
+
+
+  // The Dijkstra engine for the graph type G and the weight function W.
+  template<typename G, typename W = shortest_paths_impl::value_weight>
+    class dijkstra_engine
+    {
+    public:
+      using vertex = Vertex<G>;
+      using distance_type = Distance_type<G, W>;
+
+      explicit dijkstra_engine(const G& g, W w = W()) : g_(g), w_(w) { }
+
+      // Search from s. If target is valid, the search stops when the target
+      // is settled. Returns the number of settled vertices.
+      std::size_t search(vertex s, vertex target = vertex());
+
+      // Search from s as above, then write the distance of every vertex to
+      // dist and, unless it is null, the predecessor of every vertex to
+      // pred. Filling the arrays takes O(V) time.
+      std::size_t search(vertex s, distance_type* dist, vertex* pred,
+                         vertex target = vertex());
+
+      // The distance and predecessor of v found by the last search. They
+      // are final for settled vertices. A vertex touched but not settled
+      // before the search stopped has an upper bound of its distance, and
+      // any other vertex has an infinite distance and no predecessor.
+      distance_type distance(vertex v) const;
+      vertex predecessor(vertex v) const;
+
+    private:
+      const G& g_;
+      W w_;
+      shortest_paths_impl::indexed_heap<distance_type> heap_;
+      std::vector<distance_type> dist_;
+      std::vector<vertex> pred_;
+      std::vector<vertex> touched_; // The vertices reached by the last search
+    };
+
+  template<typename G, typename W>
+    std::size_t
+    dijkstra_engine<G, W>::search(vertex s, vertex target)
+    {
+      using D = distance_type;
+      using namespace neighbors_impl;
+      for (vertex v : touched_) {
+        dist_[v] = infinite_distance<D>();
+        pred_[v] = vertex();
+      }
+      touched_.clear();
+      std::size_t n = vertex_bound(g_);
+      if (dist_.size() < n) {
+        dist_.resize(n, infinite_distance<D>());
+        pred_.resize(n);
+      }
+
+      heap_.reset(dist_.data(), n);
+      dist_[s] = D(0);
+      pred_[s] = s;
+      touched_.push_back(s);
+      heap_.update(s);
+
+      std::size_t settled = 0;
+      while (!heap_.empty()) {
+        vertex u = heap_.top();
+        heap_.pop();
+        ++settled;
+        if (u == target)
+          break;
+        D du = dist_[u];
+        for (auto e : neighbor_edges(g_, u)) {
+          vertex v = neighbor(g_, e, u);
+          D d = du + w_(g_(e));
+          if (d < dist_[v]) {
+            if (!pred_[v])
+              touched_.push_back(v);
+            dist_[v] = d;
+            pred_[v] = u;
+            heap_.update(v);
+          }
+        }
+      }
+      heap_.clear();
+      return settled;
+    }
+
+  template<typename G, typename W>
+    std::size_t
+    dijkstra_engine<G, W>::search(vertex s, distance_type* dist, vertex* pred,
+                                  vertex target)
+    {
+      std::size_t settled = search(s, target);
+      std::size_t n = vertex_bound(g_);
+      std::fill(dist, dist + n, infinite_distance<distance_type>());
+      if (pred)
+        std::fill(pred, pred + n, vertex());
+      for (vertex v : touched_) {
+        dist[v] = dist_[v];
+        if (pred)
+          pred[v] = pred_[v];
+      }
+      return settled;
+    }
+
+  template<typename G, typename W>
+    inline auto
+    dijkstra_engine<G, W>::distance(vertex v) const -> distance_type
+    {
+      return std::size_t(v) < dist_.size() ? dist_[v] : infinite_distance<distance_type>();
+    }
+
+  template<typename G, typename W>
+    inline auto
+    dijkstra_engine<G, W>::predecessor(vertex v) const -> vertex
+    {
+      return std::size_t(v) < pred_.size() ? pred_[v] : vertex();
+    }
+
+  // Search g from s with Dijkstra's algorithm. See dijkstra_engine.
+  template<typename G, typename W = shortest_paths_impl::value_weight>
+    inline std::size_t
+    dijkstra_shortest_paths(const G& g, Vertex<G> s,
+                            Distance_type<G, W>* dist, Vertex<G>* pred,
+                            W w = W())
+    {
+      dijkstra_engine<G, W> sp(g, w);
+      return sp.search(s, dist, pred);
+    }
+
+
+  // Search g from s by delta-stepping with buckets of width delta, using the
+  // given number of threads. If threads is 0, the hardware concurrency is
+  // used. Returns the number of reached vertices.
+  template<typename G, typename W = shortest_paths_impl::value_weight>
+    std::size_t
+    delta_stepping_shortest_paths(const G& g, Vertex<G> s,
+                                  Distance_type<G, W>* dist, Vertex<G>* pred,
+                                  Distance_type<G, W> delta,
+                                  std::size_t threads = 0, W w = W())
+    {
+      using D = Distance_type<G, W>;
+      using V = Vertex<G>;
+      using namespace shortest_paths_impl;
+      using namespace neighbors_impl;
+      using parallel_impl::parallel_for;
+      assert(delta > D(0));
+
+      threads = parallel_impl::team_size(threads);
+      std::size_t n = vertex_bound(g);
+      parallel_for(threads, n, chunk, [&](std::size_t, std::size_t i, std::size_t j) {
+        std::fill(dist + i, dist + j, infinite_distance<D>());
+      });
+      dist[s] = D(0);
+
+      // The vertices of the current bucket are gathered into the frontier
+      // from the buckets of each thread. Vertices whose distance has fallen
+      // below the current bucket were relaxed in an earlier one.
+      std::vector<V> frontier(1, s);
+      std::vector<std::vector<std::vector<V>>> buckets(threads);
+      std::vector<std::size_t> next(threads);
+      std::vector<std::size_t> offset(threads);
+      std::atomic<std::size_t> cursor(0);
+      std::size_t current = 0;
+      parallel_impl::barrier sync(threads);
+
+      parallel_impl::run_team(threads, [&](std::size_t t) {
+        std::vector<std::vector<V>>& local = buckets[t];
+        while (true) {
+          std::size_t m = frontier.size();
+          D low = delta * D(current);
+          while (true) {
+            std::size_t i = cursor.fetch_add(chunk);
+            if (i >= m)
+              break;
+            std::size_t end = std::min(m, i + chunk);
+            for (; i < end; ++i) {
+              V u = frontier[i];
+              D du = load(dist + u);
+              if (du < low)
+                continue;
+              for (auto e : neighbor_edges(g, u)) {
+                V v = neighbor(g, e, u);
+                D d = du + w(g(e));
+                if (lower(dist + v, d)) {
+                  std::size_t b = std::size_t(d / delta);
+                  if (local.size() <= b)
+                    local.resize(b + 1);
+                  local[b].push_back(v);
+                }
+              }
+            }
+          }
+
+          std::size_t b = current;
+          while (b < local.size() && local[b].empty())
+            ++b;
+          next[t] = b < local.size() ? b : npos;
+          sync.wait();
+
+          // The first thread chooses the next bucket and places the parts
+          // of the frontier gathered by each thread.
+          if (t == 0) {
+            current = *std::min_element(next.begin(), next.end());
+            cursor = 0;
+            if (current != npos) {
+              std::size_t size = 0;
+              for (std::size_t x = 0; x < threads; ++x) {
+                offset[x] = size;
+                if (current < buckets[x].size())
+                  size += buckets[x][current].size();
+              }
+              frontier.resize(size);
+            }
+          }
+          sync.wait();
+          if (current == npos)
+            break;
+          if (current < local.size()) {
+            std::copy(local[current].begin(), local[current].end(),
+                      frontier.begin() + offset[t]);
+            local[current].clear();
+          }
+          sync.wait();
+        }
+      });
+
+      // Count the reached vertices, and find a nearer predecessor of each.
+      // The vertices without one are set aside.
+      std::vector<std::size_t> reached(threads, 0);
+      std::vector<std::vector<V>> level(threads);
+      parallel_for(threads, n, chunk, [&](std::size_t t, std::size_t i, std::size_t j) {
+        for (; i < j; ++i) {
+          if (pred)
+            pred[i] = V();
+          if (!(dist[i] < infinite_distance<D>()))
+            continue;
+          ++reached[t];
+          if (!pred)
+            continue;
+          V v = i;
+          if (v == s) {
+            pred[i] = s;
+            continue;
+          }
+          for (auto e : reverse_edges(g, v)) {
+            V u = reverse_neighbor(g, e, v);
+            if (dist[u] < dist[i] && dist[u] + w(g(e)) == dist[i]) {
+              pred[i] = u;
+              break;
+            }
+          }
+          if (!pred[i])
+            level[t].push_back(v);
+        }
+      });
+
+      // Each vertex set aside ends a path of edges of weight 0 from a
+      // vertex with a predecessor. Attach the vertices entered from such a
+      // vertex, then follow the edges of weight 0 forward from them.
+      if (pred) {
+        std::vector<V> queue;
+        for (std::vector<V>& part : level) {
+          for (V v : part) {
+            for (auto e : reverse_edges(g, v)) {
+              V u = reverse_neighbor(g, e, v);
+              if (pred[u] && dist[u] == dist[v] && w(g(e)) == D(0)) {
+                pred[v] = u;
+                queue.push_back(v);
+                break;
+              }
+            }
+          }
+        }
+        for (std::size_t k = 0; k < queue.size(); ++k) {
+          V u = queue[k];
+          for (auto e : neighbor_edges(g, u)) {
+            V v = neighbor(g, e, u);
+            if (!pred[v] && dist[v] == dist[u] && w(g(e)) == D(0)) {
+              pred[v] = u;
+              queue.push_back(v);
+            }
+          }
+        }
+      }
+
+      std::size_t count = 0;
+      for (std::size_t k : reached)
+        count += k;
+      return count;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,202 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/shortest_paths.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// An edge record whose weight is projected by a weight function.
+struct road
+{
+  road() : length(0) { }
+  road(int n) : length(n) { }
+
+  int length;
+  char name[8];
+};
+
+struct road_length
+{
+  int operator()(const road& r) const { return r.length; }
+};
+
+// Returns the distances from s computed by relaxing every edge until no
+// distance changes.
+template<typename G, typename W>
+  vector<Distance_type<G, W>>
+  relaxed_distances(const G& g, Vertex<G> s, W w)
+  {
+    using namespace neighbors_impl;
+    using D = Distance_type<G, W>;
+    vector<D> dist(vertex_bound(g), infinite_distance<D>());
+    dist[s] = D(0);
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (auto u : g.vertices()) {
+        if (dist[u] == infinite_distance<D>())
+          continue;
+        for (auto e : neighbor_edges(g, u)) {
+          Vertex<G> v = neighbor(g, e, u);
+          if (dist[u] + w(g(e)) < dist[v]) {
+            dist[v] = dist[u] + w(g(e));
+            changed = true;
+          }
+        }
+      }
+    }
+    return dist;
+  }
+
+// Check that every predecessor leads to its vertex along an edge on a
+// shortest path.
+template<typename G, typename W, typename D>
+  void
+  check_predecessors(const G& g, Vertex<G> s, W w,
+                     const vector<D>& dist, const vector<Vertex<G>>& pred)
+  {
+    using namespace neighbors_impl;
+    for (size_t v = 0; v < dist.size(); ++v) {
+      if (dist[v] == infinite_distance<D>()) {
+        assert(!pred[v]);
+      } else if (v == size_t(s)) {
+        assert(pred[v] == s);
+      } else {
+        Vertex<G> u = pred[v];
+        bool found = false;
+        for (auto e : neighbor_edges(g, u))
+          if (size_t(neighbor(g, e, u)) == v && dist[u] + w(g(e)) == dist[v])
+            found = true;
+        assert(found);
+      }
+    }
+  }
+
+template<typename G, typename W>
+  void
+  check_shortest_paths(const G& g, W w)
+  {
+    cout << "*** shortest paths (" << typestr<G>() << ") ***\n";
+    using D = Distance_type<G, W>;
+    vector<D> dist(vertex_bound(g));
+    vector<Vertex<G>> pred(vertex_bound(g));
+    dijkstra_engine<G, W> sp(g, w);
+    for (auto s : g.vertices()) {
+      if (size_t(s) % 37 != 0)
+        continue;
+      vector<D> expect = relaxed_distances(g, s, w);
+      size_t reached = 0;
+      for (D d : expect)
+        reached += d != infinite_distance<D>();
+
+      assert(sp.search(s, dist.data(), pred.data()) == reached);
+      assert(dist == expect);
+      check_predecessors(g, s, w, dist, pred);
+
+      for (size_t t : {1, 4}) {
+        for (D delta : {D(1), D(7), D(1000)}) {
+          assert(delta_stepping_shortest_paths(g, s, dist.data(), pred.data(),
+                                               delta, t, w) == reached);
+          assert(dist == expect);
+          check_predecessors(g, s, w, dist, pred);
+        }
+      }
+    }
+  }
+
+// Returns m random weighted edges over n vertices.
+template<typename R>
+  vector<tuple<size_t, size_t, int>>
+  random_edges(R& gen, size_t n, size_t m)
+  {
+    vector<tuple<size_t, size_t, int>> es;
+    for (size_t i = 0; i < m; ++i)
+      es.emplace_back(gen() % n, gen() % n, 1 + gen() % 50);
+    return es;
+  }
+
+int main()
+{
+  using namespace shortest_paths_impl;
+  minstd_rand gen;
+  size_t n = 400;
+  auto es = random_edges(gen, n, 1200);
+
+  check_shortest_paths(build_graph<directed_adjacency_list<char, double>>(n, es), value_weight());
+  check_shortest_paths(build_graph<undirected_adjacency_list<char, double>>(n, es), value_weight());
+  check_shortest_paths(build_graph<directed_adjacency_list<char, road>>(n, es), road_length());
+  check_shortest_paths(directed_adjacency_vector<char, int>(n, es), value_weight());
+  check_shortest_paths(undirected_adjacency_vector<char, road>(n, es), road_length());
+
+  // A search stops when its target is settled.
+  using G = directed_adjacency_list<char, double>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(Vertex<G>(0), Vertex<G>(1), 1.5);
+  g.add_edge(Vertex<G>(1), Vertex<G>(2), 1.0);
+  g.add_edge(Vertex<G>(0), Vertex<G>(2), 4.0);
+  g.add_edge(Vertex<G>(2), Vertex<G>(3), 0.5);
+  vector<double> dist(4);
+  vector<Vertex<G>> pred(4);
+  dijkstra_engine<G> sp(g);
+  assert(sp.search(Vertex<G>(0), dist.data(), pred.data(), Vertex<G>(1)) == 2);
+  assert(dist[1] == 1.5 && pred[1] == Vertex<G>(0));
+  assert(sp.search(Vertex<G>(0), dist.data(), nullptr) == 4);
+  assert(dist[2] == 2.5 && dist[3] == 3.0);
+
+  // The engine keeps the results of its last search. A vertex touched but
+  // not settled has an upper bound of its distance, and the vertices of an
+  // earlier search are reset.
+  assert(sp.search(Vertex<G>(0), Vertex<G>(1)) == 2);
+  assert(sp.distance(Vertex<G>(1)) == 1.5 && sp.predecessor(Vertex<G>(1)) == Vertex<G>(0));
+  assert(sp.distance(Vertex<G>(2)) == 4.0 && sp.predecessor(Vertex<G>(2)) == Vertex<G>(0));
+  assert(sp.distance(Vertex<G>(3)) == infinite_distance<double>());
+  assert(sp.search(Vertex<G>(2)) == 2);
+  assert(sp.distance(Vertex<G>(2)) == 0 && sp.predecessor(Vertex<G>(2)) == Vertex<G>(2));
+  assert(sp.distance(Vertex<G>(3)) == 0.5);
+  assert(sp.distance(Vertex<G>(1)) == infinite_distance<double>() && !sp.predecessor(Vertex<G>(1)));
+  assert(sp.distance(Vertex<G>(0)) == infinite_distance<double>() && !sp.predecessor(Vertex<G>(0)));
+  assert(sp.distance(Vertex<G>(9)) == infinite_distance<double>());
+
+  assert(dijkstra_shortest_paths(g, Vertex<G>(3), dist.data(), pred.data()) == 1);
+  assert(dist[0] == infinite_distance<double>() && !pred[0]);
+
+  // Removed vertices are not reached.
+  g.remove_vertex(Vertex<G>(1));
+  assert(delta_stepping_shortest_paths(g, Vertex<G>(0), dist.data(), pred.data(), 1.0) == 3);
+  assert(dist[1] == infinite_distance<double>() && dist[3] == 4.5);
+  assert(pred[3] == Vertex<G>(2) && pred[2] == Vertex<G>(0));
+
+  // Edges of weight 0 give predecessors at the same distance, without
+  // forming a cycle.
+  G z = build_n_graph<G>(5);
+  z.add_edge(Vertex<G>(0), Vertex<G>(1), 0.0);
+  z.add_edge(Vertex<G>(1), Vertex<G>(2), 3.0);
+  z.add_edge(Vertex<G>(2), Vertex<G>(3), 0.0);
+  z.add_edge(Vertex<G>(3), Vertex<G>(4), 0.0);
+  z.add_edge(Vertex<G>(4), Vertex<G>(3), 0.0);
+  dist.resize(5);
+  for (size_t t : {1, 4}) {
+    pred.assign(5, Vertex<G>(7));
+    assert(delta_stepping_shortest_paths(z, Vertex<G>(0), dist.data(), pred.data(), 1.0, t) == 5);
+    assert((dist == vector<double> {0, 0, 3, 3, 3}));
+    assert(pred[1] == Vertex<G>(0) && pred[2] == Vertex<G>(1));
+    assert(pred[3] == Vertex<G>(2) && pred[4] == Vertex<G>(3));
+    check_predecessors(z, Vertex<G>(0), value_weight(), dist, pred);
+  }
+}
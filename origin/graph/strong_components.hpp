@@ -0,0 +1,207 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_STRONG_COMPONENTS_HPP
+#define ORIGIN_GRAPH_STRONG_COMPONENTS_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                 [graph.strong_components]
+  //                   Strong Components and Topological Order
+  //
+  // These algorithms operate on directed graphs. None of them recurse: the
+  // depth-first search of Tarjan's algorithm keeps its path on an explicit
+  // stack, so that chains of any length can be searched. Each runs in time
+  // linear in the size of the graph, using O(V) memory beyond its output.
+  //
+  // The strong components are numbered in topological order: every edge
+  // joining two components leads from the lesser number to the greater.
+  // The condensation of a graph has a vertex for each component, labeled by
+  // the component's size, and an edge for each pair of components joined by
+  // edges, labeled by the number of such edges.
+
+  namespace strong_components_impl
+  {
+    constexpr std::size_t npos = -1;
+
+    // A frame of the depth-first search: a vertex, and the next of its out
+    // edges to search.
+    template<typename G>
+      struct search_frame
+      {
+        using iterator = decltype(std::declval<const G&>().out_edges(Vertex<G>()).begin());
+
+        Vertex<G> vertex;
+        iterator next;
+      };
+
+  } // namespace strong_components_impl
+
+
+  // Write the strong component number of every vertex handle less than the
+  // vertex bound of g to comp. Handles of removed vertices are numbered npos.
+  // Returns the number of components.
+  template<typename G>
+    std::size_t
+    strong_components(const G& g, std::size_t* comp)
+    {
+      static_assert(Directed_graph<G>(), "");
+      using namespace strong_components_impl;
+      using V = Vertex<G>;
+
+      std::size_t n = vertex_bound(g);
+      std::fill(comp, comp + n, npos);
+
+      // A vertex is on the component stack when it has been numbered in
+      // preorder, but has not been assigned to a component.
+      std::vector<std::size_t> index(n, npos);
+      std::vector<std::size_t> low(n);
+      std::vector<V> stack;
+      std::vector<search_frame<G>> path;
+      std::size_t count = 0;
+      std::size_t k = 0;
+
+      auto visit = [&](V v) {
+        index[v] = low[v] = count++;
+        stack.push_back(v);
+        path.push_back(search_frame<G>{v, g.out_edges(v).begin()});
+      };
+
+      for (V r : g.vertices()) {
+        if (index[r] != npos)
+          continue;
+        visit(r);
+        while (!path.empty()) {
+          V v = path.back().vertex;
+          if (path.back().next != g.out_edges(v).end()) {
+            V w = g.target(*path.back().next++);
+            if (index[w] == npos)
+              visit(w);
+            else if (comp[w] == npos)
+              low[v] = std::min(low[v], index[w]);
+            continue;
+          }
+
+          path.pop_back();
+          if (!path.empty()) {
+            V u = path.back().vertex;
+            low[u] = std::min(low[u], low[v]);
+          }
+          if (low[v] == index[v]) {
+            V w;
+            do {
+              w = stack.back();
+              stack.pop_back();
+              comp[w] = k;
+            } while (w != v);
+            ++k;
+          }
+        }
+      }
+
+      // Components are completed in reverse topological order.
+      for (V v : g.vertices())
+        comp[v] = k - 1 - comp[v];
+      return k;
+    }
+
+
+  // Write the vertices of g to order in topological order, so that every
+  // edge leads from an earlier vertex to a later one. Returns the number of
+  // vertices written, which is less than the order of g if, and only if, g
+  // has a cycle.
+  //
+  // The vertices are ordered by repeatedly removing vertices without in
+  // edges. The order array holds the queue of removed vertices.
+  template<typename G>
+    std::size_t
+    topological_sort(const G& g, Vertex<G>* order)
+    {
+      static_assert(Directed_graph<G>(), "");
+      std::vector<std::size_t> deg(vertex_bound(g));
+      std::size_t tail = 0;
+      for (auto v : g.vertices()) {
+        deg[v] = g.in_degree(v);
+        if (deg[v] == 0)
+          order[tail++] = v;
+      }
+      for (std::size_t head = 0; head < tail; ++head) {
+        Vertex<G> u = order[head];
+        for (auto e : g.out_edges(u)) {
+          Vertex<G> v = g.target(e);
+          if (--deg[v] == 0)
+            order[tail++] = v;
+        }
+      }
+      return tail;
+    }
+
+
+  // Returns the condensation of g, given the k strong components numbered
+  // in comp. The edges of the condensation are ordered by source component.
+  template<typename G>
+    directed_adjacency_vector<std::size_t, std::size_t>
+    condensation(const G& g, const std::size_t* comp, std::size_t k)
+    {
+      static_assert(Directed_graph<G>(), "");
+      using C = directed_adjacency_vector<std::size_t, std::size_t>;
+      using V = Vertex<G>;
+      using strong_components_impl::npos;
+
+      // Group the vertices by component.
+      std::vector<std::size_t> first(k + 1, 0);
+      for (V v : g.vertices())
+        ++first[comp[v] + 1];
+      for (std::size_t c = 0; c < k; ++c)
+        first[c + 1] += first[c];
+      std::vector<V> members(first[k]);
+      std::vector<std::size_t> fill(first.begin(), first.end() - 1);
+      for (V v : g.vertices())
+        members[fill[comp[v]]++] = v;
+
+      // Gather the edges leaving each component. The last component to
+      // reach each target, and the position of its edge, are recorded so
+      // that parallel edges are counted once.
+      std::vector<std::tuple<std::size_t, std::size_t, std::size_t>> es;
+      std::vector<std::size_t> seen(k, npos);
+      std::vector<std::size_t> pos(k);
+      for (std::size_t c = 0; c < k; ++c) {
+        for (std::size_t i = first[c]; i < first[c + 1]; ++i) {
+          for (auto e : g.out_edges(members[i])) {
+            std::size_t d = comp[g.target(e)];
+            if (d == c)
+              continue;
+            if (seen[d] != c) {
+              seen[d] = c;
+              pos[d] = es.size();
+              es.emplace_back(c, d, 0);
+            }
+            ++std::get<2>(es[pos[d]]);
+          }
+        }
+      }
+
+      C h(k, es);
+      for (std::size_t c = 0; c < k; ++c)
+        h(typename C::vertex(c)) = first[c + 1] - first[c];
+      return h;
+    }
+
+} // namespace origin
+
+#endif
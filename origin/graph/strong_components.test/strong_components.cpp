@@ -0,0 +1,184 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/strong_components.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+constexpr size_t npos = -1;
+
+// Returns the vertices reachable from s.
+template<typename G>
+  vector<bool>
+  reachable(const G& g, Vertex<G> s)
+  {
+    vector<bool> seen(vertex_bound(g), false);
+    vector<Vertex<G>> stack {s};
+    seen[s] = true;
+    while (!stack.empty()) {
+      Vertex<G> u = stack.back();
+      stack.pop_back();
+      for (auto e : g.out_edges(u)) {
+        Vertex<G> v = g.target(e);
+        if (!seen[v]) {
+          seen[v] = true;
+          stack.push_back(v);
+        }
+      }
+    }
+    return seen;
+  }
+
+// Check the strong components and the condensation of g. Two vertices are
+// in the same component when each is reachable from the other.
+template<typename G>
+  void
+  check_strong_components(const G& g)
+  {
+    cout << "*** strong components (" << typestr<G>() << ") ***\n";
+    vector<size_t> comp(vertex_bound(g));
+    size_t k = strong_components(g, comp.data());
+
+    vector<vector<bool>> reach(vertex_bound(g));
+    for (auto u : g.vertices())
+      reach[u] = reachable(g, u);
+    for (auto u : g.vertices()) {
+      assert(comp[u] < k);
+      for (auto v : g.vertices())
+        assert((comp[u] == comp[v]) == (reach[u][v] && reach[v][u]));
+    }
+
+    // Components are numbered in topological order.
+    size_t cross = 0;
+    set<pair<size_t, size_t>> joined;
+    for (auto e : g.edges()) {
+      size_t a = comp[g.source(e)];
+      size_t b = comp[g.target(e)];
+      assert(a <= b);
+      if (a != b) {
+        ++cross;
+        joined.emplace(a, b);
+      }
+    }
+
+    auto h = condensation(g, comp.data(), k);
+    assert(h.order() == k && h.size() == joined.size());
+    size_t members = 0;
+    for (auto c : h.vertices())
+      members += h(c);
+    assert(members == g.order());
+    size_t counted = 0;
+    for (auto e : h.edges()) {
+      assert(joined.count(make_pair(size_t(h.source(e)), size_t(h.target(e)))));
+      counted += h(e);
+    }
+    assert(counted == cross);
+
+    // The condensation is acyclic.
+    vector<Vertex<decltype(h)>> order(k);
+    assert(topological_sort(h, order.data()) == k);
+  }
+
+// Check that a topological order of g places the source of every edge
+// before its target, or that g has a cycle.
+template<typename G>
+  void
+  check_topological_sort(const G& g, bool acyclic)
+  {
+    cout << "*** topological sort (" << typestr<G>() << ") ***\n";
+    vector<Vertex<G>> order(g.order());
+    size_t n = topological_sort(g, order.data());
+    if (!acyclic) {
+      assert(n < g.order());
+      return;
+    }
+    assert(n == g.order());
+    vector<size_t> pos(vertex_bound(g), npos);
+    for (size_t i = 0; i < n; ++i)
+      pos[order[i]] = i;
+    for (auto e : g.edges())
+      assert(pos[g.source(e)] < pos[g.target(e)]);
+  }
+
+// Returns m random edges over n vertices. If acyclic, every edge leads to a
+// greater vertex.
+template<typename R>
+  vector<tuple<size_t, size_t>>
+  random_edges(R& gen, size_t n, size_t m, bool acyclic)
+  {
+    vector<tuple<size_t, size_t>> es;
+    while (es.size() < m) {
+      size_t u = gen() % n;
+      size_t v = gen() % n;
+      if (!acyclic)
+        es.emplace_back(u, v);
+      else if (u != v)
+        es.emplace_back(min(u, v), max(u, v));
+    }
+    return es;
+  }
+
+int main()
+{
+  using DV = directed_adjacency_vector<char>;
+  using D = directed_adjacency_list<char, int>;
+  minstd_rand gen;
+  for (size_t m : {100, 200, 400}) {
+    auto es = random_edges(gen, 150, m, false);
+    check_strong_components(DV(150, es));
+    check_strong_components(build_graph<D>(150, es));
+  }
+
+  auto dag = random_edges(gen, 150, 600, true);
+  check_topological_sort(DV(150, dag), true);
+  check_topological_sort(build_graph<D>(150, dag), true);
+  dag.emplace_back(149, 0);
+  check_topological_sort(DV(150, dag), false);
+
+  // A self loop is a cycle, but its vertex is a component of its own.
+  D g = build_n_graph<D>(3);
+  g.add_edge(Vertex<D>(0), Vertex<D>(1));
+  g.add_edge(Vertex<D>(1), Vertex<D>(1));
+  check_topological_sort(g, false);
+  check_strong_components(g);
+
+  // Removed vertices are numbered npos.
+  g.remove_vertex(Vertex<D>(1));
+  vector<size_t> comp(vertex_bound(g));
+  assert(strong_components(g, comp.data()) == 2);
+  assert(comp[1] == npos);
+
+  // Long chains are searched without recursion. The back edge joins the
+  // chain into a single component.
+  size_t n = 1000000;
+  vector<tuple<size_t, size_t>> chain;
+  for (size_t i = 0; i + 1 < n; ++i)
+    chain.emplace_back(i, i + 1);
+  DV c(n, chain);
+  vector<Vertex<DV>> order(n);
+  assert(topological_sort(c, order.data()) == n);
+  comp.resize(n);
+  assert(strong_components(c, comp.data()) == n);
+  assert(comp[0] == 0 && comp[n - 1] == n - 1);
+  c.add_edge(Vertex<DV>(n - 1), Vertex<DV>(0));
+  assert(strong_components(c, comp.data()) == 1);
+  assert(condensation(c, comp.data(), 1).size() == 0);
+}
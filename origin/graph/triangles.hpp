@@ -0,0 +1,234 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_TRIANGLES_HPP
+#define ORIGIN_GRAPH_TRIANGLES_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <vector>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/parallel.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                         [graph.triangles]
+  //                            Triangle Counting
+  //
+  // A triangle of an undirected graph is a set of three vertices that are
+  // pairwise adjacent. Parallel edges and loops do not form triangles: the
+  // count is that of the simple graph underlying g.
+  //
+  // The triangles are counted on an orientation of the graph. The vertices
+  // are ranked by degree, ties broken by handle, and each edge is directed
+  // from its endpoint of lower rank to that of higher rank. The oriented
+  // neighbors of every vertex are stored in a single array, sorted by
+  // handle, with parallel edges removed. Each triangle {u, v, w} with u < v
+  // < w in rank is then found exactly once, as the common oriented neighbor
+  // w of u and its oriented neighbor v, by merging their sorted lists. No
+  // vertex has more than O(sqrt(E)) oriented neighbors, so the count takes
+  // O(E^1.5) time, without the edge relation lookups of a double neighbor
+  // loop. The vertices are processed by a team of threads, which claim
+  // chunks of vertices from an atomic cursor.
+  //
+  // The local clustering coefficient of a vertex of degree d, counting
+  // distinct neighbors other than itself, with t triangles is 2t / (d(d-1)),
+  // or 0 if d < 2.
+
+  namespace triangles_impl
+  {
+    // The number of vertices claimed by a thread at a time.
+    constexpr std::size_t chunk = 64;
+
+    // Per-vertex counts in a caller's array are updated by several threads,
+    // through the atomic builtins.
+    inline void
+    add(std::size_t* p, std::size_t x) { __atomic_fetch_add(p, x, __ATOMIC_RELAXED); }
+
+    // The orientation of an undirected graph. The oriented neighbors of the
+    // vertex v are [first[v], first[v] + count[v]) of targets.
+    template<typename G>
+      struct orientation
+      {
+        orientation(const G& g, const std::vector<Vertex<G>>& vs, std::size_t threads);
+
+        const std::size_t* begin(std::size_t v) const { return targets.data() + first[v]; }
+        const std::size_t* end(std::size_t v) const   { return begin(v) + count[v]; }
+
+        std::vector<std::size_t> first;
+        std::vector<std::size_t> count;
+        std::vector<std::size_t> targets;
+      };
+
+    template<typename G>
+      orientation<G>::orientation(const G& g, const std::vector<Vertex<G>>& vs,
+                                  std::size_t threads)
+        : first(vertex_bound(g) + 1, 0), count(vertex_bound(g), 0)
+      {
+        using parallel_impl::parallel_for;
+        auto higher = [&g](Vertex<G> u, Vertex<G> w) {
+          std::size_t du = g.degree(u), dw = g.degree(w);
+          return du < dw || (du == dw && u < w);
+        };
+
+        // Bound the number of oriented neighbors of each vertex by the
+        // number of edges to higher ranked vertices.
+        parallel_for(threads, vs.size(), chunk, [&](std::size_t, std::size_t i, std::size_t j) {
+          for (; i < j; ++i) {
+            Vertex<G> u = vs[i];
+            std::size_t n = 0;
+            for (auto e : g.edges(u))
+              n += higher(u, opposite(g, e, u));
+            first[std::size_t(u) + 1] = n;
+          }
+        });
+        for (std::size_t v = 1; v < first.size(); ++v)
+          first[v] += first[v - 1];
+        targets.resize(first.back());
+
+        // Fill, sort, and deduplicate each list.
+        parallel_for(threads, vs.size(), chunk, [&](std::size_t, std::size_t i, std::size_t j) {
+          for (; i < j; ++i) {
+            Vertex<G> u = vs[i];
+            std::size_t* p = targets.data() + first[u];
+            std::size_t* q = p;
+            for (auto e : g.edges(u)) {
+              Vertex<G> w = opposite(g, e, u);
+              if (higher(u, w))
+                *q++ = w;
+            }
+            std::sort(p, q);
+            count[u] = std::unique(p, q) - p;
+          }
+        });
+      }
+
+    // Returns the number of common values of two sorted ranges.
+    inline std::size_t
+    count_common(const std::size_t* i, const std::size_t* m,
+                 const std::size_t* j, const std::size_t* n,
+                 std::size_t* tri)
+    {
+      std::size_t c = 0;
+      while (i != m && j != n) {
+        if (*i < *j) {
+          ++i;
+        } else if (*j < *i) {
+          ++j;
+        } else {
+          if (tri)
+            add(tri + *i, 1);
+          ++c;
+          ++i;
+          ++j;
+        }
+      }
+      return c;
+    }
+
+    // Count the triangles of the oriented graph o, adding the number of
+    // triangles containing each vertex to tri, if it is not null.
+    template<typename G>
+      std::size_t
+      count_oriented(const orientation<G>& o, const std::vector<Vertex<G>>& vs,
+                     std::size_t* tri, std::size_t threads)
+      {
+        std::vector<std::size_t> totals(threads, 0);
+        parallel_impl::parallel_for(threads, vs.size(), chunk,
+                                    [&](std::size_t t, std::size_t i, std::size_t j) {
+          for (; i < j; ++i) {
+            std::size_t u = vs[i];
+            std::size_t own = 0;
+            for (const std::size_t* p = o.begin(u); p != o.end(u); ++p) {
+              std::size_t w = *p;
+              std::size_t c = count_common(o.begin(u), o.end(u), o.begin(w), o.end(w), tri);
+              if (tri && c != 0)
+                add(tri + w, c);
+              own += c;
+            }
+            if (tri && own != 0)
+              add(tri + u, own);
+            totals[t] += own;
+          }
+        });
+        std::size_t n = 0;
+        for (std::size_t x : totals)
+          n += x;
+        return n;
+      }
+
+    template<typename G>
+      std::vector<Vertex<G>>
+      live_vertices(const G& g)
+      {
+        std::vector<Vertex<G>> vs;
+        for (Vertex<G> v : g.vertices())
+          vs.push_back(v);
+        return vs;
+      }
+
+  } // namespace triangles_impl
+
+
+  // Returns the number of triangles of g, using the given number of threads.
+  // If tri is not null, the number of triangles containing each vertex is
+  // written to tri, indexed by handle; the slots of removed vertices are
+  // set to 0. If threads is 0, the hardware concurrency is used.
+  template<typename G>
+    std::size_t
+    count_triangles(const G& g, std::size_t* tri = nullptr, std::size_t threads = 0)
+    {
+      static_assert(Undirected_graph<G>(), "");
+      using namespace triangles_impl;
+      threads = parallel_impl::team_size(threads);
+      if (tri)
+        std::fill(tri, tri + vertex_bound(g), 0);
+      std::vector<Vertex<G>> vs = live_vertices(g);
+      orientation<G> o(g, vs, threads);
+      return count_oriented(o, vs, tri, threads);
+    }
+
+  // Write the local clustering coefficient of every vertex of g to cc,
+  // indexed by handle, using the given number of threads. The slots of
+  // removed vertices are set to 0. Returns the average clustering
+  // coefficient of the vertices.
+  template<typename G>
+    double
+    clustering_coefficients(const G& g, double* cc, std::size_t threads = 0)
+    {
+      static_assert(Undirected_graph<G>(), "");
+      using namespace triangles_impl;
+      threads = parallel_impl::team_size(threads);
+      std::size_t n = vertex_bound(g);
+      std::vector<Vertex<G>> vs = live_vertices(g);
+      orientation<G> o(g, vs, threads);
+      std::vector<std::size_t> tri(n, 0);
+      count_oriented(o, vs, tri.data(), threads);
+
+      // Each distinct edge appears in the oriented list of one endpoint.
+      std::vector<std::size_t> degree(o.count);
+      for (Vertex<G> v : vs)
+        for (const std::size_t* p = o.begin(v); p != o.end(v); ++p)
+          ++degree[*p];
+
+      std::fill(cc, cc + n, 0.0);
+      double sum = 0;
+      for (Vertex<G> v : vs) {
+        double d = degree[v];
+        if (d >= 2)
+          cc[v] = 2 * tri[v] / (d * (d - 1));
+        sum += cc[v];
+      }
+      return vs.empty() ? 0.0 : sum / vs.size();
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,126 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/triangles.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the distinct neighbors of each vertex of g, other than itself.
+template<typename G>
+  vector<set<size_t>>
+  neighbor_sets(const G& g)
+  {
+    vector<set<size_t>> adj(g.vertex_bound());
+    for (auto v : g.vertices())
+      for (auto e : g.edges(v))
+        if (opposite(g, e, v) != v)
+          adj[v].insert(opposite(g, e, v));
+    return adj;
+  }
+
+// Check the triangle counts and clustering coefficients of g against the
+// pairs of neighbors of each vertex.
+template<typename G>
+  void
+  check_triangles(const G& g)
+  {
+    cout << "*** triangles (" << typestr<G>() << ") ***\n";
+    auto adj = neighbor_sets(g);
+    vector<size_t> expect(g.vertex_bound(), 0);
+    vector<double> cc(g.vertex_bound(), 0);
+    size_t total = 0;
+    double sum = 0;
+    for (auto v : g.vertices()) {
+      for (size_t a : adj[v])
+        for (size_t b : adj[v])
+          if (a < b && adj[a].count(b))
+            ++expect[v];
+      total += expect[v];
+      size_t d = adj[v].size();
+      if (d >= 2)
+        cc[v] = 2.0 * expect[v] / (d * (d - 1));
+      sum += cc[v];
+    }
+    assert(total % 3 == 0);
+
+    for (size_t threads : {1, 4}) {
+      vector<size_t> tri(g.vertex_bound(), 7);
+      assert(count_triangles(g, tri.data(), threads) == total / 3);
+      assert(tri == expect);
+      assert(count_triangles(g, nullptr, threads) == total / 3);
+
+      vector<double> c(g.vertex_bound(), -1);
+      double avg = clustering_coefficients(g, c.data(), threads);
+      for (size_t v = 0; v < c.size(); ++v)
+        assert(abs(c[v] - cc[v]) < 1e-12);
+      assert(abs(avg - sum / g.order()) < 1e-12);
+    }
+  }
+
+// Every triple of a clique is a triangle.
+void
+check_clique()
+{
+  cout << "*** clique triangles ***\n";
+  using G = undirected_adjacency_list<char, int>;
+  size_t n = 12;
+  G g = build_n_graph<G>(n);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = i + 1; j < n; ++j)
+      g.add_edge(Vertex<G>(i), Vertex<G>(j));
+  vector<size_t> tri(n);
+  assert(count_triangles(g, tri.data(), 2) == n * (n - 1) * (n - 2) / 6);
+  for (size_t t : tri)
+    assert(t == (n - 1) * (n - 2) / 2);
+  vector<double> cc(n);
+  assert(clustering_coefficients(g, cc.data()) == 1.0);
+
+  // Parallel edges and loops add nothing.
+  g.add_edge(Vertex<G>(0), Vertex<G>(1));
+  g.add_edge(Vertex<G>(2), Vertex<G>(2));
+  assert(count_triangles(g) == n * (n - 1) * (n - 2) / 6);
+
+  G empty;
+  assert(count_triangles(empty) == 0 && clustering_coefficients(empty, nullptr) == 0);
+}
+
+int main()
+{
+  check_clique();
+
+  using L = undirected_adjacency_list<char, int>;
+  check_triangles(build_random_graph<L>(100, 1500));
+
+  // Removed vertices, loops, and parallel edges.
+  L g = build_random_graph<L>(60, 600);
+  g.remove_vertex(Vertex<L>(3));
+  g.remove_vertex(Vertex<L>(40));
+  g.add_edge(Vertex<L>(5), Vertex<L>(5));
+  g.add_edge(Vertex<L>(5), Vertex<L>(6));
+  g.add_edge(Vertex<L>(5), Vertex<L>(6));
+  check_triangles(g);
+
+  minstd_rand gen;
+  vector<tuple<size_t, size_t>> es;
+  for (size_t i = 0; i < 3000; ++i)
+    es.emplace_back(gen() % 200, gen() % 200);
+  check_triangles(undirected_adjacency_vector<char>(200, es));
+}
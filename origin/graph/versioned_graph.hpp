@@ -0,0 +1,672 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_VERSIONED_GRAPH_HPP
+#define ORIGIN_GRAPH_VERSIONED_GRAPH_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include <origin/type/empty.hpp>
+#include <origin/sequence/range.hpp>
+
+#include <origin/graph/handle.hpp>
+#include <origin/graph/graph.hpp>
+#include <origin/graph/adjacency_list.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                         [graph.versioned]
+  //                             Versioned Graphs
+  //
+  // A versioned graph is an undirected graph that takes snapshots of itself.
+  // A snapshot is an immutable copy of the graph that shares its storage
+  // with the graph and with other snapshots, so that queries can read a
+  // consistent version of the graph while it is being updated.
+  //
+  // Vertex and edge records are stored in chunks of a fixed number of
+  // records, the chunks in pages, and the pages in a root, each of which is
+  // reference counted. The incidence list of each vertex is stored and
+  // counted separately. Taking a snapshot copies no storage. A change to the
+  // graph copies the chunk, page, root, and incidence list that it writes if
+  // they are shared with a snapshot, so the cost of a version is
+  // proportional to the number of chunks changed since the last snapshot,
+  // not to the size of the graph. Storage that no version refers to is
+  // freed when the last snapshot referring to it is destroyed.
+  //
+  // A single thread changes the graph and takes its snapshots. Snapshots may
+  // be read, copied, and destroyed by any number of threads, concurrently
+  // with changes to the graph. Handing a snapshot to another thread requires
+  // the usual synchronization, e.g., a mutex or a queue.
+  //
+  // As in an undirected adjacency list, a loop appears twice in the
+  // incidence list of its vertex, and the handles of removed vertices and
+  // edges are reused.
+
+  namespace versioned_graph_impl
+  {
+    // The number of records in a vertex chunk and an edge chunk. This is
+    // also the number of chunks in a page.
+    constexpr std::size_t vertex_chunk_size = 64;
+    constexpr std::size_t edge_chunk_size = 256;
+
+    // ---------------------------------------------------------------------- //
+    //                             Shared Storage
+
+    // A reference counted object that is shared between versions.
+    template<typename T>
+      struct shared_node
+      {
+        template<typename... Args>
+          explicit shared_node(Args&&... args)
+            : refs(1), value(std::forward<Args>(args)...)
+          { }
+
+        std::atomic<std::size_t> refs;
+        T value;
+      };
+
+    // A counted reference to a shared object. The object is not modified
+    // while there is more than one reference to it: mutate() first replaces
+    // it with a copy.
+    template<typename T>
+      class shared_ref
+      {
+        using node_type = shared_node<T>;
+      public:
+        shared_ref() : p_(nullptr) { }
+
+        template<typename... Args>
+          static shared_ref make(Args&&... args)
+          {
+            return shared_ref(new node_type(std::forward<Args>(args)...));
+          }
+
+        shared_ref(const shared_ref& x) : p_(x.p_) { acquire(); }
+        shared_ref(shared_ref&& x) : p_(x.p_) { x.p_ = nullptr; }
+
+        shared_ref& operator=(shared_ref x)
+        {
+          std::swap(p_, x.p_);
+          return *this;
+        }
+
+        ~shared_ref() { release(); }
+
+        explicit operator bool() const { return p_ != nullptr; }
+
+        const T& operator*() const  { return p_->value; }
+        const T* operator->() const { return &p_->value; }
+
+        // Returns true if this is the only reference to the object. The
+        // load synchronizes with the release of the other references, so
+        // their reads happen before any write through this one.
+        bool unique() const
+        {
+          return p_->refs.load(std::memory_order_acquire) == 1;
+        }
+
+        // Returns true if x refers to the same object.
+        bool shares(const shared_ref& x) const { return p_ == x.p_; }
+
+        // Returns the object for writing, copying it first if it is shared.
+        T& mutate()
+        {
+          assert(p_);
+          if (!unique())
+            *this = make(p_->value);
+          return p_->value;
+        }
+
+      private:
+        explicit shared_ref(node_type* p) : p_(p) { }
+
+        void acquire()
+        {
+          if (p_)
+            p_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release()
+        {
+          if (p_ && p_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete p_;
+        }
+
+        node_type* p_;
+      };
+
+
+    // A chunked array is a sequence of records of type R, stored in shared
+    // chunks of N records, N chunks to a page. Copying the array shares all
+    // of its storage. Records are only appended, never erased.
+    template<typename R, std::size_t N>
+      class chunked_array
+      {
+        using chunk = std::vector<R>;
+        using page = std::vector<shared_ref<chunk>>;
+        using root = std::vector<shared_ref<page>>;
+
+        static constexpr std::size_t page_size = N * N;
+      public:
+        chunked_array()
+          : root_(shared_ref<root>::make()), size_(0)
+        { }
+
+        std::size_t size() const   { return size_; }
+        std::size_t chunks() const { return (size_ + N - 1) / N; }
+
+        const R& operator[](std::size_t i) const
+        {
+          assert(i < size_);
+          return (*chunk_ref(i / N))[i % N];
+        }
+
+        // Returns record i for writing, copying the storage that holds it
+        // if it is shared.
+        R& mutate(std::size_t i)
+        {
+          assert(i < size_);
+          page& p = root_.mutate()[i / page_size].mutate();
+          return p[i / N % N].mutate()[i % N];
+        }
+
+        template<typename... Args>
+          void emplace_back(Args&&... args);
+
+        // Returns the number of chunks stored at the same position in this
+        // array and x that are shared by both.
+        std::size_t shared_chunks(const chunked_array& x) const;
+
+      private:
+        const shared_ref<chunk>& chunk_ref(std::size_t c) const
+        {
+          return (*(*root_)[c / N])[c % N];
+        }
+
+        shared_ref<root> root_;
+        std::size_t size_;
+      };
+
+    template<typename R, std::size_t N>
+      template<typename... Args>
+        void
+        chunked_array<R, N>::emplace_back(Args&&... args)
+        {
+          root& r = root_.mutate();
+          if (size_ % page_size == 0)
+            r.push_back(shared_ref<page>::make());
+          page& p = r.back().mutate();
+          if (size_ % N == 0) {
+            p.push_back(shared_ref<chunk>::make());
+            p.back().mutate().reserve(N);
+          }
+          p.back().mutate().emplace_back(std::forward<Args>(args)...);
+          ++size_;
+        }
+
+    template<typename R, std::size_t N>
+      std::size_t
+      chunked_array<R, N>::shared_chunks(const chunked_array& x) const
+      {
+        std::size_t n = 0;
+        std::size_t k = std::min(chunks(), x.chunks());
+        for (std::size_t c = 0; c < k; ++c)
+          n += chunk_ref(c).shares(x.chunk_ref(c));
+        return n;
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                                Records
+
+    // A vertex record holds the value of a vertex and its incidence list,
+    // which is null when it is empty. The records of removed vertices are
+    // not live.
+    template<typename V, typename L>
+      struct vertex_record
+      {
+        template<typename... Args>
+          explicit vertex_record(bool l, Args&&... args)
+            : value(std::forward<Args>(args)...), live(l)
+          { }
+
+        shared_ref<L> edges;
+        V value;
+        bool live;
+      };
+
+    // An edge record holds the endpoints and value of an edge.
+    template<typename E>
+      struct edge_record
+      {
+        template<typename... Args>
+          edge_record(std::size_t s, std::size_t t, bool l, Args&&... args)
+            : source(s), target(t), value(std::forward<Args>(args)...), live(l)
+          { }
+
+        std::size_t source;
+        std::size_t target;
+        E value;
+        bool live;
+      };
+
+
+    // The live iterator returns the handles of the live records of a chunked
+    // array, skipping those of removed vertices or edges.
+    template<typename A, typename H>
+      struct live_iterator
+      {
+        using handle_type = H;
+
+        live_iterator(const A* a, std::size_t i)
+          : array(a), index(i)
+        {
+          skip();
+        }
+
+        handle_type operator*() const { return H(index); }
+
+        live_iterator& operator++()
+        {
+          ++index;
+          skip();
+          return *this;
+        }
+
+        live_iterator operator++(int)
+        {
+          live_iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        void skip()
+        {
+          while (index < array->size() && !(*array)[index].live)
+            ++index;
+        }
+
+        const A* array;
+        std::size_t index;
+      };
+
+    template<typename A, typename H>
+      inline bool
+      operator==(const live_iterator<A, H>& a, const live_iterator<A, H>& b)
+      {
+        return a.index == b.index;
+      }
+
+    template<typename A, typename H>
+      inline bool
+      operator!=(const live_iterator<A, H>& a, const live_iterator<A, H>& b)
+      {
+        return a.index != b.index;
+      }
+
+  } // namespace versioned_graph_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                [graph.versioned.snapshot]
+  //                            Graph Snapshots
+  //
+  // A snapshot is an immutable version of a versioned undirected graph. It
+  // has the read interface of an undirected adjacency list. Incidence ranges
+  // refer to the storage of the snapshot, and are valid while it exists.
+  template<typename V = empty_t, typename E = empty_t>
+    class undirected_graph_snapshot
+    {
+    public:
+      using vertex = basic_vertex_handle<std::size_t>;
+      using edge = basic_edge_handle<std::size_t>;
+
+    protected:
+      using edge_list = std::vector<edge>;
+      using vertex_record = versioned_graph_impl::vertex_record<V, edge_list>;
+      using edge_record = versioned_graph_impl::edge_record<E>;
+      using vertex_array = versioned_graph_impl::
+        chunked_array<vertex_record, versioned_graph_impl::vertex_chunk_size>;
+      using edge_array = versioned_graph_impl::
+        chunked_array<edge_record, versioned_graph_impl::edge_chunk_size>;
+
+      using vertex_iter = versioned_graph_impl::live_iterator<vertex_array, vertex>;
+      using edge_iter = versioned_graph_impl::live_iterator<edge_array, edge>;
+
+    public:
+      using vertex_range = bounded_range<vertex_iter>;
+      using edge_range = bounded_range<edge_iter>;
+      using incidence_range = bounded_range<const edge*>;
+
+      undirected_graph_snapshot()
+        : order_(0), size_(0)
+      { }
+
+      // Observers
+      bool        null() const  { return order_ == 0; }
+      std::size_t order() const { return order_; }
+
+      bool        empty() const { return size_ == 0; }
+      std::size_t size() const  { return size_; }
+
+      // Handle bounds
+      std::size_t vertex_bound() const { return verts_.size(); }
+      std::size_t edge_bound() const   { return edges_.size(); }
+
+      // Vertex observers
+      std::size_t degree(vertex v) const
+      {
+        const vertex_record& r = verts_[v];
+        return r.edges ? r.edges->size() : 0;
+      }
+
+      // Edge observers
+      vertex source(edge e) const { return edges_[e].source; }
+      vertex target(edge e) const { return edges_[e].target; }
+
+      // Data access
+      const V& operator()(vertex v) const { return verts_[v].value; }
+      const E& operator()(edge e) const   { return edges_[e].value; }
+
+      // Relation
+      edge operator()(vertex u, vertex v) const;
+
+      // Iterators
+      vertex_range vertices() const
+      {
+        return {vertex_iter(&verts_, 0), vertex_iter(&verts_, verts_.size())};
+      }
+
+      edge_range edges() const
+      {
+        return {edge_iter(&edges_, 0), edge_iter(&edges_, edges_.size())};
+      }
+
+      incidence_range edges(vertex v) const
+      {
+        const vertex_record& r = verts_[v];
+        if (!r.edges)
+          return {nullptr, nullptr};
+        return {r.edges->data(), r.edges->data() + r.edges->size()};
+      }
+
+      // Sharing
+      // Returns the number of vertex or edge chunks that are shared by this
+      // version and x.
+      std::size_t shared_vertex_chunks(const undirected_graph_snapshot& x) const
+      {
+        return verts_.shared_chunks(x.verts_);
+      }
+
+      std::size_t shared_edge_chunks(const undirected_graph_snapshot& x) const
+      {
+        return edges_.shared_chunks(x.edges_);
+      }
+
+      // Returns true if the incidence list of v is shared by this version
+      // and x.
+      bool shares_edges(const undirected_graph_snapshot& x, vertex v) const
+      {
+        return verts_[v].edges.shares(x.verts_[v].edges);
+      }
+
+    protected:
+      vertex_array verts_;
+      edge_array edges_;
+      std::size_t order_;
+      std::size_t size_;
+    };
+
+  // Returns the first edge incident to u whose opposite endpoint is v, or an
+  // invalid handle if there is no such edge.
+  template<typename V, typename E>
+    auto
+    undirected_graph_snapshot<V, E>::operator()(vertex u, vertex v) const -> edge
+    {
+      for (edge e : edges(u))
+        if (opposite(*this, e, u) == v)
+          return e;
+      return edge();
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                         [graph.versioned]
+  //                        Versioned Undirected Graph
+  //
+  // A versioned undirected graph is the current version of the graph, and
+  // the only one that can be changed. Every change, including non-const
+  // access to a vertex or edge value, copies the storage that it writes if
+  // that storage is shared with a snapshot.
+  template<typename V = empty_t, typename E = empty_t>
+    class versioned_undirected_graph : public undirected_graph_snapshot<V, E>
+    {
+      using base_type = undirected_graph_snapshot<V, E>;
+      using typename base_type::edge_list;
+      using typename base_type::vertex_record;
+      using typename base_type::edge_record;
+    public:
+      using snapshot_type = base_type;
+
+      using typename base_type::vertex;
+      using typename base_type::edge;
+
+      versioned_undirected_graph() = default;
+
+      // Copy the graph g, keeping its handles and the order of its incidence
+      // lists. The slots of removed vertices and edges hold default values.
+      template<typename T>
+        explicit versioned_undirected_graph(const undirected_adjacency_list<V, E, T>& g);
+
+      // Versions
+      // Returns a snapshot of the current version of the graph. This takes
+      // constant time.
+      snapshot_type snapshot() const { return *this; }
+
+      // Data access
+      V& operator()(vertex v) { return this->verts_.mutate(v).value; }
+      E& operator()(edge e)   { return this->edges_.mutate(e).value; }
+
+      using base_type::operator();
+
+      // Vertex set
+      vertex add_vertex()             { return emplace_vertex(); }
+      vertex add_vertex(V&& x)        { return emplace_vertex(std::move(x)); }
+      vertex add_vertex(const V& x)   { return emplace_vertex(x); }
+
+      template<typename... Args>
+        vertex emplace_vertex(Args&&... args);
+
+      void remove_vertex(vertex v);
+
+      // Edge set
+      edge add_edge(vertex u, vertex v)             { return emplace_edge(u, v); }
+      edge add_edge(vertex u, vertex v, E&& x)      { return emplace_edge(u, v, std::move(x)); }
+      edge add_edge(vertex u, vertex v, const E& x) { return emplace_edge(u, v, x); }
+
+      template<typename... Args>
+        edge emplace_edge(vertex u, vertex v, Args&&... args);
+
+      void remove_edge(edge e);
+      void remove_edge(vertex u, vertex v);
+      void remove_edges(vertex v);
+
+    private:
+      void link_edge(vertex v, edge e);
+      void unlink_edge(vertex v, edge e);
+
+      // Removed handles, reused from the back.
+      std::vector<std::size_t> free_verts_;
+      std::vector<std::size_t> free_edges_;
+    };
+
+  template<typename V, typename E>
+    template<typename T>
+      versioned_undirected_graph<V, E>::versioned_undirected_graph(
+        const undirected_adjacency_list<V, E, T>& g)
+      {
+        using G = undirected_adjacency_list<V, E, T>;
+        std::vector<bool> live(g.vertex_bound(), false);
+        for (auto v : g.vertices())
+          live[v] = true;
+        for (std::size_t i = 0; i < live.size(); ++i) {
+          if (!live[i]) {
+            this->verts_.emplace_back(false);
+            continue;
+          }
+          Vertex<G> v(i);
+          this->verts_.emplace_back(true, g(v));
+          if (g.degree(v) != 0) {
+            edge_list l;
+            l.reserve(g.degree(v));
+            for (auto e : g.edges(v))
+              l.push_back(edge(std::size_t(e)));
+            this->verts_.mutate(i).edges =
+              versioned_graph_impl::shared_ref<edge_list>::make(std::move(l));
+          }
+        }
+        for (std::size_t i = live.size(); i-- != 0; )
+          if (!live[i])
+            free_verts_.push_back(i);
+
+        live.assign(g.edge_bound(), false);
+        for (auto e : g.edges())
+          live[e] = true;
+        for (std::size_t i = 0; i < live.size(); ++i) {
+          Edge<G> e(i);
+          if (live[i])
+            this->edges_.emplace_back(g.source(e), g.target(e), true, g(e));
+          else
+            this->edges_.emplace_back(0, 0, false);
+        }
+        for (std::size_t i = live.size(); i-- != 0; )
+          if (!live[i])
+            free_edges_.push_back(i);
+
+        this->order_ = g.order();
+        this->size_ = g.size();
+      }
+
+  template<typename V, typename E>
+    template<typename... Args>
+      auto
+      versioned_undirected_graph<V, E>::emplace_vertex(Args&&... args) -> vertex
+      {
+        std::size_t n;
+        if (free_verts_.empty()) {
+          n = this->verts_.size();
+          this->verts_.emplace_back(true, std::forward<Args>(args)...);
+        } else {
+          n = free_verts_.back();
+          free_verts_.pop_back();
+          this->verts_.mutate(n) = vertex_record(true, std::forward<Args>(args)...);
+        }
+        ++this->order_;
+        return n;
+      }
+
+  template<typename V, typename E>
+    void
+    versioned_undirected_graph<V, E>::remove_vertex(vertex v)
+    {
+      assert(this->verts_[v].live);
+      remove_edges(v);
+      this->verts_.mutate(v).live = false;
+      free_verts_.push_back(v);
+      --this->order_;
+    }
+
+  template<typename V, typename E>
+    template<typename... Args>
+      auto
+      versioned_undirected_graph<V, E>::emplace_edge(vertex u, vertex v, Args&&... args)
+        -> edge
+      {
+        assert(this->verts_[u].live && this->verts_[v].live);
+        std::size_t n;
+        if (free_edges_.empty()) {
+          n = this->edges_.size();
+          this->edges_.emplace_back(u, v, true, std::forward<Args>(args)...);
+        } else {
+          n = free_edges_.back();
+          free_edges_.pop_back();
+          this->edges_.mutate(n) = edge_record(u, v, true, std::forward<Args>(args)...);
+        }
+        link_edge(u, n);
+        link_edge(v, n);
+        ++this->size_;
+        return n;
+      }
+
+  template<typename V, typename E>
+    void
+    versioned_undirected_graph<V, E>::remove_edge(edge e)
+    {
+      assert(this->edges_[e].live);
+      vertex u = this->source(e);
+      vertex v = this->target(e);
+      unlink_edge(u, e);
+      if (u != v)
+        unlink_edge(v, e);
+      this->edges_.mutate(e).live = false;
+      free_edges_.push_back(e);
+      --this->size_;
+    }
+
+  // Remove the first edge connecting u and v, if any.
+  template<typename V, typename E>
+    void
+    versioned_undirected_graph<V, E>::remove_edge(vertex u, vertex v)
+    {
+      edge e = (*this)(u, v);
+      if (e)
+        remove_edge(e);
+    }
+
+  template<typename V, typename E>
+    void
+    versioned_undirected_graph<V, E>::remove_edges(vertex v)
+    {
+      if (!this->verts_[v].edges)
+        return;
+      edge_list l = *this->verts_[v].edges;
+      for (edge e : l)
+        if (this->edges_[e].live)
+          remove_edge(e);
+    }
+
+  template<typename V, typename E>
+    void
+    versioned_undirected_graph<V, E>::link_edge(vertex v, edge e)
+    {
+      vertex_record& r = this->verts_.mutate(v);
+      if (!r.edges)
+        r.edges = versioned_graph_impl::shared_ref<edge_list>::make();
+      r.edges.mutate().push_back(e);
+    }
+
+  // Erase every occurrence of e from the incidence list of v.
+  template<typename V, typename E>
+    void
+    versioned_undirected_graph<V, E>::unlink_edge(vertex v, edge e)
+    {
+      vertex_record& r = this->verts_.mutate(v);
+      edge_list& l = r.edges.mutate();
+      l.erase(std::remove(l.begin(), l.end(), e), l.end());
+      if (l.empty())
+        r.edges = versioned_graph_impl::shared_ref<edge_list>();
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,315 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/breadth_first.hpp>
+#include <origin/graph/versioned_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// An edge value that counts its instances, to check that the storage of
+// old versions is freed.
+struct counted
+{
+  counted(int x = 0) : value(x) { ++count; }
+  counted(const counted& x) : value(x.value) { ++count; }
+  ~counted() { --count; }
+
+  counted& operator=(const counted&) = default;
+
+  int value;
+
+  static atomic<int> count;
+};
+
+atomic<int> counted::count(0);
+
+using version_edges = vector<tuple<size_t, size_t, size_t, int>>;
+using version_vertices = vector<tuple<size_t, int, vector<size_t>>>;
+
+// Returns the edges of g and their values.
+template<typename G>
+  version_edges
+  edge_set(const G& g)
+  {
+    version_edges es;
+    for (auto e : g.edges())
+      es.emplace_back(e, g.source(e), g.target(e), g(e));
+    return es;
+  }
+
+// Returns the vertices of g, their values, and their incidence lists.
+template<typename G>
+  version_vertices
+  vertex_set(const G& g)
+  {
+    version_vertices vs;
+    for (auto v : g.vertices()) {
+      vector<size_t> l;
+      for (auto e : g.edges(v))
+        l.push_back(e);
+      vs.emplace_back(v, g(v), l);
+    }
+    return vs;
+  }
+
+// Check that the incidence lists of g agree with its edges.
+template<typename G>
+  void
+  check_structure(const G& g)
+  {
+    size_t order = 0, entries = 0;
+    for (auto v : g.vertices()) {
+      ++order;
+      size_t d = 0;
+      for (auto e : g.edges(v)) {
+        assert(g.source(e) == v || g.target(e) == v);
+        ++d;
+      }
+      assert(d == g.degree(v));
+      entries += d;
+    }
+    size_t size = 0;
+    for (auto e : g.edges()) {
+      ++size;
+      assert(g(g.source(e), g.target(e)));
+    }
+    assert(order == g.order() && size == g.size() && entries == 2 * size);
+  }
+
+// Apply random changes to a graph, and check that every snapshot keeps the
+// version of the graph it was taken from.
+void
+check_snapshots()
+{
+  cout << "*** snapshots ***\n";
+  using G = versioned_undirected_graph<int, int>;
+  using V = Vertex<G>;
+  minstd_rand gen;
+  G g = build_n_graph<G>(200);
+  vector<G::snapshot_type> snaps;
+  vector<pair<version_vertices, version_edges>> expect;
+  for (size_t i = 0; i < 5000; ++i) {
+    vector<V> vs;
+    for (auto v : g.vertices())
+      vs.push_back(v);
+    V u = vs[gen() % vs.size()], v = vs[gen() % vs.size()];
+    switch (gen() % 8) {
+    case 0:
+      if (size_t(u) != 0)
+        g.remove_vertex(u);
+      break;
+    case 1:
+      g.add_vertex(int(i));
+      break;
+    case 2:
+      g.remove_edge(u, v);
+      break;
+    case 3:
+      if (!g.empty())
+        g.remove_edge(*g.edges().begin());
+      break;
+    case 4:
+      g(u) = int(i);
+      break;
+    case 5:
+      if (!g.empty())
+        g(*g.edges().begin()) = int(i);
+      break;
+    default:
+      g.add_edge(u, v, int(i));
+      break;
+    }
+    if (i % 100 == 0) {
+      snaps.push_back(g.snapshot());
+      expect.emplace_back(vertex_set(g), edge_set(g));
+    }
+  }
+  check_structure(g);
+  for (size_t i = 0; i < snaps.size(); ++i) {
+    check_structure(snaps[i]);
+    assert(vertex_set(snaps[i]) == expect[i].first);
+    assert(edge_set(snaps[i]) == expect[i].second);
+  }
+}
+
+// A change copies only the chunks and incidence lists that it writes.
+void
+check_sharing()
+{
+  cout << "*** snapshot sharing ***\n";
+  using G = versioned_undirected_graph<char, int>;
+  using V = Vertex<G>;
+  size_t n = 1000, m = 3000;
+  minstd_rand gen;
+  G g = build_n_graph<G>(n);
+  for (size_t i = 0; i < m; ++i)
+    g.add_edge(V(gen() % n), V(gen() % n), i);
+  size_t vc = (n + 63) / 64, ec = (m + 255) / 256;
+
+  auto s = g.snapshot();
+  assert(g.shared_vertex_chunks(s) == vc && g.shared_edge_chunks(s) == ec);
+
+  g(V(5)) = 'z';
+  assert(g.shared_vertex_chunks(s) == vc - 1 && g.shared_edge_chunks(s) == ec);
+  assert(s(V(5)) == 'a' + 5 && g.shares_edges(s, V(5)));
+
+  size_t d = s.degree(V(0));
+  g.add_edge(V(0), V(999), -1);
+  assert(g.shared_vertex_chunks(s) == vc - 2 && g.shared_edge_chunks(s) == ec - 1);
+  assert(!g.shares_edges(s, V(0)) && !g.shares_edges(s, V(999)));
+  assert(g.shares_edges(s, V(1)));
+  assert(s.degree(V(0)) == d && g.degree(V(0)) == d + 1);
+  assert(s.size() == m && g.size() == m + 1);
+
+  // A second snapshot shares the unchanged storage of both.
+  auto t = g.snapshot();
+  assert(t.shared_vertex_chunks(g) == vc && t.shared_vertex_chunks(s) == vc - 2);
+}
+
+// The storage of old versions is freed with their last snapshot.
+void
+check_reclaim()
+{
+  cout << "*** snapshot reclamation ***\n";
+  using G = versioned_undirected_graph<char, counted>;
+  using V = Vertex<G>;
+  {
+    G g = build_n_graph<G>(10);
+    for (int i = 0; i < 1000; ++i)
+      g.add_edge(V(i % 10), V(i % 7), i);
+    assert(counted::count == 1000);
+
+    vector<G::snapshot_type> snaps;
+    for (int i = 0; i < 10; ++i) {
+      snaps.push_back(g.snapshot());
+      g(Edge<G>(i)) = counted(-i);
+      g.remove_edge(Edge<G>(500 + i));
+    }
+    assert(counted::count == 1000 + 10 * 256 + 10 * 256);
+
+    // Dropping the oldest snapshots frees nothing that a later one shares.
+    snaps.erase(snaps.begin(), snaps.begin() + 9);
+    assert(counted::count == 1000 + 256 + 256);
+    for (int i = 0; i < 10; ++i)
+      assert(snaps[0](Edge<G>(i)).value == (i < 9 ? -i : i));
+    snaps.clear();
+    assert(counted::count == 1000);
+    assert(g.size() == 990 && g.edge_bound() == 1000);
+  }
+  assert(counted::count == 0);
+}
+
+// A versioned graph copies an undirected adjacency list, and snapshots can
+// be searched like it.
+void
+check_adjacency_list()
+{
+  cout << "*** versioned adjacency list ***\n";
+  using H = undirected_adjacency_list<char, int>;
+  using G = versioned_undirected_graph<char, int>;
+  H h = build_n_graph<H>(8);
+  int x = 0;
+  for (int i = 0; i < 8; ++i)
+    for (int j = i; j < 8; j += 3)
+      h.add_edge(Vertex<H>(i), Vertex<H>(j), x++);
+  h.remove_vertex(Vertex<H>(3));
+  h.remove_edge(h(Vertex<H>(1), Vertex<H>(4)));
+
+  G g(h);
+  assert(g.order() == h.order() && g.size() == h.size());
+  assert(g.vertex_bound() == h.vertex_bound() && g.edge_bound() == h.edge_bound());
+  assert(vertex_set(g) == vertex_set(h) && edge_set(g) == edge_set(h));
+  check_structure(g);
+
+  auto s = g.snapshot();
+  vector<size_t> d1(8), d2(8);
+  vector<Vertex<G>> p1(8);
+  vector<Vertex<H>> p2(8);
+  assert(breadth_first_search(s, Vertex<G>(0), d1.data(), p1.data(), 1) ==
+         breadth_first_search(h, Vertex<H>(0), d2.data(), p2.data(), 1));
+  for (auto v : h.vertices())
+    assert(d1[v] == d2[v]);
+
+  // Removed handles are reused.
+  assert(g.add_vertex('x') == Vertex<G>(3));
+  assert(g.order() == 8 && s.order() == 7);
+  check_structure(g);
+}
+
+// Readers check snapshots published by a writer while it changes the graph.
+void
+check_concurrent()
+{
+  cout << "*** concurrent snapshots ***\n";
+  using G = versioned_undirected_graph<int, int>;
+  using V = Vertex<G>;
+  size_t n = 300;
+  G g = build_n_graph<G>(n);
+  mutex m;
+  G::snapshot_type latest = g.snapshot();
+  atomic<bool> done(false);
+
+  auto read = [&]() {
+    int last = 0;
+    size_t reads = 0;
+    while (!done || reads == 0) {
+      G::snapshot_type s;
+      {
+        lock_guard<mutex> lock(m);
+        s = latest;
+      }
+      check_structure(s);
+      assert(s(V(0)) >= last);
+      last = s(V(0));
+      ++reads;
+    }
+  };
+  vector<thread> readers;
+  for (int i = 0; i < 3; ++i)
+    readers.emplace_back(read);
+
+  minstd_rand gen;
+  for (int i = 1; i <= 4000; ++i) {
+    V u(1 + gen() % (n - 1)), v(1 + gen() % (n - 1));
+    if (gen() % 3 == 0)
+      g.remove_edge(u, v);
+    else
+      g.add_edge(u, v, i);
+    if (i % 20 == 0) {
+      g(V(0)) = i;
+      auto s = g.snapshot();
+      lock_guard<mutex> lock(m);
+      latest = s;
+    }
+  }
+  done = true;
+  for (auto& t : readers)
+    t.join();
+  check_structure(g);
+}
+
+int main()
+{
+  check_snapshots();
+  check_sharing();
+  check_reclaim();
+  check_adjacency_list();
+  check_concurrent();
+}